@@ -1134,6 +1134,9 @@ class CompositorPerformanceButtonsPanel:
         row = col.row()
         row.prop(rd, "compositor_device", text="Device", expand=True)
         col.prop(rd, "compositor_precision", text="Precision")
+        sub = col.column()
+        sub.active = rd.compositor_device == 'CPU'
+        sub.prop(rd, "compositor_storage", text="Storage")
 
 
 class RENDER_PT_eevee_performance_compositor(RenderButtonsPanel, CompositorPerformanceButtonsPanel, Panel):
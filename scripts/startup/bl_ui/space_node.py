@@ -852,6 +852,9 @@ class NODE_PT_quality(bpy.types.Panel):
         col = layout.column()
         col.prop(rd, "compositor_device", text="Device")
         col.prop(rd, "compositor_precision", text="Precision")
+        sub = col.column()
+        sub.active = rd.compositor_device == 'CPU'
+        sub.prop(rd, "compositor_storage", text="Storage")
 
         col = layout.column()
         col.prop(tree, "use_viewer_border")
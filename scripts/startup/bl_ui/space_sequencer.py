@@ -2402,6 +2402,9 @@ class SEQUENCER_PT_cache_settings(SequencerButtonsPanel, Panel):
         col.prop(ed, "use_cache_composite", text="Composite")
         col.prop(ed, "use_cache_final", text="Final")
 
+        col = layout.column()
+        col.prop(ed, "use_cache_compression", text="Compress")
+
 
 class SEQUENCER_PT_cache_view_settings(SequencerButtonsPanel, Panel):
     bl_label = "Display"
@@ -2597,6 +2600,9 @@ class SEQUENCER_PT_view(SequencerButtonsPanel_Output, Panel):
         col = layout.column()
         if ed:
             col.prop(ed, "use_prefetch")
+            sub = col.column()
+            sub.active = ed.use_prefetch
+            sub.prop(ed, "prefetch_threads", text="Threads")
 
         col.prop(st, "display_channel", text="Channel")
 
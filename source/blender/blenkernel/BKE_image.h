@@ -322,6 +322,17 @@ bool BKE_image_is_stereo(const struct Image *ima);
 RenderResult *BKE_image_acquire_renderresult(Scene *scene, Image *ima);
 void BKE_image_release_renderresult(Scene *scene, Image *ima, RenderResult *render_result);
 
+/**
+ * Passes of multi-layer images are read from the file when they are first used. Read all of
+ * them, for code which accesses the passes of the render result directly.
+ */
+void BKE_image_multilayer_ensure_passes_loaded(Image *ima);
+/**
+ * Same as #BKE_image_multilayer_ensure_passes_loaded, but only reads the given pass of the render
+ * result of the image. Returns false when its pixels are not available.
+ */
+bool BKE_image_multilayer_ensure_pass_loaded(Image *ima, RenderPass *rpass);
+
 /**
  * For multi-layer images as well as for single-layer.
  */
@@ -86,6 +86,12 @@ void BKE_mesh_free_data_for_undo(Mesh *mesh);
  */
 void BKE_mesh_clear_geometry(Mesh *mesh);
 
+/**
+ * Same as #BKE_mesh_clear_geometry, but keeps the caches that only depend on the topology. The
+ * caller is responsible for restoring the same topology afterwards.
+ */
+void BKE_mesh_clear_geometry_keep_topology_caches(Mesh *mesh);
+
 /**
  * Same as #BKE_mesh_clear_geometry, but also clears attribute meta-data like active attribute
  * names and vertex group names. Used when the geometry is *entirely* replaced.
@@ -43,6 +43,13 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh);
  */
 void BKE_mesh_runtime_clear_cache(Mesh *mesh);
 
+/**
+ * Same as #BKE_mesh_runtime_clear_cache, but keeps the caches that only depend on the topology
+ * (edge vertices, face offsets, corner vertices and corner edges), like the vertex to face maps
+ * and the loose element caches. Only valid when the topology is restored unchanged afterwards.
+ */
+void BKE_mesh_runtime_clear_cache_keep_topology(Mesh *mesh);
+
 namespace blender::bke {
 
 void mesh_get_mapped_verts_coords(Mesh *mesh_eval, MutableSpan<float3> r_cos);
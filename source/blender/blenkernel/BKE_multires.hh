@@ -115,6 +115,18 @@ int multires_mdisp_corners(const MDisps *s);
  */
 void multires_topology_changed(Mesh *mesh);
 
+/**
+ * Displacement grids which are not displaced from the limit surface are stored sparsely, without
+ * data. Allocate them with zero displacement, for code which expects every grid to have data.
+ */
+void multires_ensure_dense_grids(Mesh *mesh);
+
+/**
+ * Number of elements of a displacement grid at the given level, also for grids which are stored
+ * sparsely and only know their level.
+ */
+int multires_grid_tot_for_level(int level);
+
 /**
  * Makes sure data from an external file is fully read.
  *
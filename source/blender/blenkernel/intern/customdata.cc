@@ -689,6 +689,9 @@ static bool layerRead_mdisps(CDataFile *cdf, void *data, const int count)
   MDisps *d = static_cast<MDisps *>(data);
 
   for (int i = 0; i < count; i++) {
+    if (d[i].totdisp == 0) {
+      continue;
+    }
     if (!d[i].disps) {
       d[i].disps = (float(*)[3])MEM_calloc_arrayN(d[i].totdisp, sizeof(float[3]), "mdisps read");
     }
@@ -3855,6 +3855,27 @@ RenderResult *BKE_image_acquire_renderresult(Scene *scene, Image *ima)
   return rr;
 }
 
+void BKE_image_multilayer_ensure_passes_loaded(Image *ima)
+{
+  BLI_mutex_lock(static_cast<ThreadMutex *>(ima->runtime.cache_mutex));
+  if (ima->rr) {
+    RE_render_result_ensure_passes_loaded(ima->rr);
+  }
+  BLI_mutex_unlock(static_cast<ThreadMutex *>(ima->runtime.cache_mutex));
+}
+
+bool BKE_image_multilayer_ensure_pass_loaded(Image *ima, RenderPass *rpass)
+{
+  BLI_mutex_lock(static_cast<ThreadMutex *>(ima->runtime.cache_mutex));
+  bool is_loaded = false;
+  if (ima->rr) {
+    RE_pass_ensure_loaded(ima->rr, rpass);
+    is_loaded = rpass->ibuf && rpass->ibuf->float_buffer.data;
+  }
+  BLI_mutex_unlock(static_cast<ThreadMutex *>(ima->runtime.cache_mutex));
+  return is_loaded;
+}
+
 void BKE_image_release_renderresult(Scene *scene, Image *ima, RenderResult *render_result)
 {
   if (render_result) {
@@ -3973,7 +3994,10 @@ static void image_create_multilayer(Image *ima, ImBuf *ibuf, int framenr)
     ima->rr = RE_MultilayerConvert(ibuf->userdata, colorspace, predivide, ibuf->x, ibuf->y);
   }
 
-  IMB_exr_close(ibuf->userdata);
+  /* The render result keeps the handle to read passes from when they are first used. */
+  if (ima->rr == nullptr || ima->rr->exrhandle != ibuf->userdata) {
+    IMB_exr_close(ibuf->userdata);
+  }
 
   ibuf->userdata = nullptr;
   if (ima->rr != nullptr) {
@@ -4066,6 +4090,9 @@ static ImBuf *image_load_sequence_multilayer(Image *ima, ImageUser *iuser, int e
   }
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
+    if (rpass) {
+      RE_pass_ensure_loaded(ima->rr, rpass);
+    }
 
     if (rpass && rpass->ibuf) {
       ibuf = rpass->ibuf;
@@ -4195,7 +4222,9 @@ static ImBuf *load_image_single(Image *ima,
 {
   char filepath[FILE_MAX];
   ImBuf *ibuf = nullptr;
-  int flag = IB_rect | IB_multilayer | IB_metadata | imbuf_alpha_flags_for_image(ima);
+  /* Passes of multi-layer files are only read when used, see #RE_pass_ensure_loaded. */
+  int flag = IB_rect | IB_multilayer | IB_multilayer_lazy | IB_metadata |
+             imbuf_alpha_flags_for_image(ima);
 
   *r_cache_ibuf = true;
   const int tile_number = image_get_tile_number_from_iuser(ima, iuser);
@@ -4367,6 +4396,9 @@ static ImBuf *image_get_ibuf_multilayer(Image *ima, ImageUser *iuser)
   }
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
+    if (rpass) {
+      RE_pass_ensure_loaded(ima->rr, rpass);
+    }
 
     if (rpass && rpass->ibuf) {
       ibuf = rpass->ibuf;
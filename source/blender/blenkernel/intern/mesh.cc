@@ -552,6 +552,12 @@ void BKE_mesh_clear_geometry(Mesh *mesh)
   mesh_clear_geometry(*mesh);
 }
 
+void BKE_mesh_clear_geometry_keep_topology_caches(Mesh *mesh)
+{
+  BKE_mesh_runtime_clear_cache_keep_topology(mesh);
+  mesh_clear_geometry(*mesh);
+}
+
 void BKE_mesh_clear_geometry_and_metadata(Mesh *mesh)
 {
   BKE_mesh_runtime_clear_cache(mesh);
@@ -309,6 +309,20 @@ void BKE_mesh_runtime_clear_cache(Mesh *mesh)
   BKE_mesh_runtime_clear_geometry(mesh);
 }
 
+void BKE_mesh_runtime_clear_cache_keep_topology(Mesh *mesh)
+{
+  using namespace blender::bke;
+  free_mesh_eval(*mesh->runtime);
+  free_batch_cache(*mesh->runtime);
+  mesh->runtime->edit_data.reset();
+  mesh->runtime->subdiv_ccg.reset();
+  mesh->runtime->subsurf_face_dot_tags.clear_and_shrink();
+  mesh->runtime->subsurf_optimal_display_edges.clear_and_shrink();
+  /* Sharpness and custom normals are part of the attributes and may have changed too, they only
+   * affect the corner normals which are tagged here as well. */
+  mesh->tag_positions_changed();
+}
+
 void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
 {
   /* Tagging shared caches dirty will free the allocated data if there is only one user. */
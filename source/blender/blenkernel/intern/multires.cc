@@ -481,17 +481,19 @@ static int get_levels_from_disps(Object *ob)
   for (const int i : faces.index_range()) {
     for (const int corner : faces[i]) {
       const MDisps *md = &mdisp[corner];
-      if (md->totdisp == 0) {
+      /* Grids without displacement are stored sparsely, but still know their level. */
+      const int totdisp = md->disps ? md->totdisp : multires_grid_tot[md->level];
+      if (totdisp == 0) {
         continue;
       }
 
       while (true) {
         int side = (1 << (totlvl - 1)) + 1;
         int lvl_totdisp = side * side;
-        if (md->totdisp == lvl_totdisp) {
+        if (totdisp == lvl_totdisp) {
           break;
         }
-        if (md->totdisp < lvl_totdisp) {
+        if (totdisp < lvl_totdisp) {
           totlvl--;
         }
         else {
@@ -546,6 +548,11 @@ static void multires_reallocate_mdisps(int totloop, MDisps *mdisps, int lvl)
 
   /* reallocate displacements to be filled in */
   for (i = 0; i < totloop; i++) {
+    /* Keep grids which already have data, others may be stored sparsely. */
+    if (mdisps[i].disps && mdisps[i].level == lvl) {
+      continue;
+    }
+
     int totdisp = multires_grid_tot[lvl];
     float(*disps)[3] = static_cast<float(*)[3]>(
         MEM_calloc_arrayN(totdisp, sizeof(float[3]), __func__));
@@ -1454,11 +1461,22 @@ void multiresModifier_prepare_join(Depsgraph *depsgraph, Scene *scene, Object *o
 }
 
 void multires_topology_changed(Mesh *mesh)
+{
+  CustomData_external_read(&mesh->corner_data, &mesh->id, CD_MASK_MDISPS, mesh->corners_num);
+  multires_ensure_dense_grids(mesh);
+}
+
+int multires_grid_tot_for_level(const int level)
+{
+  BLI_assert(level >= 0 && level < ARRAY_SIZE(multires_grid_tot));
+  return multires_grid_tot[level];
+}
+
+void multires_ensure_dense_grids(Mesh *mesh)
 {
   MDisps *mdisp = nullptr, *cur = nullptr;
-  int i, grid = 0;
+  int i, grid = 0, level = 0;
 
-  CustomData_external_read(&mesh->corner_data, &mesh->id, CD_MASK_MDISPS, mesh->corners_num);
   mdisp = static_cast<MDisps *>(
       CustomData_get_layer_for_write(&mesh->corner_data, CD_MDISPS, mesh->corners_num));
 
@@ -1468,8 +1486,9 @@ void multires_topology_changed(Mesh *mesh)
 
   cur = mdisp;
   for (i = 0; i < mesh->corners_num; i++, cur++) {
-    if (cur->totdisp) {
-      grid = mdisp->totdisp;
+    if (cur->totdisp && cur->disps) {
+      grid = cur->totdisp;
+      level = cur->level;
 
       break;
     }
@@ -1478,8 +1497,17 @@ void multires_topology_changed(Mesh *mesh)
   for (i = 0; i < mesh->corners_num; i++, mdisp++) {
     /* allocate memory for mdisp, the whole disp layer would be erased otherwise */
     if (!mdisp->totdisp || !mdisp->disps) {
-      if (grid) {
+      /* Sparse grids keep their level, also when no grid has data. */
+      if (mdisp->level) {
+        MEM_SAFE_FREE(mdisp->disps);
+        mdisp->totdisp = multires_grid_tot[mdisp->level];
+        mdisp->disps = static_cast<float(*)[3]>(
+            MEM_calloc_arrayN(mdisp->totdisp, sizeof(float[3]), "mdisp topology"));
+      }
+      else if (grid) {
+        MEM_SAFE_FREE(mdisp->disps);
         mdisp->totdisp = grid;
+        mdisp->level = level;
         mdisp->disps = static_cast<float(*)[3]>(
             MEM_calloc_arrayN(mdisp->totdisp, sizeof(float[3]), "mdisp topology"));
       }
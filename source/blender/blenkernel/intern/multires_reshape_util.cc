@@ -15,6 +15,7 @@
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_math_matrix.h"
 #include "BLI_task.h"
 
@@ -726,10 +727,10 @@ static void foreach_grid_coordinate(const MultiresReshapeContext *reshape_contex
 }
 
 static void object_grid_element_to_tangent_displacement(
-    const MultiresReshapeContext *reshape_context,
-    const GridCoord *grid_coord,
-    void * /*userdata_v*/)
+    const MultiresReshapeContext *reshape_context, const GridCoord *grid_coord, void *userdata_v)
 {
+  bool *grid_is_displaced = static_cast<bool *>(userdata_v);
+
   float P[3];
   float tangent_matrix[3][3];
   multires_reshape_evaluate_limit_at_grid(reshape_context, grid_coord, P, tangent_matrix);
@@ -746,16 +747,49 @@ static void object_grid_element_to_tangent_displacement(
   float tangent_D[3];
   mul_v3_m3v3(tangent_D, inv_tangent_matrix, D);
 
+  /* Only grids of exactly zero displacement are freed, so that storing them sparsely is lossless.
+   * All coordinates of a grid are handled by the same task, so no synchronization is needed. */
+  if (!is_zero_v3(tangent_D)) {
+    grid_is_displaced[grid_coord->grid_index] = true;
+  }
+
   copy_v3_v3(grid_element.displacement, tangent_D);
 }
 
+/**
+ * Free the displacement grids which are not displaced from the limit surface, so that memory is
+ * only used by the sculpted parts of the mesh. The level of the freed grids is kept, their
+ * evaluation falls back to the limit surface.
+ *
+ * Grids with hidden elements are kept, as the hidden bitmap size is derived from the grid size.
+ * The external file format expects every grid to be stored, so sparse storage is not used there.
+ */
+static void sparsify_displacement_grids(const MultiresReshapeContext *reshape_context,
+                                        const blender::Span<bool> grid_is_displaced)
+{
+  Mesh *base_mesh = reshape_context->base_mesh;
+  if (CustomData_external_test(&base_mesh->corner_data, CD_MDISPS)) {
+    return;
+  }
+  for (const int grid_index : grid_is_displaced.index_range()) {
+    MDisps *displacement_grid = &reshape_context->mdisps[grid_index];
+    if (grid_is_displaced[grid_index] || displacement_grid->hidden != nullptr) {
+      continue;
+    }
+    MEM_SAFE_FREE(displacement_grid->disps);
+    displacement_grid->totdisp = 0;
+  }
+}
+
 void multires_reshape_object_grids_to_tangent_displacement(
     const MultiresReshapeContext *reshape_context)
 {
+  blender::Array<bool> grid_is_displaced(reshape_context->num_grids, false);
   foreach_grid_coordinate(reshape_context,
                           reshape_context->top.level,
                           object_grid_element_to_tangent_displacement,
-                          nullptr);
+                          grid_is_displaced.data());
+  sparsify_displacement_grids(reshape_context, grid_is_displaced);
 }
 
 /** \} */
@@ -786,6 +820,14 @@ static void assign_final_coords_from_mdisps(const MultiresReshapeContext *reshap
 void multires_reshape_assign_final_coords_from_mdisps(
     const MultiresReshapeContext *reshape_context)
 {
+  /* Grids stored sparsely have no displacement, they are used to store the final coordinates. */
+  for (int grid_index = 0; grid_index < reshape_context->num_grids; grid_index++) {
+    MDisps *displacement_grid = &reshape_context->mdisps[grid_index];
+    if (displacement_grid->disps == nullptr) {
+      allocate_displacement_grid(displacement_grid, reshape_context->top.level);
+    }
+  }
+
   foreach_grid_coordinate(
       reshape_context, reshape_context->top.level, assign_final_coords_from_mdisps, nullptr);
 }
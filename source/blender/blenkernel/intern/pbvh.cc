@@ -65,25 +65,6 @@ static Bounds<float3> merge_bounds(const Bounds<float3> &a, const Bounds<float3>
   return bounds::merge(a, b);
 }
 
-static int partition_along_axis(const Span<float3> face_centers,
-                                MutableSpan<int> faces,
-                                const int axis,
-                                const float middle)
-{
-  const int *split = std::partition(faces.begin(), faces.end(), [&](const int face) {
-    return face_centers[face][axis] >= middle;
-  });
-  return split - faces.begin();
-}
-
-static int partition_material_indices(const Span<int> material_indices, MutableSpan<int> faces)
-{
-  const int first = material_indices[faces.first()];
-  const int *split = std::partition(
-      faces.begin(), faces.end(), [&](const int face) { return material_indices[face] == first; });
-  return split - faces.begin();
-}
-
 BLI_NOINLINE static void build_mesh_leaf_nodes(const int verts_num,
                                                const OffsetIndices<int> faces,
                                                const Span<int> corner_verts,
@@ -148,31 +129,224 @@ static bool leaf_needs_material_split(const Span<int> faces, const Span<int> mat
   return false;
 }
 
-static void build_nodes_recursive_mesh(const Span<int> material_indices,
-                                       const int leaf_limit,
-                                       const int node_index,
-                                       const std::optional<Bounds<float3>> &bounds_precalc,
-                                       const Span<float3> face_centers,
-                                       const int depth,
-                                       MutableSpan<int> faces,
-                                       Vector<MeshNode> &nodes)
+/**
+ * Nodes with more faces than this are partitioned with multiple threads, and their children are
+ * built in parallel.
+ */
+static constexpr int parallel_build_threshold = 1 << 14;
+
+/** The number of bins used to evaluate split candidates along each axis. */
+static constexpr int sah_bins_num = 16;
+
+/**
+ * Partition the face indices into the faces that satisfy the predicate followed by the faces that
+ * don't, using multiple threads for large spans.
+ *
+ * \return The number of faces in the first partition.
+ */
+template<typename Fn> static int partition_faces(MutableSpan<int> faces, const Fn &predicate)
+{
+  if (faces.size() < parallel_build_threshold) {
+    const int *split = std::partition(faces.begin(), faces.end(), predicate);
+    return split - faces.begin();
+  }
+
+  constexpr int chunk_size = 1 << 14;
+  const int chunks_num = divide_ceil_u(faces.size(), chunk_size);
+  const auto chunk_range = [&](const int chunk) {
+    return faces.index_range().slice(chunk * chunk_size,
+                                     std::min<int>(chunk_size, faces.size() - chunk * chunk_size));
+  };
+
+  /* Count the faces in the first partition for every chunk to find each chunk's output offset. */
+  Array<int> first_counts(chunks_num + 1);
+  Array<int> second_counts(chunks_num + 1);
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int chunk : range) {
+      const Span<int> chunk_faces = faces.slice(chunk_range(chunk));
+      first_counts[chunk] = std::count_if(chunk_faces.begin(), chunk_faces.end(), predicate);
+      second_counts[chunk] = chunk_faces.size() - first_counts[chunk];
+    }
+  });
+  const OffsetIndices first_offsets = offset_indices::accumulate_counts_to_offsets(first_counts);
+  const OffsetIndices second_offsets = offset_indices::accumulate_counts_to_offsets(
+      second_counts);
+  const int split = first_offsets.total_size();
+
+  Array<int> result(faces.size(), NoInitialization());
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int chunk : range) {
+      int first_index = first_offsets[chunk].start();
+      int second_index = split + second_offsets[chunk].start();
+      for (const int face : faces.slice(chunk_range(chunk))) {
+        if (predicate(face)) {
+          result[first_index++] = face;
+        }
+        else {
+          result[second_index++] = face;
+        }
+      }
+    }
+  });
+  array_utils::copy(result.as_span(), faces);
+  return split;
+}
+
+static int partition_along_axis(const Span<float3> face_centers,
+                                MutableSpan<int> faces,
+                                const int axis,
+                                const float middle)
+{
+  return partition_faces(faces,
+                         [&](const int face) { return face_centers[face][axis] >= middle; });
+}
+
+static int partition_material_indices(const Span<int> material_indices, MutableSpan<int> faces)
+{
+  const int first = material_indices[faces.first()];
+  return partition_faces(faces,
+                         [&](const int face) { return material_indices[face] == first; });
+}
+
+static float bounds_half_area(const Bounds<float3> &bounds)
+{
+  const float3 size = bounds.max - bounds.min;
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+/** Face count and face center bounds for a slice of the node's bounds along a single axis. */
+struct SAHBin {
+  int faces_num = 0;
+  Bounds<float3> bounds = negative_bounds();
+};
+
+using SAHBins = std::array<std::array<SAHBin, sah_bins_num>, 3>;
+
+/** Maps face center coordinates to bin indices along each axis. */
+struct SAHBinMapping {
+  float3 min;
+  float3 scale;
+
+  SAHBinMapping(const Bounds<float3> &bounds) : min(bounds.min)
+  {
+    const float3 size = bounds.max - bounds.min;
+    for (const int axis : IndexRange(3)) {
+      /* Degenerate axes put every face in the first bin, so they are never chosen for a split. */
+      scale[axis] = size[axis] > 0.0f ? sah_bins_num / size[axis] : 0.0f;
+    }
+  }
+
+  int bin(const float3 &center, const int axis) const
+  {
+    const int bin = int((center[axis] - min[axis]) * scale[axis]);
+    return std::clamp(bin, 0, sah_bins_num - 1);
+  }
+};
+
+struct SAHSplit {
+  int axis;
+  int bin;
+  Bounds<float3> bounds[2];
+};
+
+/**
+ * Find the split plane that minimizes the surface area heuristic cost of the children, using
+ * binned face centers. Using the face centers rather than the face bounds makes the estimate
+ * slightly less accurate, but they are already available and the leaves are large anyway.
+ */
+static std::optional<SAHSplit> find_sah_split(const Span<float3> face_centers,
+                                              const Span<int> faces,
+                                              const SAHBinMapping &mapping)
+{
+  const SAHBins bins = threading::parallel_reduce(
+      faces.index_range(),
+      1024,
+      SAHBins(),
+      [&](const IndexRange range, SAHBins bins) {
+        for (const int face : faces.slice(range)) {
+          const float3 &center = face_centers[face];
+          for (const int axis : IndexRange(3)) {
+            SAHBin &bin = bins[axis][mapping.bin(center, axis)];
+            bin.faces_num++;
+            math::min_max(center, bin.bounds.min, bin.bounds.max);
+          }
+        }
+        return bins;
+      },
+      [](const SAHBins &a, const SAHBins &b) {
+        SAHBins result;
+        for (const int axis : IndexRange(3)) {
+          for (const int i : IndexRange(sah_bins_num)) {
+            result[axis][i].faces_num = a[axis][i].faces_num + b[axis][i].faces_num;
+            result[axis][i].bounds = merge_bounds(a[axis][i].bounds, b[axis][i].bounds);
+          }
+        }
+        return result;
+      });
+
+  std::optional<SAHSplit> best;
+  float best_cost = std::numeric_limits<float>::max();
+  for (const int axis : IndexRange(3)) {
+    /* Accumulate the cost of the right side of every candidate split plane, then sweep from the
+     * left to combine it with the cost of the left side. */
+    std::array<float, sah_bins_num> right_costs;
+    std::array<Bounds<float3>, sah_bins_num> right_bounds;
+    SAHBin right;
+    for (int i = sah_bins_num - 1; i > 0; i--) {
+      right.faces_num += bins[axis][i].faces_num;
+      right.bounds = merge_bounds(right.bounds, bins[axis][i].bounds);
+      right_costs[i] = right.faces_num * bounds_half_area(right.bounds);
+      right_bounds[i] = right.bounds;
+    }
+    SAHBin left;
+    for (const int i : IndexRange(1, sah_bins_num - 1)) {
+      left.faces_num += bins[axis][i - 1].faces_num;
+      left.bounds = merge_bounds(left.bounds, bins[axis][i - 1].bounds);
+      if (left.faces_num == 0 || left.faces_num == faces.size()) {
+        continue;
+      }
+      const float cost = left.faces_num * bounds_half_area(left.bounds) + right_costs[i];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = SAHSplit{axis, i, {left.bounds, right_bounds[i]}};
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * Temporary tree used during the build, before the nodes are stored in their final order. Because
+ * the faces are partitioned in place, each node only refers to a range of the face indices array.
+ */
+struct BuildNode {
+  IndexRange faces;
+  std::array<std::unique_ptr<BuildNode>, 2> children;
+};
+
+static std::unique_ptr<BuildNode> build_nodes_recursive(
+    const Span<int> material_indices,
+    const int leaf_limit,
+    const std::optional<Bounds<float3>> &bounds_precalc,
+    const Span<float3> face_centers,
+    const int depth,
+    const IndexRange node_faces,
+    MutableSpan<int> all_faces)
 {
+  std::unique_ptr<BuildNode> node = std::make_unique<BuildNode>();
+  node->faces = node_faces;
+  MutableSpan<int> faces = all_faces.slice(node_faces);
+
   /* Decide whether this is a leaf or not */
   const bool below_leaf_limit = faces.size() <= leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(faces, material_indices)) {
-      MeshNode &node = nodes[node_index];
-      node.flag_ |= PBVH_Leaf;
-      node.face_indices_ = faces;
-      return;
+      return node;
     }
   }
 
-  /* Add two child nodes */
-  nodes[node_index].children_offset_ = nodes.size();
-  nodes.resize(nodes.size() + 2);
-
   int split;
+  std::array<std::optional<Bounds<float3>>, 2> child_bounds;
   if (!below_leaf_limit) {
     Bounds<float3> bounds;
     if (bounds_precalc) {
@@ -191,11 +365,25 @@ static void build_nodes_recursive_mesh(const Span<int> material_indices,
           },
           merge_bounds);
     }
-    const int axis = math::dominant_axis(bounds.max - bounds.min);
 
-    /* Partition primitives along that axis */
-    split = partition_along_axis(
-        face_centers, faces, axis, math::midpoint(bounds.min[axis], bounds.max[axis]));
+    const SAHBinMapping mapping(bounds);
+    if (const std::optional<SAHSplit> sah_split = find_sah_split(face_centers, faces, mapping)) {
+      split = partition_faces(faces, [&](const int face) {
+        return mapping.bin(face_centers[face], sah_split->axis) < sah_split->bin;
+      });
+      child_bounds[0] = sah_split->bounds[0];
+      child_bounds[1] = sah_split->bounds[1];
+    }
+    else {
+      /* All face centers fall into a single bin, fall back to splitting at the middle. */
+      const int axis = math::dominant_axis(bounds.max - bounds.min);
+      split = partition_along_axis(
+          face_centers, faces, axis, math::midpoint(bounds.min[axis], bounds.max[axis]));
+      if (ELEM(split, 0, faces.size())) {
+        /* All face centers are at the same position, just split the faces in half. */
+        split = faces.size() / 2;
+      }
+    }
   }
   else {
     /* Partition primitives by material */
@@ -203,22 +391,92 @@ static void build_nodes_recursive_mesh(const Span<int> material_indices,
   }
 
   /* Build children */
-  build_nodes_recursive_mesh(material_indices,
-                             leaf_limit,
-                             nodes[node_index].children_offset_,
-                             std::nullopt,
-                             face_centers,
-                             depth + 1,
-                             faces.take_front(split),
-                             nodes);
-  build_nodes_recursive_mesh(material_indices,
-                             leaf_limit,
-                             nodes[node_index].children_offset_ + 1,
-                             std::nullopt,
-                             face_centers,
-                             depth + 1,
-                             faces.drop_front(split),
-                             nodes);
+  const IndexRange left = node_faces.take_front(split);
+  const IndexRange right = node_faces.drop_front(split);
+  threading::parallel_invoke(
+      faces.size() > parallel_build_threshold,
+      [&]() {
+        node->children[0] = build_nodes_recursive(material_indices,
+                                                  leaf_limit,
+                                                  child_bounds[0],
+                                                  face_centers,
+                                                  depth + 1,
+                                                  left,
+                                                  all_faces);
+      },
+      [&]() {
+        node->children[1] = build_nodes_recursive(material_indices,
+                                                  leaf_limit,
+                                                  child_bounds[1],
+                                                  face_centers,
+                                                  depth + 1,
+                                                  right,
+                                                  all_faces);
+      });
+  return node;
+}
+
+/**
+ * Store the temporary build tree in the final nodes array, where the two children of every node
+ * are stored next to each other.
+ */
+template<typename NodeT>
+static void flatten_build_nodes(const BuildNode &build_node,
+                                const int node_index,
+                                const Span<int> faces,
+                                Vector<NodeT> &nodes)
+{
+  if (!build_node.children[0]) {
+    NodeT &node = nodes[node_index];
+    node.flag_ |= PBVH_Leaf;
+    if constexpr (std::is_same_v<NodeT, MeshNode>) {
+      node.face_indices_ = faces.slice(build_node.faces);
+    }
+    else {
+      node.prim_indices_ = faces.slice(build_node.faces);
+    }
+    return;
+  }
+
+  const int children_offset = nodes.size();
+  nodes[node_index].children_offset_ = children_offset;
+  nodes.resize(nodes.size() + 2);
+  flatten_build_nodes(*build_node.children[0], children_offset, faces, nodes);
+  flatten_build_nodes(*build_node.children[1], children_offset + 1, faces, nodes);
+}
+
+/**
+ * Partition the faces into a tree of nodes. Splits are chosen with a binned surface area
+ * heuristic on the face centers, and large nodes are processed with multiple threads.
+ */
+template<typename NodeT>
+static void build_nodes(const Span<int> material_indices,
+                        const int leaf_limit,
+                        const Bounds<float3> &bounds,
+                        const Span<float3> face_centers,
+                        MutableSpan<int> faces,
+                        Vector<NodeT> &nodes)
+{
+  const std::unique_ptr<BuildNode> root = build_nodes_recursive(
+      material_indices, leaf_limit, bounds, face_centers, 0, faces.index_range(), faces);
+  nodes.resize(1);
+  flatten_build_nodes(*root, 0, faces, nodes);
+}
+
+/**
+ * Choose the maximum number of faces in each leaf node. Larger leaves have less overhead per node,
+ * while smaller leaves mean brushes process fewer vertices outside of their radius and give
+ * better multi-threading on smaller meshes. The limit is independent from the number of threads
+ * to keep the tree the same on every computer.
+ */
+static int leaf_limit_mesh(const int faces_num)
+{
+  constexpr int min_leaf_limit = 1000;
+  constexpr int max_leaf_limit = 10000;
+  static_assert(max_leaf_limit < std::numeric_limits<MeshNode::LocalVertMapIndexT>::max());
+  /* Aim for a minimum number of leaves for smaller meshes. */
+  constexpr int leaves_num_target = 64;
+  return std::clamp(faces_num / leaves_num_target, min_leaf_limit, max_leaf_limit);
 }
 
 inline Bounds<float3> calc_face_bounds(const Span<float3> vert_positions,
@@ -244,8 +502,7 @@ Tree Tree::from_mesh(const Mesh &mesh)
     return pbvh;
   }
 
-  constexpr int leaf_limit = 10000;
-  static_assert(leaf_limit < std::numeric_limits<MeshNode::LocalVertMapIndexT>::max());
+  const int leaf_limit = leaf_limit_mesh(faces.size());
 
   Array<float3> face_centers(faces.size());
   const Bounds<float3> bounds = threading::parallel_reduce(
@@ -272,13 +529,11 @@ Tree Tree::from_mesh(const Mesh &mesh)
   array_utils::fill_index_range<int>(pbvh.prim_indices_);
 
   Vector<MeshNode> &nodes = std::get<Vector<MeshNode>>(pbvh.nodes_);
-  nodes.resize(1);
   {
 #ifdef DEBUG_BUILD_TIME
-    SCOPED_TIMER_AVERAGED("build_nodes_recursive_mesh");
+    SCOPED_TIMER_AVERAGED("build_nodes");
 #endif
-    build_nodes_recursive_mesh(
-        material_index, leaf_limit, 0, bounds, face_centers, 0, pbvh.prim_indices_, nodes);
+    build_nodes(material_index, leaf_limit, bounds, face_centers, pbvh.prim_indices_, nodes);
   }
 
   build_mesh_leaf_nodes(mesh.verts_num, faces, corner_verts, nodes);
@@ -301,79 +556,6 @@ Tree Tree::from_mesh(const Mesh &mesh)
   return pbvh;
 }
 
-static void build_nodes_recursive_grids(const Span<int> material_indices,
-                                        const int leaf_limit,
-                                        const int node_index,
-                                        const std::optional<Bounds<float3>> &bounds_precalc,
-                                        const Span<float3> face_centers,
-                                        const int depth,
-                                        MutableSpan<int> faces,
-                                        Vector<GridsNode> &nodes)
-{
-  /* Decide whether this is a leaf or not */
-  const bool below_leaf_limit = faces.size() <= leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
-  if (below_leaf_limit) {
-    if (!leaf_needs_material_split(faces, material_indices)) {
-      GridsNode &node = nodes[node_index];
-      node.flag_ |= PBVH_Leaf;
-      node.prim_indices_ = faces;
-      return;
-    }
-  }
-
-  /* Add two child nodes */
-  nodes[node_index].children_offset_ = nodes.size();
-  nodes.resize(nodes.size() + 2);
-
-  int split;
-  if (!below_leaf_limit) {
-    Bounds<float3> bounds;
-    if (bounds_precalc) {
-      bounds = *bounds_precalc;
-    }
-    else {
-      bounds = threading::parallel_reduce(
-          faces.index_range(),
-          1024,
-          negative_bounds(),
-          [&](const IndexRange range, Bounds<float3> value) {
-            for (const int face : faces.slice(range)) {
-              math::min_max(face_centers[face], value.min, value.max);
-            }
-            return value;
-          },
-          merge_bounds);
-    }
-    const int axis = math::dominant_axis(bounds.max - bounds.min);
-
-    /* Partition primitives along that axis */
-    split = partition_along_axis(
-        face_centers, faces, axis, math::midpoint(bounds.min[axis], bounds.max[axis]));
-  }
-  else {
-    /* Partition primitives by material */
-    split = partition_material_indices(material_indices, faces);
-  }
-
-  /* Build children */
-  build_nodes_recursive_grids(material_indices,
-                              leaf_limit,
-                              nodes[node_index].children_offset_,
-                              std::nullopt,
-                              face_centers,
-                              depth + 1,
-                              faces.take_front(split),
-                              nodes);
-  build_nodes_recursive_grids(material_indices,
-                              leaf_limit,
-                              nodes[node_index].children_offset_ + 1,
-                              std::nullopt,
-                              face_centers,
-                              depth + 1,
-                              faces.drop_front(split),
-                              nodes);
-}
-
 static Bounds<float3> calc_face_grid_bounds(const OffsetIndices<int> faces,
                                             const Span<float3> positions,
                                             const CCGKey &key,
@@ -428,13 +610,11 @@ Tree Tree::from_grids(const Mesh &base_mesh, const SubdivCCG &subdiv_ccg)
   array_utils::fill_index_range<int>(face_indices);
 
   Vector<GridsNode> &nodes = std::get<Vector<GridsNode>>(pbvh.nodes_);
-  nodes.resize(1);
   {
 #ifdef DEBUG_BUILD_TIME
-    SCOPED_TIMER_AVERAGED("build_nodes_recursive_grids");
+    SCOPED_TIMER_AVERAGED("build_nodes");
 #endif
-    build_nodes_recursive_grids(
-        material_index, leaf_limit, 0, bounds, face_centers, 0, face_indices, nodes);
+    build_nodes(material_index, leaf_limit, bounds, face_centers, face_indices, nodes);
   }
 
   /* Convert face indices into grid indices. */
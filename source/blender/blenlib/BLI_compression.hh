@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Utilities for compressing data in memory, for storage that is rarely accessed such as undo
+ * steps or caches.
+ */
+
+#include <cstddef>
+
+#include "BLI_array.hh"
+#include "BLI_span.hh"
+
+namespace blender::compression {
+
+/**
+ * Compress the data with Zstandard at the given compression level. Low levels are much faster
+ * and are generally preferable for interactive use.
+ *
+ * \return The compressed data, or an empty array if compression failed.
+ */
+Array<std::byte, 0> compress_zstd(Span<std::byte> data, int level);
+
+/**
+ * Decompress data created by #compress_zstd. The size of \a r_data must match the size of the
+ * original uncompressed data.
+ *
+ * \return False if the data could not be decompressed.
+ */
+bool decompress_zstd(Span<std::byte> compressed, MutableSpan<std::byte> r_data);
+
+/**
+ * Replace every 32 bit value with its XOR with the value \a stride elements before it. Nearby
+ * elements in geometry or image data often have the same sign, exponent and high mantissa bits, so
+ * this gives many more zero bits, which makes the data much more compressible.
+ *
+ * \param stride: The number of values per element, i.e. 3 for positions.
+ */
+void xor_delta_encode(MutableSpan<uint32_t> data, int stride);
+
+/** Reverse #xor_delta_encode. */
+void xor_delta_decode(MutableSpan<uint32_t> data, int stride);
+
+}  // namespace blender::compression
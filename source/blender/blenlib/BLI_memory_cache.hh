@@ -40,6 +40,17 @@ std::shared_ptr<const T> get(const GenericKey &key, FunctionRef<std::unique_ptr<
 std::shared_ptr<CachedValue> get_base(const GenericKey &key,
                                       FunctionRef<std::unique_ptr<CachedValue>()> compute_fn);
 
+/**
+ * Returns the value that corresponds to the given key if it's cached, otherwise null. This is
+ * useful when the value can't be computed on demand, e.g. because it's only available later on.
+ */
+template<typename T> std::shared_ptr<const T> find(const GenericKey &key);
+
+/**
+ * A non-templated version of #find.
+ */
+std::shared_ptr<CachedValue> find_base(const GenericKey &key);
+
 /**
  * Set how much memory the cache is allowed to use. This is only an approximation because counting
  * the memory is not 100% accurate, and for some types the memory usage may even change over time.
@@ -53,6 +64,12 @@ void set_approximate_size_limit(int64_t limit_in_bytes);
  */
 void clear();
 
+/**
+ * Remove all elements for which the predicate is true. Like #clear, this does not guarantee
+ * anything about elements added by other threads meanwhile.
+ */
+void remove_if(FunctionRef<bool(const GenericKey &)> predicate);
+
 /* -------------------------------------------------------------------- */
 /** \name Inline Functions
  * \{ */
@@ -64,6 +81,11 @@ inline std::shared_ptr<const T> get(const GenericKey &key,
   return std::dynamic_pointer_cast<const T>(get_base(key, compute_fn));
 }
 
+template<typename T> inline std::shared_ptr<const T> find(const GenericKey &key)
+{
+  return std::dynamic_pointer_cast<const T>(find_base(key));
+}
+
 /** \} */
 
 }  // namespace blender::memory_cache
@@ -0,0 +1,58 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <zstd.h>
+
+#include "BLI_compression.hh"
+
+namespace blender::compression {
+
+Array<std::byte, 0> compress_zstd(const Span<std::byte> data, const int level)
+{
+  if (data.is_empty()) {
+    return {};
+  }
+  Array<std::byte> buffer(ZSTD_compressBound(data.size()), NoInitialization());
+  const size_t size = ZSTD_compress(buffer.data(), buffer.size(), data.data(), data.size(), level);
+  if (ZSTD_isError(size)) {
+    return {};
+  }
+  return buffer.as_span().take_front(size);
+}
+
+bool decompress_zstd(const Span<std::byte> compressed, MutableSpan<std::byte> r_data)
+{
+  if (compressed.is_empty()) {
+    return r_data.is_empty();
+  }
+  const size_t size = ZSTD_decompress(
+      r_data.data(), r_data.size(), compressed.data(), compressed.size());
+  if (ZSTD_isError(size)) {
+    return false;
+  }
+  return size == r_data.size();
+}
+
+void xor_delta_encode(MutableSpan<uint32_t> data, const int stride)
+{
+  BLI_assert(stride > 0);
+  /* Iterate backwards so the previous values are still unmodified. */
+  for (int64_t i = data.size() - 1; i >= stride; i--) {
+    data[i] ^= data[i - stride];
+  }
+}
+
+void xor_delta_decode(MutableSpan<uint32_t> data, const int stride)
+{
+  BLI_assert(stride > 0);
+  for (int64_t i = stride; i < data.size(); i++) {
+    data[i] ^= data[i - stride];
+  }
+}
+
+}  // namespace blender::compression
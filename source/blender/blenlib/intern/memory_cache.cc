@@ -129,6 +129,19 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
   return result;
 }
 
+std::shared_ptr<CachedValue> find_base(const GenericKey &key)
+{
+  Cache &cache = get_cache();
+  CacheMap::ConstAccessor accessor;
+  if (!cache.map.lookup(accessor, std::ref(key))) {
+    return {};
+  }
+  /* "Touch" the cached value like #get_base does, so it's less likely to be removed. */
+  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
+  set_new_logical_time(accessor->second, new_time);
+  return accessor->second.value;
+}
+
 void set_approximate_size_limit(const int64_t limit_in_bytes)
 {
   Cache &cache = get_cache();
@@ -152,6 +165,33 @@ void clear()
   cache.memory.reset();
 }
 
+void remove_if(const FunctionRef<bool(const GenericKey &)> predicate)
+{
+  Cache &cache = get_cache();
+  std::lock_guard lock{cache.global_mutex};
+
+  /* Recount the memory of the remaining elements, removing from #MemoryCount is not
+   * implemented. */
+  Vector<const GenericKey *> remaining_keys;
+  cache.memory.reset();
+  MemoryCounter memory_counter{cache.memory};
+  for (const GenericKey *key : cache.keys) {
+    if (predicate(*key)) {
+      /* This frees the key. */
+      cache.map.remove(*key);
+      continue;
+    }
+    CacheMap::ConstAccessor accessor;
+    if (!cache.map.lookup(accessor, *key)) {
+      continue;
+    }
+    accessor->second.value->count_memory(memory_counter);
+    remaining_keys.append(key);
+  }
+  cache.keys = std::move(remaining_keys);
+  cache.size_in_bytes = cache.memory.total_bytes;
+}
+
 static void try_enforce_limit()
 {
   Cache &cache = get_cache();
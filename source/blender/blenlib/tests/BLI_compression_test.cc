@@ -0,0 +1,66 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_compression.hh"
+#include "BLI_math_vector_types.hh"
+
+namespace blender::compression::tests {
+
+TEST(compression, XorDeltaRoundTrip)
+{
+  const Array<uint32_t> src = {1, 2, 3, 7, 2, 3, 0xFFFFFFFF, 5, 3, 9};
+  for (const int stride : {1, 2, 3, 4}) {
+    Array<uint32_t> data = src;
+    xor_delta_encode(data, stride);
+    for (const int i : IndexRange(stride)) {
+      EXPECT_EQ(data[i], src[i]);
+    }
+    xor_delta_decode(data, stride);
+    EXPECT_EQ_ARRAY(data.data(), src.data(), src.size());
+  }
+}
+
+TEST(compression, XorDeltaEqualElements)
+{
+  Array<float3> positions(16, float3(1.5f, -2.0f, 3.25f));
+  MutableSpan<uint32_t> data(reinterpret_cast<uint32_t *>(positions.data()), positions.size() * 3);
+  xor_delta_encode(data, 3);
+  for (const int i : data.index_range().drop_front(3)) {
+    EXPECT_EQ(data[i], 0);
+  }
+  xor_delta_decode(data, 3);
+  for (const float3 &position : positions) {
+    EXPECT_EQ(position, float3(1.5f, -2.0f, 3.25f));
+  }
+}
+
+TEST(compression, ZstdRoundTrip)
+{
+  Array<int> src(10000);
+  for (const int i : src.index_range()) {
+    src[i] = i % 100;
+  }
+  const Array<std::byte, 0> compressed = compress_zstd(src.as_span().cast<std::byte>(), 1);
+  EXPECT_FALSE(compressed.is_empty());
+  EXPECT_LT(compressed.size(), src.as_span().size_in_bytes());
+
+  Array<int> result(src.size());
+  EXPECT_TRUE(decompress_zstd(compressed, result.as_mutable_span().cast<std::byte>()));
+  EXPECT_EQ_ARRAY(result.data(), src.data(), src.size());
+
+  /* The output size must match the original size. */
+  Array<int> too_large(src.size() + 1);
+  EXPECT_FALSE(decompress_zstd(compressed, too_large.as_mutable_span().cast<std::byte>()));
+}
+
+TEST(compression, ZstdEmpty)
+{
+  const Array<std::byte, 0> compressed = compress_zstd({}, 1);
+  EXPECT_TRUE(compressed.is_empty());
+  EXPECT_TRUE(decompress_zstd(compressed, {}));
+}
+
+}  // namespace blender::compression::tests
@@ -80,4 +80,33 @@ TEST(memory_cache, Simple)
   }
 }
 
+TEST(memory_cache, Find)
+{
+  memory_cache::clear();
+  EXPECT_EQ(memory_cache::find<CachedInt>(GenericIntKey(1)), nullptr);
+  memory_cache::get<CachedInt>(GenericIntKey(1), []() { return std::make_unique<CachedInt>(7); });
+  std::shared_ptr<const CachedInt> value = memory_cache::find<CachedInt>(GenericIntKey(1));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->value, 7);
+  EXPECT_EQ(memory_cache::find<CachedInt>(GenericIntKey(2)), nullptr);
+  memory_cache::clear();
+  EXPECT_EQ(memory_cache::find<CachedInt>(GenericIntKey(1)), nullptr);
+}
+
+TEST(memory_cache, RemoveIf)
+{
+  memory_cache::clear();
+  for (int i = 0; i < 4; i++) {
+    memory_cache::get<CachedInt>(GenericIntKey(i),
+                                 [&]() { return std::make_unique<CachedInt>(i); });
+  }
+  /* The hash of the keys is their value. */
+  memory_cache::remove_if([](const GenericKey &key) { return key.hash() % 2 == 0; });
+  EXPECT_EQ(memory_cache::find<CachedInt>(GenericIntKey(0)), nullptr);
+  EXPECT_NE(memory_cache::find<CachedInt>(GenericIntKey(1)), nullptr);
+  EXPECT_EQ(memory_cache::find<CachedInt>(GenericIntKey(2)), nullptr);
+  EXPECT_NE(memory_cache::find<CachedInt>(GenericIntKey(3)), nullptr);
+  memory_cache::clear();
+}
+
 }  // namespace blender::memory_cache::tests
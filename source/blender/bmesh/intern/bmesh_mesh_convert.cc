@@ -81,6 +81,7 @@
 
 #include "BLI_alloca.h"
 #include "BLI_array.hh"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_index_range.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
@@ -193,12 +194,14 @@ static Vector<MeshToBMeshLayerInfo> mesh_to_bm_copy_info_calc(const CustomData &
   return infos;
 }
 
-static void mesh_attributes_copy_to_bmesh_block(CustomData &data,
-                                                const Span<MeshToBMeshLayerInfo> copy_info,
+/**
+ * Fill an element's custom data block, which must already be allocated. Only the block itself is
+ * written, so this can be called for different elements in parallel.
+ */
+static void mesh_attributes_copy_to_bmesh_block(const Span<MeshToBMeshLayerInfo> copy_info,
                                                 const int mesh_index,
                                                 BMHeader &header)
 {
-  CustomData_bmesh_alloc_block(&data, &header.data);
   for (const MeshToBMeshLayerInfo &info : copy_info) {
     if (info.mesh_data) {
       CustomData_data_copy_value(info.type,
@@ -211,6 +214,34 @@ static void mesh_attributes_copy_to_bmesh_block(CustomData &data,
   }
 }
 
+/**
+ * Multires displacement grids which are not displaced are stored sparsely, without data but with
+ * their level. The BMesh multires interpolation expects every grid to be allocated, give those
+ * zero displacement.
+ */
+static void bm_mdisps_ensure_allocated(BMesh &bm)
+{
+  const int cd_loop_mdisp_offset = CustomData_get_offset(&bm.ldata, CD_MDISPS);
+  if (cd_loop_mdisp_offset == -1) {
+    return;
+  }
+
+  BMIter iter;
+  BMFace *f;
+  BM_ITER_MESH (f, &iter, &bm, BM_FACES_OF_MESH) {
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      MDisps *md = static_cast<MDisps *>(BM_ELEM_CD_GET_VOID_P(l_iter, cd_loop_mdisp_offset));
+      if (md->disps == nullptr && md->level > 0) {
+        md->totdisp = multires_grid_tot_for_level(md->level);
+        md->disps = static_cast<float(*)[3]>(
+            MEM_calloc_arrayN(md->totdisp, sizeof(float[3]), __func__));
+      }
+    } while ((l_iter = l_iter->next) != l_first);
+  }
+}
+
 void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *params)
 {
   using namespace blender;
@@ -442,24 +473,8 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       BM_vert_select_set(bm, v, true);
     }
 
-    if (!vert_normals.is_empty()) {
-      copy_v3_v3(v->no, vert_normals[i]);
-    }
-
-    mesh_attributes_copy_to_bmesh_block(bm->vdata, vert_info, i, v->head);
-
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
-
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
-      }
-    }
+    /* The memory pool isn't thread-safe, the block is filled in parallel below. */
+    CustomData_bmesh_alloc_block(&bm->vdata, &v->head.data);
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
@@ -486,7 +501,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       BM_elem_flag_enable(e, BM_ELEM_SMOOTH);
     }
 
-    mesh_attributes_copy_to_bmesh_block(bm->edata, edge_info, i, e->head);
+    CustomData_bmesh_alloc_block(&bm->edata, &e->head.data);
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
@@ -496,21 +511,14 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
   const Span<int> corner_verts = mesh->corner_verts();
   const Span<int> corner_edges = mesh->corner_edges();
 
-  /* Only needed for selection. */
-
-  Array<BMFace *> ftable;
-  if (mesh->mselect && mesh->totselect != 0) {
-    ftable.reinitialize(mesh->faces_num);
-  }
+  /* Faces which couldn't be created are null. */
+  Array<BMFace *> ftable(mesh->faces_num);
 
   int totloops = 0;
   for (const int i : faces.index_range()) {
     const IndexRange face = faces[i];
-    BMFace *f = bm_face_create_from_mpoly(
+    BMFace *f = ftable[i] = bm_face_create_from_mpoly(
         *bm, corner_verts.slice(face), corner_edges.slice(face), vtable, etable);
-    if (!ftable.is_empty()) {
-      ftable[i] = f;
-    }
 
     if (UNLIKELY(f == nullptr)) {
       printf(
@@ -541,27 +549,88 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
       bm->act_face = f;
     }
 
-    int j = face.start();
     BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
     BMLoop *l_iter = l_first;
     do {
-      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
+      /* Don't use the corner index since we may have skipped some faces, hence some loops. */
       BM_elem_index_set(l_iter, totloops++); /* set_ok */
-
-      mesh_attributes_copy_to_bmesh_block(bm->ldata, loop_info, j, l_iter->head);
-      j++;
+      CustomData_bmesh_alloc_block(&bm->ldata, &l_iter->head.data);
     } while ((l_iter = l_iter->next) != l_first);
 
-    mesh_attributes_copy_to_bmesh_block(bm->pdata, poly_info, i, f->head);
-
-    if (params->calc_face_normal) {
-      BM_face_normal_update(f);
-    }
+    CustomData_bmesh_alloc_block(&bm->pdata, &f->head.data);
   }
   if (is_new) {
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
 
+  /* -------------------------------------------------------------------- */
+  /* Fill Element Data
+   *
+   * Creating elements and allocating their custom data blocks uses the memory pools so it has to
+   * be done serially above. Every element's data is independent from the others, which allows
+   * filling it in parallel. */
+
+  threading::parallel_invoke(
+      mesh->verts_num > 1024,
+      [&]() {
+        threading::parallel_for(vtable.index_range(), 2048, [&](const IndexRange range) {
+          for (const int i : range) {
+            BMVert *v = vtable[i];
+            if (!vert_normals.is_empty()) {
+              copy_v3_v3(v->no, vert_normals[i]);
+            }
+
+            mesh_attributes_copy_to_bmesh_block(vert_info, i, v->head);
+
+            /* Set shape key original index. */
+            if (cd_shape_keyindex_offset != -1) {
+              BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
+            }
+
+            /* Set shape-key data. */
+            if (tot_shape_keys) {
+              float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
+              for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
+                copy_v3_v3(*co_dst, shape_key_table[j][i]);
+              }
+            }
+          }
+        });
+      },
+      [&]() {
+        threading::parallel_for(etable.index_range(), 2048, [&](const IndexRange range) {
+          for (const int i : range) {
+            mesh_attributes_copy_to_bmesh_block(edge_info, i, etable[i]->head);
+          }
+        });
+      },
+      [&]() {
+        threading::parallel_for(ftable.index_range(), 1024, [&](const IndexRange range) {
+          for (const int i : range) {
+            BMFace *f = ftable[i];
+            if (f == nullptr) {
+              continue;
+            }
+            int j = faces[i].start();
+            BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
+            BMLoop *l_iter = l_first;
+            do {
+              mesh_attributes_copy_to_bmesh_block(loop_info, j, l_iter->head);
+              j++;
+            } while ((l_iter = l_iter->next) != l_first);
+
+            mesh_attributes_copy_to_bmesh_block(poly_info, i, f->head);
+
+            /* Only depends on the vertex positions, which are set on creation. */
+            if (params->calc_face_normal) {
+              BM_face_normal_update(f);
+            }
+          }
+        });
+      });
+
+  bm_mdisps_ensure_allocated(*bm);
+
   /* -------------------------------------------------------------------- */
   /* MSelect clears the array elements (to avoid adding multiple times).
    *
@@ -1292,24 +1361,33 @@ static void bm_to_mesh_verts(const BMesh &bm,
 
 static void bm_to_mesh_edges(const BMesh &bm,
                              const Span<const BMEdge *> bm_edges,
+                             const bool write_topology,
                              Mesh &mesh,
                              MutableSpan<bool> select_edge,
                              MutableSpan<bool> hide_edge,
                              MutableSpan<bool> sharp_edge,
                              MutableSpan<bool> uv_seams)
 {
-  CustomData_free_layer_named(&mesh.edge_data, ".edge_verts", mesh.edges_num);
-  CustomData_add_layer_named(
-      &mesh.edge_data, CD_PROP_INT32_2D, CD_CONSTRUCT, mesh.edges_num, ".edge_verts");
+  MutableSpan<int2> dst_edges;
+  if (write_topology) {
+    CustomData_free_layer_named(&mesh.edge_data, ".edge_verts", mesh.edges_num);
+    CustomData_add_layer_named(
+        &mesh.edge_data, CD_PROP_INT32_2D, CD_CONSTRUCT, mesh.edges_num, ".edge_verts");
+    dst_edges = mesh.edges_for_write();
+  }
   const Vector<BMeshToMeshLayerInfo> info = bm_to_mesh_copy_info_calc(bm.edata, mesh.edge_data);
-  MutableSpan<int2> dst_edges = mesh.edges_for_write();
 
   std::atomic<bool> any_loose_edge = false;
-  threading::parallel_for(dst_edges.index_range(), 512, [&](const IndexRange range) {
+  threading::parallel_for(bm_edges.index_range(), 512, [&](const IndexRange range) {
     bool any_loose_edge_local = false;
+    if (!dst_edges.is_empty()) {
+      for (const int edge_i : range) {
+        const BMEdge &src_edge = *bm_edges[edge_i];
+        dst_edges[edge_i] = int2(BM_elem_index_get(src_edge.v1), BM_elem_index_get(src_edge.v2));
+      }
+    }
     for (const int edge_i : range) {
       const BMEdge &src_edge = *bm_edges[edge_i];
-      dst_edges[edge_i] = int2(BM_elem_index_get(src_edge.v1), BM_elem_index_get(src_edge.v2));
       bmesh_block_copy_to_mesh_attributes(info, edge_i, src_edge.head.data);
       any_loose_edge_local |= BM_edge_is_wire(&src_edge);
     }
@@ -1345,20 +1423,27 @@ static void bm_to_mesh_edges(const BMesh &bm,
 
 static void bm_to_mesh_faces(const BMesh &bm,
                              const Span<const BMFace *> bm_faces,
+                             const bool write_topology,
                              Mesh &mesh,
                              MutableSpan<bool> select_poly,
                              MutableSpan<bool> hide_poly,
                              MutableSpan<bool> sharp_faces,
                              MutableSpan<int> material_indices)
 {
-  BKE_mesh_face_offsets_ensure_alloc(&mesh);
+  MutableSpan<int> dst_face_offsets;
+  if (write_topology) {
+    BKE_mesh_face_offsets_ensure_alloc(&mesh);
+    dst_face_offsets = mesh.face_offsets_for_write();
+  }
   const Vector<BMeshToMeshLayerInfo> info = bm_to_mesh_copy_info_calc(bm.pdata, mesh.face_data);
-  MutableSpan<int> dst_face_offsets = mesh.face_offsets_for_write();
   threading::parallel_for(bm_faces.index_range(), 1024, [&](const IndexRange range) {
+    if (!dst_face_offsets.is_empty()) {
+      for (const int face_i : range) {
+        dst_face_offsets[face_i] = BM_elem_index_get(BM_FACE_FIRST_LOOP(bm_faces[face_i]));
+      }
+    }
     for (const int face_i : range) {
-      const BMFace &src_face = *bm_faces[face_i];
-      dst_face_offsets[face_i] = BM_elem_index_get(BM_FACE_FIRST_LOOP(&src_face));
-      bmesh_block_copy_to_mesh_attributes(info, face_i, src_face.head.data);
+      bmesh_block_copy_to_mesh_attributes(info, face_i, bm_faces[face_i]->head.data);
     }
     if (!select_poly.is_empty()) {
       for (const int face_i : range) {
@@ -1383,27 +1468,196 @@ static void bm_to_mesh_faces(const BMesh &bm,
   });
 }
 
-static void bm_to_mesh_loops(const BMesh &bm, const Span<const BMLoop *> bm_loops, Mesh &mesh)
+static void bm_to_mesh_loops(const BMesh &bm,
+                             const Span<const BMLoop *> bm_loops,
+                             const bool write_topology,
+                             Mesh &mesh)
 {
-  CustomData_free_layer_named(&mesh.corner_data, ".corner_vert", mesh.corners_num);
-  CustomData_free_layer_named(&mesh.corner_data, ".corner_edge", mesh.corners_num);
-  CustomData_add_layer_named(
-      &mesh.corner_data, CD_PROP_INT32, CD_CONSTRUCT, mesh.corners_num, ".corner_vert");
-  CustomData_add_layer_named(
-      &mesh.corner_data, CD_PROP_INT32, CD_CONSTRUCT, mesh.corners_num, ".corner_edge");
+  MutableSpan<int> dst_corner_verts;
+  MutableSpan<int> dst_corner_edges;
+  if (write_topology) {
+    CustomData_free_layer_named(&mesh.corner_data, ".corner_vert", mesh.corners_num);
+    CustomData_free_layer_named(&mesh.corner_data, ".corner_edge", mesh.corners_num);
+    CustomData_add_layer_named(
+        &mesh.corner_data, CD_PROP_INT32, CD_CONSTRUCT, mesh.corners_num, ".corner_vert");
+    CustomData_add_layer_named(
+        &mesh.corner_data, CD_PROP_INT32, CD_CONSTRUCT, mesh.corners_num, ".corner_edge");
+    dst_corner_verts = mesh.corner_verts_for_write();
+    dst_corner_edges = mesh.corner_edges_for_write();
+  }
   const Vector<BMeshToMeshLayerInfo> info = bm_to_mesh_copy_info_calc(bm.ldata, mesh.corner_data);
-  MutableSpan<int> dst_corner_verts = mesh.corner_verts_for_write();
-  MutableSpan<int> dst_corner_edges = mesh.corner_edges_for_write();
-  threading::parallel_for(dst_corner_verts.index_range(), 1024, [&](const IndexRange range) {
+  threading::parallel_for(bm_loops.index_range(), 1024, [&](const IndexRange range) {
+    if (!dst_corner_verts.is_empty()) {
+      for (const int loop_i : range) {
+        const BMLoop &src_loop = *bm_loops[loop_i];
+        dst_corner_verts[loop_i] = BM_elem_index_get(src_loop.v);
+        dst_corner_edges[loop_i] = BM_elem_index_get(src_loop.e);
+      }
+    }
     for (const int loop_i : range) {
-      const BMLoop &src_loop = *bm_loops[loop_i];
-      dst_corner_verts[loop_i] = BM_elem_index_get(src_loop.v);
-      dst_corner_edges[loop_i] = BM_elem_index_get(src_loop.e);
-      bmesh_block_copy_to_mesh_attributes(info, loop_i, src_loop.head.data);
+      bmesh_block_copy_to_mesh_attributes(info, loop_i, bm_loops[loop_i]->head.data);
     }
   });
 }
 
+/**
+ * The topology arrays of a mesh, kept alive while its geometry is cleared so they can be reused
+ * when the BMesh topology didn't change.
+ */
+struct MeshTopologyArrays {
+  void *edges = nullptr;
+  const ImplicitSharingInfo *edges_sharing_info = nullptr;
+  void *corner_verts = nullptr;
+  const ImplicitSharingInfo *corner_verts_sharing_info = nullptr;
+  void *corner_edges = nullptr;
+  const ImplicitSharingInfo *corner_edges_sharing_info = nullptr;
+  int *face_offsets = nullptr;
+  const ImplicitSharingInfo *face_offsets_sharing_info = nullptr;
+};
+
+static bool mesh_layer_share(const CustomData &data,
+                             const eCustomDataType type,
+                             const StringRef name,
+                             void **r_data,
+                             const ImplicitSharingInfo **r_sharing_info)
+{
+  const int layer_index = CustomData_get_named_layer_index(&data, type, name);
+  if (layer_index == -1 || data.layers[layer_index].sharing_info == nullptr) {
+    return false;
+  }
+  const CustomDataLayer &layer = data.layers[layer_index];
+  implicit_sharing::copy_shared_pointer(layer.data, layer.sharing_info, r_data, r_sharing_info);
+  return true;
+}
+
+/**
+ * Check whether the BMesh still has the mesh's topology, with the same element order. Entering and
+ * exiting edit mode without topology changes (moving vertices, painting attributes, changing the
+ * selection) is very common. In that case the existing arrays and the caches derived from them
+ * can be kept. The BMesh element indices must be up to date.
+ */
+static bool bm_topology_matches_mesh(const BMesh &bm,
+                                     const Mesh &mesh,
+                                     const Span<const BMEdge *> bm_edges,
+                                     const Span<const BMFace *> bm_faces,
+                                     const Span<const BMLoop *> bm_loops)
+{
+  if (mesh.verts_num != bm.totvert || mesh.edges_num != bm.totedge ||
+      mesh.faces_num != bm.totface || mesh.corners_num != bm.totloop)
+  {
+    return false;
+  }
+  if (mesh.faces_num > 0 && mesh.runtime->face_offsets_sharing_info == nullptr) {
+    return false;
+  }
+
+  const Span<int2> edges = mesh.edges();
+  const Span<int> face_offsets = mesh.face_offsets();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int> corner_edges = mesh.corner_edges();
+
+  std::atomic<bool> changed = false;
+  threading::parallel_invoke(
+      (bm.totface + bm.totedge) > 1024,
+      [&]() {
+        threading::parallel_for(bm_edges.index_range(), 4096, [&](const IndexRange range) {
+          for (const int edge_i : range) {
+            const BMEdge &edge = *bm_edges[edge_i];
+            if (edges[edge_i] != int2(BM_elem_index_get(edge.v1), BM_elem_index_get(edge.v2))) {
+              changed.store(true, std::memory_order_relaxed);
+              return;
+            }
+          }
+        });
+      },
+      [&]() {
+        threading::parallel_for(bm_faces.index_range(), 4096, [&](const IndexRange range) {
+          for (const int face_i : range) {
+            if (face_offsets[face_i] != BM_elem_index_get(BM_FACE_FIRST_LOOP(bm_faces[face_i]))) {
+              changed.store(true, std::memory_order_relaxed);
+              return;
+            }
+          }
+        });
+      },
+      [&]() {
+        threading::parallel_for(bm_loops.index_range(), 4096, [&](const IndexRange range) {
+          for (const int loop_i : range) {
+            const BMLoop &loop = *bm_loops[loop_i];
+            if (corner_verts[loop_i] != BM_elem_index_get(loop.v) ||
+                corner_edges[loop_i] != BM_elem_index_get(loop.e))
+            {
+              changed.store(true, std::memory_order_relaxed);
+              return;
+            }
+          }
+        });
+      });
+  return !changed;
+}
+
+static bool mesh_topology_share(const Mesh &mesh, MeshTopologyArrays &topology)
+{
+  if (!mesh_layer_share(mesh.edge_data,
+                        CD_PROP_INT32_2D,
+                        ".edge_verts",
+                        &topology.edges,
+                        &topology.edges_sharing_info) ||
+      !mesh_layer_share(mesh.corner_data,
+                        CD_PROP_INT32,
+                        ".corner_vert",
+                        &topology.corner_verts,
+                        &topology.corner_verts_sharing_info) ||
+      !mesh_layer_share(mesh.corner_data,
+                        CD_PROP_INT32,
+                        ".corner_edge",
+                        &topology.corner_edges,
+                        &topology.corner_edges_sharing_info))
+  {
+    implicit_sharing::free_shared_data(&topology.edges, &topology.edges_sharing_info);
+    implicit_sharing::free_shared_data(&topology.corner_verts,
+                                       &topology.corner_verts_sharing_info);
+    return false;
+  }
+  implicit_sharing::copy_shared_pointer(mesh.face_offset_indices,
+                                        mesh.runtime->face_offsets_sharing_info,
+                                        &topology.face_offsets,
+                                        &topology.face_offsets_sharing_info);
+  return true;
+}
+
+/** Add the kept topology arrays back to the mesh, after the attribute layout was initialized. */
+static void mesh_topology_restore(Mesh &mesh, MeshTopologyArrays &topology)
+{
+  CustomData_add_layer_named_with_data(&mesh.edge_data,
+                                       CD_PROP_INT32_2D,
+                                       topology.edges,
+                                       mesh.edges_num,
+                                       ".edge_verts",
+                                       topology.edges_sharing_info);
+  CustomData_add_layer_named_with_data(&mesh.corner_data,
+                                       CD_PROP_INT32,
+                                       topology.corner_verts,
+                                       mesh.corners_num,
+                                       ".corner_vert",
+                                       topology.corner_verts_sharing_info);
+  CustomData_add_layer_named_with_data(&mesh.corner_data,
+                                       CD_PROP_INT32,
+                                       topology.corner_edges,
+                                       mesh.corners_num,
+                                       ".corner_edge",
+                                       topology.corner_edges_sharing_info);
+  implicit_sharing::free_shared_data(&topology.edges, &topology.edges_sharing_info);
+  implicit_sharing::free_shared_data(&topology.corner_verts, &topology.corner_verts_sharing_info);
+  implicit_sharing::free_shared_data(&topology.corner_edges, &topology.corner_edges_sharing_info);
+
+  /* Transfer the user added by #mesh_topology_share. */
+  mesh.face_offset_indices = topology.face_offsets;
+  mesh.runtime->face_offsets_sharing_info = topology.face_offsets_sharing_info;
+  topology.face_offsets = nullptr;
+  topology.face_offsets_sharing_info = nullptr;
+}
+
 }  // namespace blender
 
 void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParams *params)
@@ -1411,15 +1665,6 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
   using namespace blender;
   const int old_verts_num = mesh->verts_num;
 
-  BKE_mesh_clear_geometry(mesh);
-
-  mesh->verts_num = bm->totvert;
-  mesh->edges_num = bm->totedge;
-  mesh->totface_legacy = 0;
-  mesh->corners_num = bm->totloop;
-  mesh->faces_num = bm->totface;
-  mesh->act_face = -1;
-
   bool need_select_vert = false;
   bool need_select_edge = false;
   bool need_select_poly = false;
@@ -1436,7 +1681,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
   Array<const BMLoop *> loop_table;
   Vector<int> loop_layers_not_to_copy;
   threading::parallel_invoke(
-      (mesh->faces_num + mesh->edges_num) > 1024,
+      (bm->totface + bm->totedge) > 1024,
       [&]() {
         vert_table.reinitialize(bm->totvert);
         bm_vert_table_build(*bm, vert_table, need_select_vert, need_hide_vert);
@@ -1463,6 +1708,26 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
       });
   bm->elem_index_dirty &= ~(BM_VERT | BM_EDGE | BM_FACE | BM_LOOP);
 
+  /* When the topology is unchanged, only the attributes have to be written. The topology arrays
+   * are shared with the old mesh and the caches that only depend on them stay valid. */
+  MeshTopologyArrays topology;
+  const bool keep_topology = bm_topology_matches_mesh(
+                                 *bm, *mesh, edge_table, face_table, loop_table) &&
+                             mesh_topology_share(*mesh, topology);
+  if (keep_topology) {
+    BKE_mesh_clear_geometry_keep_topology_caches(mesh);
+  }
+  else {
+    BKE_mesh_clear_geometry(mesh);
+  }
+
+  mesh->verts_num = bm->totvert;
+  mesh->edges_num = bm->totedge;
+  mesh->totface_legacy = 0;
+  mesh->corners_num = bm->totloop;
+  mesh->faces_num = bm->totface;
+  mesh->act_face = -1;
+
   {
     CustomData_MeshMasks mask = CD_MASK_MESH;
     CustomData_MeshMasks_update(&mask, &params->cd_mask_extra);
@@ -1476,6 +1741,10 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
         &bm->pdata, &mesh->face_data, mask.pmask, CD_CONSTRUCT, mesh->faces_num);
   }
 
+  if (keep_topology) {
+    mesh_topology_restore(*mesh, topology);
+  }
+
   /* Add optional mesh attributes before parallel iteration. */
   assert_bmesh_has_no_mesh_only_attributes(*bm);
   bke::MutableAttributeAccessor attrs = mesh->attributes_for_write();
@@ -1534,6 +1803,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
       [&]() {
         bm_to_mesh_edges(*bm,
                          edge_table,
+                         !keep_topology,
                          *mesh,
                          select_edge.span,
                          hide_edge.span,
@@ -1543,6 +1813,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
       [&]() {
         bm_to_mesh_faces(*bm,
                          face_table,
+                         !keep_topology,
                          *mesh,
                          select_poly.span,
                          hide_poly.span,
@@ -1553,7 +1824,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *mesh, const BMeshToMeshParam
         }
       },
       [&]() {
-        bm_to_mesh_loops(*bm, loop_table, *mesh);
+        bm_to_mesh_loops(*bm, loop_table, !keep_topology, *mesh);
         /* Topology could be changed, ensure #CD_MDISPS are ok. */
         multires_topology_changed(mesh);
         for (const int i : loop_layers_not_to_copy) {
@@ -1757,6 +2028,7 @@ void BM_mesh_bm_to_me_compact(BMesh &bm,
       [&]() {
         bm_to_mesh_edges(bm,
                          edge_table,
+                         true,
                          mesh,
                          select_edge.span,
                          hide_edge.span,
@@ -1766,6 +2038,7 @@ void BM_mesh_bm_to_me_compact(BMesh &bm,
       [&]() {
         bm_to_mesh_faces(bm,
                          face_table,
+                         true,
                          mesh,
                          select_poly.span,
                          hide_poly.span,
@@ -1776,7 +2049,7 @@ void BM_mesh_bm_to_me_compact(BMesh &bm,
         }
       },
       [&]() {
-        bm_to_mesh_loops(bm, loop_table, mesh);
+        bm_to_mesh_loops(bm, loop_table, true, mesh);
         for (const int i : loop_layers_not_to_copy) {
           bm.ldata.layers[i].flag &= ~CD_FLAG_NOCOPY;
         }
@@ -37,10 +37,15 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_bitmap.h"
+#include "BLI_task.hh"
 
 #include "bmesh.hh"
 
+using blender::Array;
+using blender::IndexRange;
+
 /**
  * Grow by 1.5x (rounding up).
  *
@@ -59,6 +64,38 @@
     GROW_ARRAY(mem, len_alloc); \
   }
 
+/**
+ * Add all faces that pass `face_test` to `bmpinfo`, testing the faces in parallel.
+ *
+ * \return The total number of loops of the added faces.
+ */
+template<typename FaceTestFn>
+static int partial_elem_faces_collect(BMesh *bm,
+                                      BMPartialUpdate *bmpinfo,
+                                      const FaceTestFn &face_test)
+{
+  BM_mesh_elem_index_ensure(bm, BM_FACE);
+  BM_mesh_elem_table_ensure(bm, BM_FACE);
+
+  Array<bool> faces_tag(bm->totface);
+  blender::threading::parallel_for(IndexRange(bm->totface), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      faces_tag[i] = face_test(BM_face_at_index(bm, i));
+    }
+  });
+
+  int face_tag_loop_len = 0;
+  for (const int i : faces_tag.index_range()) {
+    if (faces_tag[i]) {
+      BMFace *f = BM_face_at_index(bm, i);
+      GROW_ARRAY_AS_NEEDED(bmpinfo->faces, bmpinfo->faces_len_alloc, bmpinfo->faces_len);
+      bmpinfo->faces[bmpinfo->faces_len++] = f;
+      face_tag_loop_len += f->len;
+    }
+  }
+  return face_tag_loop_len;
+}
+
 BLI_INLINE bool partial_elem_vert_ensure(BMPartialUpdate *bmpinfo,
                                          BLI_bitmap *verts_tag,
                                          BMVert *v)
@@ -73,18 +110,42 @@ BLI_INLINE bool partial_elem_vert_ensure(BMPartialUpdate *bmpinfo,
   return false;
 }
 
-BLI_INLINE bool partial_elem_face_ensure(BMPartialUpdate *bmpinfo,
-                                         BLI_bitmap *faces_tag,
-                                         BMFace *f)
+/**
+ * Add all vertices used by the faces of `bmpinfo`. When fewer than `verts_test_count` vertices
+ * were added, also add the loose vertices that pass `vert_loose_test`.
+ */
+template<typename VertTestFn>
+static void partial_elem_verts_collect(BMesh *bm,
+                                       BMPartialUpdate *bmpinfo,
+                                       const int verts_test_count,
+                                       const VertTestFn &vert_loose_test)
 {
-  const int i = BM_elem_index_get(f);
-  if (!BLI_BITMAP_TEST(faces_tag, i)) {
-    BLI_BITMAP_ENABLE(faces_tag, i);
-    GROW_ARRAY_AS_NEEDED(bmpinfo->faces, bmpinfo->faces_len_alloc, bmpinfo->faces_len);
-    bmpinfo->faces[bmpinfo->faces_len++] = f;
-    return true;
+  /* Allocate tags instead of using #BM_ELEM_TAG because the caller may already be using tags.
+   * Further, walking over all geometry to clear the tags isn't so efficient. */
+  BLI_bitmap *verts_tag = BLI_BITMAP_NEW(size_t(bm->totvert), __func__);
+
+  for (int i = 0; i < bmpinfo->faces_len; i++) {
+    BMFace *f = bmpinfo->faces[i];
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      partial_elem_vert_ensure(bmpinfo, verts_tag, l_iter->v);
+    } while ((l_iter = l_iter->next) != l_first);
   }
-  return false;
+
+  /* Loose vertex support, these need special handling as loose normals depend on location. */
+  if (bmpinfo->verts_len < verts_test_count) {
+    BMVert *v;
+    BMIter iter;
+    int i;
+    BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+      if (vert_loose_test(i) && (BM_vert_find_first_loop(v) == nullptr)) {
+        partial_elem_vert_ensure(bmpinfo, verts_tag, v);
+      }
+    }
+  }
+
+  MEM_freeN(verts_tag);
 }
 
 BMPartialUpdate *BM_mesh_partial_create_from_verts(BMesh *bm,
@@ -103,13 +164,7 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts(BMesh *bm,
   const int default_verts_len_alloc = verts_mask_count;
   const int default_faces_len_alloc = min_ii(bm->totface, verts_mask_count);
 
-  /* Allocate tags instead of using #BM_ELEM_TAG because the caller may already be using tags.
-   * Further, walking over all geometry to clear the tags isn't so efficient. */
-  BLI_bitmap *verts_tag = nullptr;
-  BLI_bitmap *faces_tag = nullptr;
-
-  /* Set vert inline. */
-  BM_mesh_elem_index_ensure(bm, BM_FACE);
+  BM_mesh_elem_index_ensure(bm, BM_VERT);
 
   if (params->do_normals || params->do_tessellate) {
     /* - Extend to all vertices connected faces:
@@ -126,39 +181,23 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts(BMesh *bm,
      */
 
     /* Faces. */
-    if (bmpinfo->faces == nullptr) {
-      bmpinfo->faces_len_alloc = default_faces_len_alloc;
-      bmpinfo->faces = static_cast<BMFace **>(
-          MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
-      faces_tag = BLI_BITMAP_NEW(size_t(bm->totface), __func__);
-    }
-
-    BMVert *v;
-    BMIter iter;
-    int i;
-    BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
-      BM_elem_index_set(v, i); /* set_inline */
-      if (!BLI_BITMAP_TEST(verts_mask, i)) {
-        continue;
-      }
-      BMEdge *e_iter = v->e;
-      if (e_iter != nullptr) {
-        /* Loop over edges. */
-        BMEdge *e_first = v->e;
-        do {
-          BMLoop *l_iter = e_iter->l;
-          if (e_iter->l != nullptr) {
-            BMLoop *l_first = e_iter->l;
-            /* Loop over radial loops. */
-            do {
-              if (l_iter->v == v) {
-                partial_elem_face_ensure(bmpinfo, faces_tag, l_iter->f);
-              }
-            } while ((l_iter = l_iter->radial_next) != l_first);
-          }
-        } while ((e_iter = BM_DISK_EDGE_NEXT(e_iter, v)) != e_first);
-      }
-    }
+    bmpinfo->faces_len_alloc = max_ii(1, default_faces_len_alloc);
+    bmpinfo->faces = static_cast<BMFace **>(
+        MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
+
+    partial_elem_faces_collect(
+        bm,
+        bmpinfo,
+        [&](BMFace *f) {
+          BMLoop *l_iter, *l_first;
+          l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+          do {
+            if (BLI_BITMAP_TEST(verts_mask, BM_elem_index_get(l_iter->v))) {
+              return true;
+            }
+          } while ((l_iter = l_iter->next) != l_first);
+          return false;
+        });
   }
 
   if (params->do_normals) {
@@ -170,28 +209,12 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts(BMesh *bm,
      */
 
     /* Vertices. */
-    if (bmpinfo->verts == nullptr) {
-      bmpinfo->verts_len_alloc = default_verts_len_alloc;
-      bmpinfo->verts = static_cast<BMVert **>(
-          MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
-      verts_tag = BLI_BITMAP_NEW(size_t(bm->totvert), __func__);
-    }
+    bmpinfo->verts_len_alloc = max_ii(1, default_verts_len_alloc);
+    bmpinfo->verts = static_cast<BMVert **>(
+        MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
 
-    for (int i = 0; i < bmpinfo->faces_len; i++) {
-      BMFace *f = bmpinfo->faces[i];
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-      do {
-        partial_elem_vert_ensure(bmpinfo, verts_tag, l_iter->v);
-      } while ((l_iter = l_iter->next) != l_first);
-    }
-  }
-
-  if (verts_tag) {
-    MEM_freeN(verts_tag);
-  }
-  if (faces_tag) {
-    MEM_freeN(faces_tag);
+    /* Loose vertices don't need updating here. */
+    partial_elem_verts_collect(bm, bmpinfo, 0, [](const int /*i*/) { return false; });
   }
 
   bmpinfo->params = *params;
@@ -208,9 +231,6 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_single(
   BMPartialUpdate *bmpinfo = static_cast<BMPartialUpdate *>(
       MEM_callocN(sizeof(*bmpinfo), __func__));
 
-  BLI_bitmap *verts_tag = nullptr;
-  BLI_bitmap *faces_tag = nullptr;
-
   /* It's not worth guessing a large number as isolated regions will allocate zero faces. */
   const int default_faces_len_alloc = 1;
 
@@ -219,31 +239,26 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_single(
   if (params->do_normals || params->do_tessellate) {
 
     /* Faces. */
-    if (bmpinfo->faces == nullptr) {
-      bmpinfo->faces_len_alloc = default_faces_len_alloc;
-      bmpinfo->faces = static_cast<BMFace **>(
-          MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
-      faces_tag = BLI_BITMAP_NEW(size_t(bm->totface), __func__);
-    }
-
-    BMFace *f;
-    BMIter iter;
-    int i;
-    BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
-      enum Side { SIDE_A = (1 << 0), SIDE_B = (1 << 1) } side_flag = Side(0);
-      BM_elem_index_set(f, i); /* set_inline */
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-      do {
-        const int j = BM_elem_index_get(l_iter->v);
-        side_flag = Side(side_flag | (BLI_BITMAP_TEST(verts_mask, j) ? SIDE_A : SIDE_B));
-        if (UNLIKELY(side_flag == (SIDE_A | SIDE_B))) {
-          partial_elem_face_ensure(bmpinfo, faces_tag, f);
-          face_tag_loop_len += f->len;
-          break;
-        }
-      } while ((l_iter = l_iter->next) != l_first);
-    }
+    bmpinfo->faces_len_alloc = default_faces_len_alloc;
+    bmpinfo->faces = static_cast<BMFace **>(
+        MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
+
+    face_tag_loop_len = partial_elem_faces_collect(
+        bm,
+        bmpinfo,
+        [&](BMFace *f) {
+          enum Side { SIDE_A = (1 << 0), SIDE_B = (1 << 1) } side_flag = Side(0);
+          BMLoop *l_iter, *l_first;
+          l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+          do {
+            const int j = BM_elem_index_get(l_iter->v);
+            side_flag = Side(side_flag | (BLI_BITMAP_TEST(verts_mask, j) ? SIDE_A : SIDE_B));
+            if (UNLIKELY(side_flag == (SIDE_A | SIDE_B))) {
+              return true;
+            }
+          } while ((l_iter = l_iter->next) != l_first);
+          return false;
+        });
   }
 
   if (params->do_normals) {
@@ -254,40 +269,13 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_single(
     const int default_verts_len_alloc = min_ii(bm->totvert, max_ii(1, face_tag_loop_len));
 
     /* Vertices. */
-    if (bmpinfo->verts == nullptr) {
-      bmpinfo->verts_len_alloc = default_verts_len_alloc;
-      bmpinfo->verts = static_cast<BMVert **>(
-          MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
-      verts_tag = BLI_BITMAP_NEW(size_t(bm->totvert), __func__);
-    }
-
-    for (int i = 0; i < bmpinfo->faces_len; i++) {
-      BMFace *f = bmpinfo->faces[i];
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-      do {
-        partial_elem_vert_ensure(bmpinfo, verts_tag, l_iter->v);
-      } while ((l_iter = l_iter->next) != l_first);
-    }
+    bmpinfo->verts_len_alloc = default_verts_len_alloc;
+    bmpinfo->verts = static_cast<BMVert **>(
+        MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
 
-    /* Loose vertex support, these need special handling as loose normals depend on location. */
-    if (bmpinfo->verts_len < verts_mask_count) {
-      BMVert *v;
-      BMIter iter;
-      int i;
-      BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
-        if (BLI_BITMAP_TEST(verts_mask, i) && (BM_vert_find_first_loop(v) == nullptr)) {
-          partial_elem_vert_ensure(bmpinfo, verts_tag, v);
-        }
-      }
-    }
-  }
-
-  if (verts_tag) {
-    MEM_freeN(verts_tag);
-  }
-  if (faces_tag) {
-    MEM_freeN(faces_tag);
+    partial_elem_verts_collect(bm, bmpinfo, verts_mask_count, [&](const int i) {
+      return BLI_BITMAP_TEST_BOOL(verts_mask, i);
+    });
   }
 
   bmpinfo->params = *params;
@@ -307,9 +295,6 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_multi(
   BMPartialUpdate *bmpinfo = static_cast<BMPartialUpdate *>(
       MEM_callocN(sizeof(*bmpinfo), __func__));
 
-  BLI_bitmap *verts_tag = nullptr;
-  BLI_bitmap *faces_tag = nullptr;
-
   /* It's not worth guessing a large number as isolated regions will allocate zero faces. */
   const int default_faces_len_alloc = 1;
 
@@ -318,36 +303,31 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_multi(
   if (params->do_normals || params->do_tessellate) {
 
     /* Faces. */
-    if (bmpinfo->faces == nullptr) {
-      bmpinfo->faces_len_alloc = default_faces_len_alloc;
-      bmpinfo->faces = static_cast<BMFace **>(
-          MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
-      faces_tag = BLI_BITMAP_NEW(size_t(bm->totface), __func__);
-    }
-
-    BMFace *f;
-    BMIter iter;
-    int i;
-    BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
-      BM_elem_index_set(f, i); /* set_inline */
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-      const int group_test = verts_group[BM_elem_index_get(l_iter->prev->v)];
+    bmpinfo->faces_len_alloc = default_faces_len_alloc;
+    bmpinfo->faces = static_cast<BMFace **>(
+        MEM_mallocN((sizeof(BMFace *) * bmpinfo->faces_len_alloc), __func__));
+
+    face_tag_loop_len = partial_elem_faces_collect(
+        bm,
+        bmpinfo,
+        [&](BMFace *f) {
+          BMLoop *l_iter, *l_first;
+          l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+          const int group_test = verts_group[BM_elem_index_get(l_iter->prev->v)];
 #ifdef DEBUG_MATERIAL
-      f->mat_nr = 0;
+          f->mat_nr = 0;
 #endif
-      do {
-        const int group_iter = verts_group[BM_elem_index_get(l_iter->v)];
-        if (UNLIKELY((group_iter != group_test) || (group_iter == -1))) {
-          partial_elem_face_ensure(bmpinfo, faces_tag, f);
-          face_tag_loop_len += f->len;
+          do {
+            const int group_iter = verts_group[BM_elem_index_get(l_iter->v)];
+            if (UNLIKELY((group_iter != group_test) || (group_iter == -1))) {
 #ifdef DEBUG_MATERIAL
-          f->mat_nr = 1;
+              f->mat_nr = 1;
 #endif
-          break;
-        }
-      } while ((l_iter = l_iter->next) != l_first);
-    }
+              return true;
+            }
+          } while ((l_iter = l_iter->next) != l_first);
+          return false;
+        });
   }
 
   if (params->do_normals) {
@@ -358,40 +338,12 @@ BMPartialUpdate *BM_mesh_partial_create_from_verts_group_multi(
     const int default_verts_len_alloc = min_ii(bm->totvert, max_ii(1, face_tag_loop_len));
 
     /* Vertices. */
-    if (bmpinfo->verts == nullptr) {
-      bmpinfo->verts_len_alloc = default_verts_len_alloc;
-      bmpinfo->verts = static_cast<BMVert **>(
-          MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
-      verts_tag = BLI_BITMAP_NEW(size_t(bm->totvert), __func__);
-    }
+    bmpinfo->verts_len_alloc = default_verts_len_alloc;
+    bmpinfo->verts = static_cast<BMVert **>(
+        MEM_mallocN((sizeof(BMVert *) * bmpinfo->verts_len_alloc), __func__));
 
-    for (int i = 0; i < bmpinfo->faces_len; i++) {
-      BMFace *f = bmpinfo->faces[i];
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-      do {
-        partial_elem_vert_ensure(bmpinfo, verts_tag, l_iter->v);
-      } while ((l_iter = l_iter->next) != l_first);
-    }
-
-    /* Loose vertex support, these need special handling as loose normals depend on location. */
-    if (bmpinfo->verts_len < verts_group_count) {
-      BMVert *v;
-      BMIter iter;
-      int i;
-      BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
-        if ((verts_group[i] != 0) && (BM_vert_find_first_loop(v) == nullptr)) {
-          partial_elem_vert_ensure(bmpinfo, verts_tag, v);
-        }
-      }
-    }
-  }
-
-  if (verts_tag) {
-    MEM_freeN(verts_tag);
-  }
-  if (faces_tag) {
-    MEM_freeN(faces_tag);
+    partial_elem_verts_collect(
+        bm, bmpinfo, verts_group_count, [&](const int i) { return verts_group[i] != 0; });
   }
 
   bmpinfo->params = *params;
@@ -12,10 +12,12 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
+#include "BLI_array.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
 #include "BLI_memarena.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines_stack.h"
 
 #include "BKE_customdata.hh"
@@ -87,6 +89,35 @@ static void bm_interp_face_store(InterpFace *iface, BMesh *bm, BMFace *f, MemAre
   } while ((void)i++, (l_iter = l_iter->next) != l_first);
   bm->elem_index_dirty |= BM_LOOP;
 }
+
+/**
+ * Interpolate the face's loops from the stored data, a clone of #BM_face_interp_from_face_ex.
+ * Vertices are shared between faces, so they are only interpolated when \a vert_faces maps them
+ * to this face. That allows calling this for multiple faces in parallel.
+ */
+static void bm_interp_face_apply(BMesh *bm,
+                                 const InterpFace *iface,
+                                 const int face_index,
+                                 const blender::Span<int> vert_faces)
+{
+  BMFace *f = iface->f;
+  float *w = static_cast<float *>(BLI_array_alloca(w, f->len));
+  float co[2];
+
+  BMLoop *l_iter, *l_first;
+  l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+  do {
+    mul_v2_m3v3(co, iface->axis_mat, l_iter->v->co);
+    interp_weights_poly_v2(w, iface->cos_2d, f->len, co);
+    CustomData_bmesh_interp(
+        &bm->ldata, (const void **)iface->blocks_l, w, nullptr, f->len, l_iter->head.data);
+    if (vert_faces[BM_elem_index_get(l_iter->v)] == face_index) {
+      CustomData_bmesh_interp(
+          &bm->vdata, (const void **)iface->blocks_v, w, nullptr, f->len, l_iter->v->head.data);
+    }
+  } while ((l_iter = l_iter->next) != l_first);
+}
+
 static void bm_interp_face_free(InterpFace *iface, BMesh *bm)
 {
   void **blocks_l = iface->blocks_l;
@@ -1138,19 +1169,27 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
   }
 
   if (use_interpolate) {
+    /* Faces are interpolated in parallel. A vertex used by multiple faces is interpolated by the
+     * last of them, matching the result of interpolating the faces in order. */
+    BM_mesh_elem_index_ensure(bm, BM_VERT);
+    blender::Array<int> vert_faces(bm->totvert, -1);
     for (i = 0; i < iface_array_len; i++) {
       if (iface_array[i]) {
-        InterpFace *iface = iface_array[i];
-        BM_face_interp_from_face_ex(bm,
-                                    iface->f,
-                                    iface->f,
-                                    true,
-                                    (const void **)iface->blocks_l,
-                                    (const void **)iface->blocks_v,
-                                    iface->cos_2d,
-                                    iface->axis_mat);
+        BMLoop *l_iter, *l_first;
+        l_iter = l_first = BM_FACE_FIRST_LOOP(iface_array[i]->f);
+        do {
+          vert_faces[BM_elem_index_get(l_iter->v)] = i;
+        } while ((l_iter = l_iter->next) != l_first);
       }
     }
+    blender::threading::parallel_for(
+        blender::IndexRange(iface_array_len), 256, [&](const blender::IndexRange range) {
+          for (const int face_i : range) {
+            if (iface_array[face_i]) {
+              bm_interp_face_apply(bm, iface_array[face_i], face_i, vert_faces);
+            }
+          }
+        });
   }
 
   /* create faces */
@@ -1359,20 +1398,36 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
     varr_co = static_cast<float(*)[3]>(MEM_callocN(sizeof(*varr_co) * bm->totvert, __func__));
     void *vert_lengths_p = nullptr;
 
-    BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
-      if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-        const float fac =
-            depth *
-            (use_relative_offset ?
-                 bm_edge_info_average_length_with_fallback(
-                     v,
-                     edge_info,
-                     /* Variables needed for filling interior values for vertex lengths. */
-                     bm,
-                     &vert_lengths_p) :
-                 1.0f) *
-            (use_even_boundary ? BM_vert_calc_shell_factor(v) : 1.0f);
-        madd_v3_v3v3fl(varr_co[i], v->co, v->no, fac);
+    if (!use_relative_offset) {
+      /* Without the relative offset, which lazily builds vertex lengths,
+       * every vertex is independent. */
+      BM_mesh_elem_table_ensure(bm, BM_VERT);
+      blender::threading::parallel_for(
+          blender::IndexRange(bm->totvert), 1024, [&](const blender::IndexRange range) {
+            for (const int vert_i : range) {
+              BMVert *v_iter = BM_vert_at_index(bm, vert_i);
+              if (BM_elem_flag_test(v_iter, BM_ELEM_TAG)) {
+                const float fac = depth *
+                                  (use_even_boundary ? BM_vert_calc_shell_factor(v_iter) : 1.0f);
+                madd_v3_v3v3fl(varr_co[vert_i], v_iter->co, v_iter->no, fac);
+              }
+            }
+          });
+    }
+    else {
+      BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+        if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
+          const float fac = depth *
+                            bm_edge_info_average_length_with_fallback(
+                                v,
+                                edge_info,
+                                /* Variables needed for filling interior values for vertex
+                                 * lengths. */
+                                bm,
+                                &vert_lengths_p) *
+                            (use_even_boundary ? BM_vert_calc_shell_factor(v) : 1.0f);
+          madd_v3_v3v3fl(varr_co[i], v->co, v->no, fac);
+        }
       }
     }
 
@@ -12,11 +12,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
 #include "BLI_noise.h"
 #include "BLI_rand.h"
 #include "BLI_stack.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "BKE_customdata.hh"
@@ -25,6 +28,8 @@
 #include "intern/bmesh_operators_private.hh"
 #include "intern/bmesh_private.hh"
 
+using blender::Array;
+using blender::IndexRange;
 using blender::Vector;
 
 struct SubDParams {
@@ -908,20 +913,188 @@ struct SubDFaceData {
   BMFace *face;
 };
 
+/**
+ * Find the pattern used to subdivide a face, based on its tagged edges.
+ * Only the face itself is modified, so this can run on multiple faces in parallel.
+ *
+ * \return true when the face will be split, filling in \a r_fd.
+ */
+static bool bm_subdivide_face_pattern_find(BMesh *bm,
+                                           BMFace *face,
+                                           const SubDParams *params,
+                                           const bool use_only_quads,
+                                           SubDFaceData *r_fd)
+{
+  Vector<BMVert *, BM_DEFAULT_ITER_STACK_SIZE> verts;
+  Vector<BMEdge *, BM_DEFAULT_ITER_STACK_SIZE> edges;
+  const SubDPattern *pat;
+  BMIter liter;
+  BMLoop *l_new;
+  BMEdge *e1 = nullptr, *e2 = nullptr;
+  float vec1[3], vec2[3];
+  bool matched = false;
+  int i, j, a, b;
+
+  /* skip non-quads if requested */
+  if (use_only_quads && face->len != 4) {
+    return false;
+  }
+
+  /* figure out which pattern to use */
+  verts.reinitialize(face->len);
+  edges.reinitialize(face->len);
+
+  int totesel = 0;
+  BM_ITER_ELEM_INDEX (l_new, &liter, face, BM_LOOPS_OF_FACE, i) {
+    edges[i] = l_new->e;
+    verts[i] = l_new->v;
+
+    if (BMO_edge_flag_test(bm, edges[i], SUBD_SPLIT)) {
+      if (!e1) {
+        e1 = edges[i];
+      }
+      else {
+        e2 = edges[i];
+      }
+
+      totesel++;
+    }
+  }
+
+  /* make sure the two edges have a valid angle to each other */
+  if (totesel == 2 && BM_edge_share_vert_check(e1, e2)) {
+    sub_v3_v3v3(vec1, e1->v2->co, e1->v1->co);
+    sub_v3_v3v3(vec2, e2->v2->co, e2->v1->co);
+    normalize_v3(vec1);
+    normalize_v3(vec2);
+
+    if (fabsf(dot_v3v3(vec1, vec2)) > 1.0f - FLT_FACE_SPLIT_EPSILON) {
+      totesel = 0;
+    }
+  }
+
+  if (BMO_face_flag_test(bm, face, FACE_CUSTOMFILL)) {
+    pat = static_cast<const SubDPattern *>(
+        *BMO_slot_map_data_get(params->slot_custom_patterns, face));
+    for (i = 0; i < pat->len; i++) {
+      matched = true;
+      for (j = 0; j < pat->len; j++) {
+        a = (j + i) % pat->len;
+        if (!!BMO_edge_flag_test(bm, edges[a], SUBD_SPLIT) != (!!pat->seledges[j])) {
+          matched = false;
+          break;
+        }
+      }
+      if (matched) {
+        r_fd->pat = pat;
+        r_fd->start = verts[i];
+        r_fd->face = face;
+        r_fd->totedgesel = totesel;
+        BMO_face_flag_enable(bm, face, SUBD_SPLIT);
+        return true;
+      }
+    }
+
+    /* Obviously don't test for other patterns matching. */
+    return false;
+  }
+
+  for (i = 0; i < PATTERNS_TOT; i++) {
+    pat = patterns[i];
+    if (!pat) {
+      continue;
+    }
+
+    if (pat->len == face->len) {
+      for (a = 0; a < pat->len; a++) {
+        matched = true;
+        for (b = 0; b < pat->len; b++) {
+          j = (b + a) % pat->len;
+          if (!!BMO_edge_flag_test(bm, edges[j], SUBD_SPLIT) != (!!pat->seledges[b])) {
+            matched = false;
+            break;
+          }
+        }
+        if (matched) {
+          break;
+        }
+      }
+      if (matched) {
+        BMO_face_flag_enable(bm, face, SUBD_SPLIT);
+
+        r_fd->pat = pat;
+        r_fd->start = verts[a];
+        r_fd->face = face;
+        r_fd->totedgesel = totesel;
+        return true;
+      }
+    }
+  }
+
+  if (!matched && totesel) {
+    BMO_face_flag_enable(bm, face, SUBD_SPLIT);
+
+    /* must initialize all members here */
+    r_fd->start = nullptr;
+    r_fd->pat = nullptr;
+    r_fd->totedgesel = totesel;
+    r_fd->face = face;
+    return true;
+  }
+  return false;
+}
+
+static void bm_subdivide_shape_tmp_store_cb(void *__restrict userdata,
+                                            MempoolIterData *mp_v,
+                                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const SubDParams *params = static_cast<const SubDParams *>(userdata);
+  BMVert *v = (BMVert *)mp_v;
+  float *co = static_cast<float *>(
+      BM_ELEM_CD_GET_VOID_P(v, params->shape_info.cd_vert_shape_offset_tmp));
+  copy_v3_v3(co, v->co);
+}
+
+static void bm_subdivide_shape_tmp_restore_cb(void *__restrict userdata,
+                                              MempoolIterData *mp_v,
+                                              const TaskParallelTLS *__restrict /*tls*/)
+{
+  const SubDParams *params = static_cast<const SubDParams *>(userdata);
+  BMVert *v = (BMVert *)mp_v;
+  const float *co = static_cast<const float *>(
+      BM_ELEM_CD_GET_VOID_P(v, params->shape_info.cd_vert_shape_offset_tmp));
+  copy_v3_v3(v->co, co);
+}
+
+/**
+ * Copy the vertex coordinates to the temporary shape-key (\a store),
+ * or back from it to the vertex coordinates.
+ */
+static void bm_subdivide_shape_tmp_copy(BMesh *bm, SubDParams *params, const bool store)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_mempool_settings_defaults(&settings);
+  settings.use_threading = bm->totvert >= BM_THREAD_LIMIT;
+  BM_iter_parallel(bm,
+                   BM_VERTS_OF_MESH,
+                   store ? bm_subdivide_shape_tmp_store_cb : bm_subdivide_shape_tmp_restore_cb,
+                   params,
+                   &settings);
+}
+
 void bmo_subdivide_edges_exec(BMesh *bm, BMOperator *op)
 {
   BMOpSlot *einput;
   const SubDPattern *pat;
   SubDParams params;
   BLI_Stack *facedata;
-  BMIter viter, fiter, liter;
-  BMVert *v;
+  BMIter liter;
   BMEdge *edge;
   BMLoop *l_new, *l;
   BMFace *face;
   float smooth, fractal, along_normal;
   bool use_sphere, use_single_edge, use_grid_fill, use_only_quads;
-  int cornertype, seed, i, j, a, b, numcuts, totesel, smooth_falloff;
+  int cornertype, seed, i, j, a, b, numcuts, smooth_falloff;
 
   BMO_slot_buffer_flag_enable(bm, op->slots_in, "edges", BM_EDGE, SUBD_SPLIT);
 
@@ -975,11 +1148,7 @@ void bmo_subdivide_edges_exec(BMesh *bm, BMOperator *op)
 
   bmo_subd_init_shape_info(bm, &params);
 
-  BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
-    float *co = static_cast<float *>(
-        BM_ELEM_CD_GET_VOID_P(v, params.shape_info.cd_vert_shape_offset_tmp));
-    copy_v3_v3(co, v->co);
-  }
+  bm_subdivide_shape_tmp_copy(bm, &params, true);
 
   /* first go through and tag edges */
   BMO_slot_buffer_from_enabled_flag(bm, op, op->slots_in, "edges", BM_EDGE, SUBD_SPLIT);
@@ -1014,127 +1183,21 @@ void bmo_subdivide_edges_exec(BMesh *bm, BMOperator *op)
 
   facedata = BLI_stack_new(sizeof(SubDFaceData), __func__);
 
-  Vector<BMVert *, BM_DEFAULT_ITER_STACK_SIZE> verts;
-  Vector<BMEdge *, BM_DEFAULT_ITER_STACK_SIZE> edges;
-
-  BM_ITER_MESH (face, &fiter, bm, BM_FACES_OF_MESH) {
-    BMEdge *e1 = nullptr, *e2 = nullptr;
-    float vec1[3], vec2[3];
-    bool matched = false;
-
-    /* skip non-quads if requested */
-    if (use_only_quads && face->len != 4) {
-      continue;
-    }
-
-    /* figure out which pattern to use */
-    verts.reinitialize(face->len);
-    edges.reinitialize(face->len);
-
-    totesel = 0;
-    BM_ITER_ELEM_INDEX (l_new, &liter, face, BM_LOOPS_OF_FACE, i) {
-      edges[i] = l_new->e;
-      verts[i] = l_new->v;
-
-      if (BMO_edge_flag_test(bm, edges[i], SUBD_SPLIT)) {
-        if (!e1) {
-          e1 = edges[i];
-        }
-        else {
-          e2 = edges[i];
-        }
-
-        totesel++;
-      }
-    }
-
-    /* make sure the two edges have a valid angle to each other */
-    if (totesel == 2 && BM_edge_share_vert_check(e1, e2)) {
-      sub_v3_v3v3(vec1, e1->v2->co, e1->v1->co);
-      sub_v3_v3v3(vec2, e2->v2->co, e2->v1->co);
-      normalize_v3(vec1);
-      normalize_v3(vec2);
-
-      if (fabsf(dot_v3v3(vec1, vec2)) > 1.0f - FLT_FACE_SPLIT_EPSILON) {
-        totesel = 0;
-      }
-    }
-
-    if (BMO_face_flag_test(bm, face, FACE_CUSTOMFILL)) {
-      pat = static_cast<const SubDPattern *>(
-          *BMO_slot_map_data_get(params.slot_custom_patterns, face));
-      for (i = 0; i < pat->len; i++) {
-        matched = true;
-        for (j = 0; j < pat->len; j++) {
-          a = (j + i) % pat->len;
-          if (!!BMO_edge_flag_test(bm, edges[a], SUBD_SPLIT) != (!!pat->seledges[j])) {
-            matched = false;
-            break;
-          }
-        }
-        if (matched) {
-          SubDFaceData *fd;
-
-          fd = static_cast<SubDFaceData *>(BLI_stack_push_r(facedata));
-          fd->pat = pat;
-          fd->start = verts[i];
-          fd->face = face;
-          fd->totedgesel = totesel;
-          BMO_face_flag_enable(bm, face, SUBD_SPLIT);
-          break;
-        }
-      }
-
-      /* Obviously don't test for other patterns matching. */
-      continue;
-    }
-
-    for (i = 0; i < PATTERNS_TOT; i++) {
-      pat = patterns[i];
-      if (!pat) {
-        continue;
-      }
-
-      if (pat->len == face->len) {
-        for (a = 0; a < pat->len; a++) {
-          matched = true;
-          for (b = 0; b < pat->len; b++) {
-            j = (b + a) % pat->len;
-            if (!!BMO_edge_flag_test(bm, edges[j], SUBD_SPLIT) != (!!pat->seledges[b])) {
-              matched = false;
-              break;
-            }
-          }
-          if (matched) {
-            break;
-          }
-        }
-        if (matched) {
-          SubDFaceData *fd;
-
-          BMO_face_flag_enable(bm, face, SUBD_SPLIT);
-
-          fd = static_cast<SubDFaceData *>(BLI_stack_push_r(facedata));
-          fd->pat = pat;
-          fd->start = verts[a];
-          fd->face = face;
-          fd->totedgesel = totesel;
-          break;
-        }
+  /* Matching the patterns only reads the mesh and tags the face itself, do it in parallel. The
+   * results are pushed in face order afterwards, so the output doesn't depend on threading. */
+  BM_mesh_elem_table_ensure(bm, BM_FACE);
+  Array<SubDFaceData> face_data(bm->totface);
+  blender::threading::parallel_for(face_data.index_range(), 512, [&](const IndexRange range) {
+    for (const int face_i : range) {
+      BMFace *face = BM_face_at_index(bm, face_i);
+      if (!bm_subdivide_face_pattern_find(bm, face, &params, use_only_quads, &face_data[face_i])) {
+        face_data[face_i].face = nullptr;
       }
     }
-
-    if (!matched && totesel) {
-      SubDFaceData *fd;
-
-      BMO_face_flag_enable(bm, face, SUBD_SPLIT);
-
-      /* must initialize all members here */
-      fd = static_cast<SubDFaceData *>(BLI_stack_push_r(facedata));
-      fd->start = nullptr;
-      fd->pat = nullptr;
-      fd->totedgesel = totesel;
-      fd->face = face;
+  });
+  for (const SubDFaceData &fd : face_data) {
+    if (fd.face) {
+      *static_cast<SubDFaceData *>(BLI_stack_push_r(facedata)) = fd;
     }
   }
 
@@ -1147,13 +1210,10 @@ void bmo_subdivide_edges_exec(BMesh *bm, BMOperator *op)
   }
 
   /* copy original-geometry displacements to current coordinates */
-  BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
-    const float *co = static_cast<const float *>(
-        BM_ELEM_CD_GET_VOID_P(v, params.shape_info.cd_vert_shape_offset_tmp));
-    copy_v3_v3(v->co, co);
-  }
+  bm_subdivide_shape_tmp_copy(bm, &params, false);
 
   using LoopPair = std::array<BMLoop *, 2>;
+  Vector<BMVert *, BM_DEFAULT_ITER_STACK_SIZE> verts;
   Vector<BMLoop *, BM_DEFAULT_ITER_STACK_SIZE> loops;
   Vector<LoopPair, BM_DEFAULT_ITER_STACK_SIZE> loops_split;
   for (; !BLI_stack_is_empty(facedata); BLI_stack_discard(facedata)) {
@@ -1291,11 +1351,7 @@ void bmo_subdivide_edges_exec(BMesh *bm, BMOperator *op)
   }
 
   /* copy original-geometry displacements to current coordinates */
-  BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
-    const float *co = static_cast<const float *>(
-        BM_ELEM_CD_GET_VOID_P(v, params.shape_info.cd_vert_shape_offset_tmp));
-    copy_v3_v3(v->co, co);
-  }
+  bm_subdivide_shape_tmp_copy(bm, &params, false);
 
   BM_data_layer_free_n(bm, &bm->vdata, CD_SHAPEKEY, params.shape_info.tmpkey);
 
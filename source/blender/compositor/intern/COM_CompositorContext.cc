@@ -25,4 +25,18 @@ Size2f CompositorContext::get_render_size() const
           get_render_data()->ysch * get_render_percentage_as_factor()};
 }
 
+MemoryBufferStorage CompositorContext::get_buffer_storage() const
+{
+  BLI_assert(rd_);
+  switch (eCompositorStorage(rd_->compositor_storage)) {
+    case SCE_COMPOSITOR_STORAGE_FULL:
+      return MemoryBufferStorage::Float;
+    case SCE_COMPOSITOR_STORAGE_HALF:
+      return MemoryBufferStorage::Half;
+    case SCE_COMPOSITOR_STORAGE_DISK:
+      return MemoryBufferStorage::Disk;
+  }
+  return MemoryBufferStorage::Float;
+}
+
 }  // namespace blender::compositor
@@ -220,6 +220,11 @@ class CompositorContext {
   }
 
   Size2f get_render_size() const;
+
+  /**
+   * \brief get how rendered buffers are stored while waiting to be read
+   */
+  MemoryBufferStorage get_buffer_storage() const;
 };
 
 }  // namespace blender::compositor
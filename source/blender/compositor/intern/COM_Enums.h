@@ -43,6 +43,20 @@ enum class PixelSampler {
 };
 void expand_area_for_sampler(rcti &area, PixelSampler sampler);
 
+/**
+ * \brief How rendered buffers are stored while they are waiting to be read by other operations.
+ * \see MemoryBuffer::pack
+ * \ingroup Execution
+ */
+enum class MemoryBufferStorage {
+  /** \brief Keep full float buffers in memory. */
+  Float = 0,
+  /** \brief Keep half float buffers in memory. */
+  Half = 1,
+  /** \brief Write half float buffers to temporary files on disk. */
+  Disk = 2,
+};
+
 std::ostream &operator<<(std::ostream &os, const eCompositorPriority &priority);
 
 }  // namespace blender::compositor
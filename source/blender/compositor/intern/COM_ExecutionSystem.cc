@@ -37,6 +37,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   context_.set_rendering(rendering);
 
   context_.set_render_data(rd);
+  active_buffers_.set_storage(context_.get_buffer_storage());
 
   BLI_mutex_init(&work_mutex_);
   BLI_condition_init(&work_finished_cond_);
@@ -0,0 +1,397 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+
+#if defined(WITH_FFTW3)
+#  include <fftw3.h>
+#endif
+
+#include "BLI_array.hh"
+#include "BLI_fftw.hh"
+#include "BLI_hash.hh"
+#include "BLI_hash_mm2a.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.h"
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_counter.hh"
+#include "BLI_rect.h"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "COM_FFTConvolution.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+/**
+ * Kernels with at least this many weights are convolved in the frequency domain. The spatial
+ * domain cost grows with the number of weights, while the frequency domain cost is a few
+ * transforms of the padded image. This is a rough estimate of where the transforms get cheaper.
+ */
+static constexpr int64_t FFT_CONVOLUTION_MIN_KERNEL_WEIGHTS = 256;
+
+bool use_fft_convolution(const int2 radius)
+{
+#if defined(WITH_FFTW3)
+  const int64_t weights_num = int64_t(radius.x * 2 + 1) * (radius.y * 2 + 1);
+  return weights_num >= FFT_CONVOLUTION_MIN_KERNEL_WEIGHTS;
+#else
+  UNUSED_VARS(radius);
+  return false;
+#endif
+}
+
+#if defined(WITH_FFTW3)
+
+/**
+ * Channels are stored one after the other in a single allocation. Pad every channel such that
+ * they are all aligned like the first one, since plans are executed on all of them but FFTW
+ * expects the same alignment as the arrays the plan was created with.
+ */
+static int64_t aligned_channel_size(const int64_t size, const int64_t element_size)
+{
+  constexpr int64_t alignment = 64;
+  return int64_t(ceil_to_multiple_ul(uint64_t(size * element_size), alignment)) / element_size;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Frequency Domain Kernels
+ * \{ */
+
+/**
+ * Identifies a transformed kernel by its weights and the size of the transform.
+ */
+class FFTKernelKey : public GenericKey {
+ public:
+  int2 transform_size;
+  int2 kernel_size;
+  int channels_num;
+  /** Weights of all channels, interleaved like in the kernel buffer. */
+  Array<float> weights;
+
+  uint64_t hash() const override
+  {
+    return get_default_hash(
+        get_default_hash(transform_size.x, transform_size.y),
+        get_default_hash(kernel_size.x, kernel_size.y, channels_num),
+        BLI_hash_mm2(reinterpret_cast<const uchar *>(weights.data()),
+                     size_t(weights.size()) * sizeof(float),
+                     0));
+  }
+
+  bool equal_to(const GenericKey &other) const override
+  {
+    if (const auto *other_typed = dynamic_cast<const FFTKernelKey *>(&other)) {
+      return transform_size == other_typed->transform_size &&
+             kernel_size == other_typed->kernel_size &&
+             channels_num == other_typed->channels_num &&
+             weights.as_span() == other_typed->weights.as_span();
+    }
+    return false;
+  }
+
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<FFTKernelKey>(*this);
+  }
+};
+
+/**
+ * Kernel transformed to the frequency domain, shared by all convolutions using the same kernel
+ * and transform size.
+ */
+class FFTKernel : public memory_cache::CachedValue {
+ public:
+  /** Number of complex values of every channel, including the alignment padding. */
+  int64_t channel_size = 0;
+  int channels_num = 0;
+  std::complex<float> *frequency_domain = nullptr;
+  /** Sum of the weights of every channel. */
+  Array<float> weights_sum;
+
+  ~FFTKernel()
+  {
+    fftwf_free(frequency_domain);
+  }
+
+  const std::complex<float> *channel(const int channel) const
+  {
+    return frequency_domain + channel_size * channel;
+  }
+
+  void count_memory(MemoryCounter &memory) const override
+  {
+    memory.add(channel_size * channels_num * int64_t(sizeof(std::complex<float>)));
+  }
+};
+
+static std::unique_ptr<FFTKernel> compute_fft_kernel(const FFTKernelKey &key)
+{
+  const int2 transform_size = key.transform_size;
+  const int2 frequency_size = int2(transform_size.x / 2 + 1, transform_size.y);
+  const int2 radius = key.kernel_size / 2;
+
+  std::unique_ptr<FFTKernel> kernel = std::make_unique<FFTKernel>();
+  kernel->channels_num = key.channels_num;
+  kernel->channel_size = aligned_channel_size(int64_t(frequency_size.x) * frequency_size.y,
+                                              sizeof(std::complex<float>));
+  kernel->frequency_domain = reinterpret_cast<std::complex<float> *>(
+      fftwf_alloc_complex(kernel->channel_size * key.channels_num));
+  kernel->weights_sum = Array<float>(key.channels_num);
+
+  const int64_t spatial_size = int64_t(transform_size.x) * transform_size.y;
+  float *spatial_domain = fftwf_alloc_real(spatial_size);
+
+  fftwf_plan forward_plan = fftwf_plan_dft_r2c_2d(
+      transform_size.y,
+      transform_size.x,
+      spatial_domain,
+      reinterpret_cast<fftwf_complex *>(kernel->frequency_domain),
+      FFTW_ESTIMATE);
+
+  for (const int channel : IndexRange(key.channels_num)) {
+    std::fill_n(spatial_domain, spatial_size, 0.0f);
+
+    /* Use a double to sum the weights, since large kernels have many small weights. */
+    double sum = 0.0;
+    for (const int y : IndexRange(key.kernel_size.y)) {
+      for (const int x : IndexRange(key.kernel_size.x)) {
+        const int64_t weight_index = (int64_t(y) * key.kernel_size.x + x) * key.channels_num +
+                                     channel;
+        const float weight = key.weights[weight_index];
+        /* The input pixel at the `(i, j)` offset is weighted by the kernel at `(i, j)`, so the
+         * kernel is stored mirrored around the zero point with wrap around, which is the expected
+         * format for doing circular convolutions in the frequency domain. */
+        const int64_t output_x = mod_i(radius.x - x, transform_size.x);
+        const int64_t output_y = mod_i(radius.y - y, transform_size.y);
+        spatial_domain[output_x + output_y * transform_size.x] = weight;
+        sum += weight;
+      }
+    }
+    kernel->weights_sum[channel] = float(sum);
+
+    fftwf_execute_dft_r2c(forward_plan,
+                          spatial_domain,
+                          reinterpret_cast<fftwf_complex *>(kernel->frequency_domain +
+                                                            kernel->channel_size * channel));
+  }
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_free(spatial_domain);
+
+  return kernel;
+}
+
+static std::shared_ptr<const FFTKernel> get_fft_kernel(const MemoryBuffer &kernel,
+                                                       const int2 transform_size)
+{
+  FFTKernelKey key;
+  key.transform_size = transform_size;
+  key.kernel_size = int2(kernel.get_width(), kernel.get_height());
+  key.channels_num = kernel.get_num_channels();
+  key.weights = Array<float>(int64_t(key.kernel_size.x) * key.kernel_size.y * key.channels_num);
+
+  const rcti &kernel_rect = kernel.get_rect();
+  for (const int y : IndexRange(key.kernel_size.y)) {
+    for (const int x : IndexRange(key.kernel_size.x)) {
+      const float *weights = kernel.get_elem(kernel_rect.xmin + x, kernel_rect.ymin + y);
+      const int64_t index = (int64_t(y) * key.kernel_size.x + x) * key.channels_num;
+      std::copy_n(weights, key.channels_num, &key.weights[index]);
+    }
+  }
+
+  return memory_cache::get<FFTKernel>(key, [&]() { return compute_fft_kernel(key); });
+}
+
+/** \} */
+
+#endif
+
+/* -------------------------------------------------------------------- */
+/** \name Convolution
+ * \{ */
+
+void fft_convolve(const MemoryBuffer &input,
+                  const MemoryBuffer &kernel,
+                  const FFTConvolutionBoundary boundary,
+                  MemoryBuffer &output,
+                  const rcti &area)
+{
+#if defined(WITH_FFTW3)
+  fftw::initialize_float();
+
+  const int channels_num = output.get_num_channels();
+  const int kernel_channels_num = kernel.get_num_channels();
+  BLI_assert(input.get_num_channels() == channels_num);
+  BLI_assert(ELEM(kernel_channels_num, 1, channels_num));
+
+  const int2 radius = int2(kernel.get_width(), kernel.get_height()) / 2;
+  const int2 area_size = int2(BLI_rcti_size_x(&area), BLI_rcti_size_y(&area));
+
+  /* Since we will be doing a circular convolution, the area is padded by the kernel radius on
+   * every side to avoid the kernel affecting the pixels at the other side of the area. The padding
+   * is read from the input following the boundary condition, the rest of the transform is zero. */
+  const int2 padded_size = area_size + radius * 2;
+  const int2 transform_size = fftw::optimal_size_for_real_transform(padded_size);
+  const int2 frequency_size = int2(transform_size.x / 2 + 1, transform_size.y);
+
+  const std::shared_ptr<const FFTKernel> fft_kernel = get_fft_kernel(kernel, transform_size);
+
+  /* With a zero boundary, the weights of the input pixels covered by the kernel vary near the
+   * edges of the input. They are computed by convolving a mask of the input with every kernel
+   * channel, the mask is transformed as an extra channel after the image channels. */
+  const bool use_mask = boundary == FFTConvolutionBoundary::Zero;
+  const int mask_channel = channels_num;
+  const int forward_channels_num = channels_num + (use_mask ? 1 : 0);
+  const int backward_channels_num = channels_num + (use_mask ? kernel_channels_num : 0);
+
+  const int64_t spatial_channel_size = aligned_channel_size(
+      int64_t(transform_size.x) * transform_size.y, sizeof(float));
+  const int64_t frequency_channel_size = fft_kernel->channel_size;
+
+  float *spatial_domain = fftwf_alloc_real(spatial_channel_size * backward_channels_num);
+  std::complex<float> *frequency_domain = reinterpret_cast<std::complex<float> *>(
+      fftwf_alloc_complex(frequency_channel_size * backward_channels_num));
+
+  /* The same plans are used for all channels since they have the same dimensions. */
+  fftwf_plan forward_plan = fftwf_plan_dft_r2c_2d(
+      transform_size.y,
+      transform_size.x,
+      spatial_domain,
+      reinterpret_cast<fftwf_complex *>(frequency_domain),
+      FFTW_ESTIMATE);
+  fftwf_plan backward_plan = fftwf_plan_dft_c2r_2d(
+      transform_size.y,
+      transform_size.x,
+      reinterpret_cast<fftwf_complex *>(frequency_domain),
+      spatial_domain,
+      FFTW_ESTIMATE);
+
+  /* Pad the area to the transform size, storing each channel in planar format for better cache
+   * locality, that is, RRRR...GGGG...BBBB. */
+  const rcti &input_rect = input.get_rect();
+  threading::parallel_for(IndexRange(transform_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(transform_size.x)) {
+        const int input_x = area.xmin - radius.x + int(x);
+        const int input_y = area.ymin - radius.y + int(y);
+
+        const float *color = nullptr;
+        if (x < padded_size.x && y < padded_size.y) {
+          if (boundary == FFTConvolutionBoundary::Extend) {
+            color = input.get_elem_clamped(input_x, input_y);
+          }
+          else if (input_x >= input_rect.xmin && input_x < input_rect.xmax &&
+                   input_y >= input_rect.ymin && input_y < input_rect.ymax)
+          {
+            color = input.get_elem(input_x, input_y);
+          }
+        }
+
+        const int64_t base_index = x + y * transform_size.x;
+        for (const int channel : IndexRange(channels_num)) {
+          spatial_domain[base_index + spatial_channel_size * channel] = color ? color[channel] :
+                                                                                0.0f;
+        }
+        if (use_mask) {
+          spatial_domain[base_index + spatial_channel_size * mask_channel] = color ? 1.0f : 0.0f;
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(forward_channels_num), 1, [&](const IndexRange sub_range) {
+    for (const int64_t channel : sub_range) {
+      fftwf_execute_dft_r2c(forward_plan,
+                            spatial_domain + spatial_channel_size * channel,
+                            reinterpret_cast<fftwf_complex *>(frequency_domain) +
+                                frequency_channel_size * channel);
+    }
+  });
+
+  /* The FFT is not normalized, meaning the result of the FFT followed by an inverse FFT will
+   * result in an image that is scaled by a factor of the product of the width and height, so we
+   * take that into account by dividing by that scale. With an extended boundary, all pixels are
+   * covered by the whole kernel, so the weights sum is divided out here as well. */
+  const float transform_scale = float(transform_size.x) * transform_size.y;
+  Array<float> scales(kernel_channels_num);
+  for (const int channel : IndexRange(kernel_channels_num)) {
+    const float weights_sum = use_mask ? 1.0f : fft_kernel->weights_sum[channel];
+    scales[channel] = weights_sum != 0.0f ? 1.0f / (transform_scale * weights_sum) : 0.0f;
+  }
+
+  /* Multiply the kernel and the image in the frequency domain to perform the convolution. */
+  threading::parallel_for(IndexRange(frequency_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(frequency_size.x)) {
+        const int64_t base_index = x + y * frequency_size.x;
+        for (const int channel : IndexRange(channels_num)) {
+          const int kernel_channel = kernel_channels_num == 1 ? 0 : channel;
+          const std::complex<float> kernel_value =
+              fft_kernel->channel(kernel_channel)[base_index] * scales[kernel_channel];
+          frequency_domain[base_index + frequency_channel_size * channel] *= kernel_value;
+        }
+        if (use_mask) {
+          const std::complex<float> mask_value =
+              frequency_domain[base_index + frequency_channel_size * mask_channel];
+          for (const int kernel_channel : IndexRange(kernel_channels_num)) {
+            const std::complex<float> kernel_value =
+                fft_kernel->channel(kernel_channel)[base_index] * scales[kernel_channel];
+            const int64_t output_channel = mask_channel + kernel_channel;
+            frequency_domain[base_index + frequency_channel_size * output_channel] = mask_value *
+                                                                                     kernel_value;
+          }
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(backward_channels_num), 1, [&](const IndexRange sub_range) {
+    for (const int64_t channel : sub_range) {
+      fftwf_execute_dft_c2r(backward_plan,
+                            reinterpret_cast<fftwf_complex *>(frequency_domain) +
+                                frequency_channel_size * channel,
+                            spatial_domain + spatial_channel_size * channel);
+    }
+  });
+
+  /* Copy the result to the output, skipping the padding. */
+  threading::parallel_for(IndexRange(area_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(area_size.x)) {
+        const int64_t base_index = (x + radius.x) + (y + radius.y) * transform_size.x;
+        float *result = output.get_elem(area.xmin + int(x), area.ymin + int(y));
+        for (const int channel : IndexRange(channels_num)) {
+          float value = spatial_domain[base_index + spatial_channel_size * channel];
+          if (use_mask) {
+            const int kernel_channel = kernel_channels_num == 1 ? 0 : channel;
+            const int64_t weights_channel = mask_channel + kernel_channel;
+            const float weights_sum =
+                spatial_domain[base_index + spatial_channel_size * weights_channel];
+            /* Pixels not covered by any input pixel only hold numerical noise. */
+            const float min_weights_sum = fft_kernel->weights_sum[kernel_channel] * 1e-6f;
+            value = weights_sum > min_weights_sum ? value / weights_sum : 0.0f;
+          }
+          result[channel] = value;
+        }
+      }
+    }
+  });
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_destroy_plan(backward_plan);
+  fftwf_free(spatial_domain);
+  fftwf_free(frequency_domain);
+#else
+  UNUSED_VARS(input, kernel, boundary, output, area);
+  BLI_assert_unreachable();
+#endif
+}
+
+/** \} */
+
+}  // namespace blender::compositor
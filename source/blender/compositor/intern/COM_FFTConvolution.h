@@ -0,0 +1,48 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_vec_types.h"
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * How input pixels outside of the input buffer are handled by #fft_convolve.
+ */
+enum class FFTConvolutionBoundary {
+  /** Pixels outside of the input are skipped, the kernel is normalized by the weights inside. */
+  Zero,
+  /** Pixels outside of the input are the closest pixel inside. */
+  Extend,
+};
+
+/**
+ * Whether convolving with a kernel of the given radius is expected to be faster in the frequency
+ * domain using #fft_convolve than in the spatial domain. Always false when built without FFTW.
+ */
+bool use_fft_convolution(int2 radius);
+
+/**
+ * Compute the given \a area of \a output, where every pixel is the weighted average of the input
+ * pixels around it: `sum(input(x + i, y + j) * kernel(i, j)) / sum(kernel(i, j))` for `i` and
+ * `j` in `[-radius, radius]`. The kernel buffer is `2 * radius + 1` pixels in size, its center is
+ * the `(0, 0)` offset. It either has a single channel used for all the input channels or as many
+ * channels as the input.
+ *
+ * The convolution is done by multiplying the Fourier transforms of the input and kernel, the cost
+ * is independent of the kernel size. The transformed kernels are cached in the global memory
+ * cache and reused while the kernel weights and the transform size remain the same.
+ */
+void fft_convolve(const MemoryBuffer &input,
+                  const MemoryBuffer &kernel,
+                  FFTConvolutionBoundary boundary,
+                  MemoryBuffer &output,
+                  const rcti &area);
+
+}  // namespace blender::compositor
@@ -44,6 +44,9 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   determine_areas_to_render_and_reads();
   render_operations();
+
+  /* Images that weren't read by this execution may have been freed. */
+  ResultCache::free_unused_image_versions();
 }
 
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
@@ -58,6 +61,17 @@ void FullFrameExecutionModel::determine_areas_to_render_and_reads()
       if (op->is_output_operation(is_rendering) && op->get_render_priority() == priority) {
         get_output_render_area(op, area);
         determine_areas_to_render(op, area);
+      }
+    }
+  }
+
+  /* Cached results are known once areas to render are, they set operations as rendered so that
+   * no reads are registered for their inputs. */
+  result_cache_.acquire_cached_results(operations_, active_buffers_);
+
+  for (eCompositorPriority priority : priorities_) {
+    for (NodeOperation *op : operations_) {
+      if (op->is_output_operation(is_rendering) && op->get_render_priority() == priority) {
         determine_reads(op);
       }
     }
@@ -108,6 +122,7 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   const bool has_outputs = op->get_number_of_output_sockets() > 0;
   MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
   if (op->get_width() > 0 && op->get_height() > 0) {
+    active_buffers_.pack_unread_buffers(op);
     Vector<MemoryBuffer *> input_bufs = get_input_buffers(op, output_x, output_y);
     const int op_offset_x = output_x - op->get_canvas().xmin;
     const int op_offset_y = output_y - op->get_canvas().ymin;
@@ -119,9 +134,15 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
       delete buf;
     }
   }
-  /* Even if operation has no resolution set the empty buffer. It will be clipped with a
-   * TranslateOperation from convert resolutions if linked to an operation with resolution. */
-  active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+  if (op_buf && result_cache_.should_store_result(op)) {
+    active_buffers_.set_cached_buffer(
+        op, result_cache_.store_result(op, std::unique_ptr<MemoryBuffer>(op_buf)));
+  }
+  else {
+    /* Even if operation has no resolution set the empty buffer. It will be clipped with a
+     * TranslateOperation from convert resolutions if linked to an operation with resolution. */
+    active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+  }
 
   operation_finished(op);
 
@@ -188,7 +209,8 @@ void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_o
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
   Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
   for (NodeOperation *op : dependencies) {
-    if (!active_buffers_.is_operation_rendered(op)) {
+    /* Operations without reads are only read by operations reused from the result cache. */
+    if (!active_buffers_.is_operation_rendered(op) && active_buffers_.has_registered_reads(op)) {
       render_operation(op);
     }
   }
@@ -235,6 +257,10 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (active_buffers_.is_operation_rendered(operation)) {
+      /* Reused from the result cache, its inputs are not read. */
+      continue;
+    }
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -8,6 +8,7 @@
 
 #include "COM_Enums.h"
 #include "COM_ExecutionModel.h"
+#include "COM_ResultCache.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -43,6 +44,11 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Results reused from previous executions and stored for the next ones.
+   */
+  ResultCache result_cache_;
+
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
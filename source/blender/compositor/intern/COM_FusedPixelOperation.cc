@@ -0,0 +1,145 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+
+#include "COM_FusedPixelOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Number of pixels evaluated at once by each member operation.
+ * Keeps intermediate color strips at 256KB.
+ */
+static constexpr int STRIP_PIXELS_NUM = 16384;
+
+FusedPixelOperation::FusedPixelOperation(Vector<MultiThreadedOperation *> members)
+    : members_(std::move(members))
+{
+  BLI_assert(members_.size() > 1);
+
+  Map<const NodeOperation *, int> member_indices;
+  for (const int i : members_.index_range()) {
+    member_indices.add_new(members_[i], i);
+  }
+
+  Map<NodeOperationOutput *, int> input_indices;
+  members_inputs_.resize(members_.size());
+  for (const int i : members_.index_range()) {
+    MultiThreadedOperation *member = members_[i];
+    BLI_assert(member->get_flags().can_be_fused);
+    BLI_assert(member->num_passes_ == 1);
+    BLI_assert(BLI_rcti_compare(&member->get_canvas(), &members_.last()->get_canvas()));
+
+    for (int j = 0; j < member->get_number_of_input_sockets(); j++) {
+      NodeOperationInput *socket = member->get_input_socket(j);
+      NodeOperationOutput *link = socket->get_link();
+      BLI_assert(link != nullptr);
+
+      MemberInput input = {-1, -1};
+      input.member_index = member_indices.lookup_default(&link->get_operation(), -1);
+      if (input.member_index != -1) {
+        BLI_assert(input.member_index < i);
+      }
+      else {
+        input.input_index = input_indices.lookup_or_add_cb(link, [&]() {
+          /* Canvases are already determined, no resizing is needed. */
+          this->add_input_socket(socket->get_data_type(), ResizeMode::None);
+          input_links_.append(link);
+          return int(input_links_.size()) - 1;
+        });
+      }
+      members_inputs_[i].append(input);
+    }
+  }
+
+  NodeOperation *root = members_.last();
+  this->add_output_socket(root->get_output_socket()->get_data_type());
+  this->set_canvas(root->get_canvas());
+  this->set_name(root->get_name());
+  /* Evaluation time of the group is accounted to the node of its output. */
+  this->set_node_instance_key(root->get_node_instance_key());
+}
+
+FusedPixelOperation::~FusedPixelOperation()
+{
+  for (MultiThreadedOperation *member : members_) {
+    delete member;
+  }
+}
+
+void FusedPixelOperation::init_data()
+{
+  for (MultiThreadedOperation *member : members_) {
+    member->init_data();
+  }
+}
+
+void FusedPixelOperation::init_execution()
+{
+  for (MultiThreadedOperation *member : members_) {
+    member->init_execution();
+  }
+}
+
+void FusedPixelOperation::deinit_execution()
+{
+  for (MultiThreadedOperation *member : members_) {
+    member->deinit_execution();
+  }
+}
+
+std::unique_ptr<MetaData> FusedPixelOperation::get_meta_data()
+{
+  return members_.last()->get_meta_data();
+}
+
+void FusedPixelOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                       const rcti &area,
+                                                       Span<MemoryBuffer *> inputs)
+{
+  const int width = BLI_rcti_size_x(&area);
+  const int height = BLI_rcti_size_y(&area);
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  const int strip_height = std::clamp(STRIP_PIXELS_NUM / width, 1, height);
+
+  /* Strip buffers for the results of all members but the last one, which writes the output. */
+  const int intermediates_num = members_.size() - 1;
+  Array<int> intermediate_channels(intermediates_num);
+  Array<Array<float>> intermediate_data(intermediates_num);
+  for (const int i : IndexRange(intermediates_num)) {
+    const DataType data_type = members_[i]->get_output_socket()->get_data_type();
+    intermediate_channels[i] = COM_data_type_num_channels(data_type);
+    intermediate_data[i].reinitialize(int64_t(width) * strip_height * intermediate_channels[i]);
+  }
+
+  Array<std::unique_ptr<MemoryBuffer>> intermediate_buffers(intermediates_num);
+  Vector<MemoryBuffer *> member_inputs;
+  for (int y = area.ymin; y < area.ymax; y += strip_height) {
+    rcti strip;
+    BLI_rcti_init(&strip, area.xmin, area.xmax, y, std::min(y + strip_height, area.ymax));
+
+    for (const int i : members_.index_range()) {
+      member_inputs.clear();
+      for (const MemberInput &input : members_inputs_[i]) {
+        member_inputs.append(input.member_index != -1 ?
+                                 intermediate_buffers[input.member_index].get() :
+                                 inputs[input.input_index]);
+      }
+
+      MemoryBuffer *member_output = output;
+      if (i < intermediates_num) {
+        intermediate_buffers[i] = std::make_unique<MemoryBuffer>(
+            intermediate_data[i].data(), intermediate_channels[i], strip);
+        member_output = intermediate_buffers[i].get();
+      }
+      members_[i]->update_memory_buffer_partial(member_output, strip, member_inputs);
+    }
+  }
+}
+
+}  // namespace blender::compositor
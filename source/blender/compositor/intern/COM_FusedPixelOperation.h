@@ -0,0 +1,67 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "COM_MultiThreadedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Executes a group of operations that can be fused (see #NodeOperationFlags::can_be_fused)
+ * as a single operation.
+ *
+ * The output area is processed in strips of a few rows. Every member operation is evaluated for
+ * a strip before moving on to the next one, so intermediate results only need strip sized buffers
+ * which stay in the CPU caches, instead of a full size #MemoryBuffer per operation.
+ */
+class FusedPixelOperation : public MultiThreadedOperation {
+ private:
+  /** Where an input of a member operation reads from. */
+  struct MemberInput {
+    /** Index in #members_ when reading from another member, otherwise -1. */
+    int member_index;
+    /** Index of the fused operation input when reading from outside the group, otherwise -1. */
+    int input_index;
+  };
+
+  /** Member operations in execution order. Only the last one is read outside of the group. */
+  Vector<MultiThreadedOperation *> members_;
+  /** Inputs of each member operation. */
+  Vector<Vector<MemberInput>> members_inputs_;
+  /** Operation outputs read by each input of the fused operation. */
+  Vector<NodeOperationOutput *> input_links_;
+
+ public:
+  /**
+   * \param members: Operations sorted by dependency, ownership is transferred.
+   * Their inputs must be linked and their canvases must be determined and equal.
+   */
+  FusedPixelOperation(Vector<MultiThreadedOperation *> members);
+  ~FusedPixelOperation();
+
+  Span<MultiThreadedOperation *> get_members() const
+  {
+    return members_;
+  }
+
+  /** Operation outputs that must be linked to the inputs of the fused operation. */
+  Span<NodeOperationOutput *> get_input_links() const
+  {
+    return input_links_;
+  }
+
+  void init_data() override;
+  void init_execution() override;
+  void deinit_execution() override;
+
+  std::unique_ptr<MetaData> get_meta_data() override;
+
+ protected:
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+};
+
+}  // namespace blender::compositor
@@ -2,8 +2,20 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <atomic>
+#include <mutex>
+
 #include "COM_MemoryBuffer.h"
 
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_math_half.hh"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.hh"
+
+#include "BKE_appdir.hh"
+
 #include "IMB_colormanagement.hh"
 #include "IMB_imbuf_types.hh"
 
@@ -165,6 +177,140 @@ MemoryBuffer::~MemoryBuffer()
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Packed Storage
+ *
+ * Packed buffers are split in tiles of whole rows which are converted in parallel. When stored
+ * on disk, each tile is converted in a thread local buffer and only the file access is serial.
+ * \{ */
+
+/** Number of values converted together when packing and unpacking a buffer. */
+static constexpr int64_t PACKED_TILE_VALUES_NUM = 1 << 18;
+
+struct MemoryBuffer::PackedData {
+  MemoryBufferStorage storage = MemoryBufferStorage::Half;
+  /** Half float values of the whole buffer when stored in memory. */
+  Array<uint16_t> half_values;
+  /** Temporary file with the half float values of the whole buffer when stored on disk. */
+  FILE *file = nullptr;
+  char filepath[FILE_MAX] = "";
+  std::mutex file_mutex;
+
+  ~PackedData()
+  {
+    this->close_file();
+  }
+
+  void close_file()
+  {
+    if (file) {
+      fclose(file);
+      BLI_delete(filepath, false, false);
+      file = nullptr;
+    }
+  }
+};
+
+template<typename Fn>
+static void foreach_packed_tile(const int64_t values_num, const int64_t row_len, const Fn &fn)
+{
+  const int64_t tile_rows = std::max<int64_t>(PACKED_TILE_VALUES_NUM / row_len, 1);
+  const int64_t tile_len = tile_rows * row_len;
+  const int64_t tiles_num = (values_num + tile_len - 1) / tile_len;
+  threading::parallel_for(IndexRange(tiles_num), 1, [&](const IndexRange tiles) {
+    Array<uint16_t> tile_values(tile_len, NoInitialization());
+    for (const int64_t tile : tiles) {
+      const int64_t start = tile * tile_len;
+      fn(IndexRange(start, std::min(tile_len, values_num - start)), tile_values.data());
+    }
+  });
+}
+
+void MemoryBuffer::pack(const MemoryBufferStorage storage)
+{
+  if (storage == MemoryBufferStorage::Float || !owns_data_ || is_a_single_elem_ ||
+      is_packed() || buffer_len() == 0)
+  {
+    return;
+  }
+
+  if (!packed_) {
+    const int64_t values_num = buffer_len() * num_channels_;
+    packed_ = std::make_unique<PackedData>();
+    PackedData &packed = *packed_;
+
+    if (storage == MemoryBufferStorage::Disk) {
+      char filename[FILE_MAX];
+      SNPRINTF(filename, "compositor_buffer_%p.tmp", this);
+      BLI_path_join(packed.filepath, sizeof(packed.filepath), BKE_tempdir_session(), filename);
+      packed.file = BLI_fopen(packed.filepath, "w+b");
+      packed.storage = MemoryBufferStorage::Disk;
+    }
+
+    if (packed.file) {
+      std::atomic<bool> write_failed = false;
+      foreach_packed_tile(values_num, row_stride, [&](const IndexRange values, uint16_t *tile) {
+        math::float_to_half_array(buffer_ + values.start(), tile, values.size());
+        std::scoped_lock lock(packed.file_mutex);
+        if (BLI_fseek(packed.file, values.start() * sizeof(uint16_t), SEEK_SET) != 0 ||
+            fwrite(tile, sizeof(uint16_t), values.size(), packed.file) != values.size())
+        {
+          write_failed = true;
+        }
+      });
+      if (write_failed) {
+        packed.close_file();
+      }
+    }
+
+    /* Keep the data in memory when it couldn't be written to disk, e.g. when out of space. */
+    if (!packed.file) {
+      packed.storage = MemoryBufferStorage::Half;
+      packed.half_values = Array<uint16_t>(values_num, NoInitialization());
+      foreach_packed_tile(values_num, row_stride, [&](const IndexRange values, uint16_t *) {
+        math::float_to_half_array(
+            buffer_ + values.start(), packed.half_values.data() + values.start(), values.size());
+      });
+    }
+  }
+
+  MEM_freeN(buffer_);
+  buffer_ = nullptr;
+}
+
+void MemoryBuffer::unpack()
+{
+  if (!is_packed()) {
+    return;
+  }
+
+  const int64_t values_num = buffer_len() * num_channels_;
+  buffer_ = (float *)MEM_mallocN_aligned(sizeof(float) * values_num, 16, "COM_MemoryBuffer");
+
+  PackedData &packed = *packed_;
+  foreach_packed_tile(values_num, row_stride, [&](const IndexRange values, uint16_t *tile) {
+    float *dst = buffer_ + values.start();
+    if (packed.storage == MemoryBufferStorage::Half) {
+      math::half_to_float_array(packed.half_values.data() + values.start(), dst, values.size());
+      return;
+    }
+    bool read_failed;
+    {
+      std::scoped_lock lock(packed.file_mutex);
+      read_failed = BLI_fseek(packed.file, values.start() * sizeof(uint16_t), SEEK_SET) != 0 ||
+                    fread(tile, sizeof(uint16_t), values.size(), packed.file) != values.size();
+    }
+    if (read_failed) {
+      BLI_assert_unreachable();
+      memset(dst, 0, sizeof(float) * values.size());
+      return;
+    }
+    math::half_to_float_array(tile, dst, values.size());
+  });
+}
+
+/** \} */
+
 void MemoryBuffer::copy_from(const MemoryBuffer *src, const rcti &area)
 {
   copy_from(src, area, area.xmin, area.ymin);
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <memory>
 
 struct ColormanageProcessor;
 struct ImBuf;
@@ -90,6 +91,13 @@ class MemoryBuffer {
   /** Stride to make any y coordinate within buffer positive (non-zero). */
   int to_positive_y_stride_;
 
+  struct PackedData;
+  /**
+   * Compact copy of the buffer data, see #pack. It's kept until the buffer is destroyed so that
+   * packing again after an #unpack only has to free the float data.
+   */
+  std::unique_ptr<PackedData> packed_;
+
  public:
   /**
    * \brief construct new temporarily MemoryBuffer for a width and height.
@@ -133,6 +141,25 @@ class MemoryBuffer {
     return is_a_single_elem_;
   }
 
+  /**
+   * Store the buffer data in a more compact form while it isn't being read and free the float
+   * data, the buffer must be unpacked before accessing its data again. Packing is lossy, values
+   * are rounded to half precision. The data is converted only the first time, so it must not be
+   * modified once the buffer has been packed.
+   * Only owned full size buffers are packed, for others it does nothing.
+   */
+  void pack(MemoryBufferStorage storage);
+
+  /**
+   * Restore the float data of a packed buffer. Does nothing if the buffer isn't packed.
+   */
+  void unpack();
+
+  bool is_packed() const
+  {
+    return packed_ && buffer_ == nullptr;
+  }
+
   float &operator[](int index)
   {
     BLI_assert(is_a_single_elem_ ? index < num_channels_ :
@@ -366,6 +393,7 @@ class MemoryBuffer {
    */
   float *get_buffer()
   {
+    BLI_assert(!is_packed());
     return buffer_;
   }
 
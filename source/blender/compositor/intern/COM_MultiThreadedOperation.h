@@ -47,10 +47,17 @@ class MultiThreadedOperation : public NodeOperation {
   {
   }
 
- private:
+  /**
+   * Executes the update memory buffer passes, split in areas updated in parallel. May be
+   * overridden by operations that process the whole area at once in some cases.
+   */
   void update_memory_buffer(MemoryBuffer *output,
                             const rcti &area,
                             Span<MemoryBuffer *> inputs) override;
+
+ private:
+  /* Executes the partial updates of its member operations. */
+  friend class FusedPixelOperation;
 };
 
 }  // namespace blender::compositor
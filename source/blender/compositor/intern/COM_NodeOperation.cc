@@ -40,7 +40,9 @@ const float *NodeOperation::get_constant_elem_default(const float *default_elem)
 
 std::optional<NodeOperationHash> NodeOperation::generate_hash()
 {
-  params_hash_ = get_default_hash(canvas_.xmin, canvas_.xmax);
+  params_hash_ = 0;
+  params_key_.clear();
+  hash_params(canvas_.xmin, canvas_.xmax);
 
   /* Hash subclasses params. */
   is_hash_output_params_implemented_ = true;
@@ -84,6 +86,48 @@ std::optional<NodeOperationHash> NodeOperation::generate_hash()
   return hash;
 }
 
+std::optional<NodeOperationContentKey> NodeOperation::generate_content_key(
+    const FunctionRef<std::optional<size_t>(NodeOperation &input)> input_content_hash_fn)
+{
+  const std::optional<NodeOperationHash> hash = generate_hash();
+  if (!hash) {
+    return std::nullopt;
+  }
+
+  NodeOperationContentKey key;
+  key.type = &typeid(*this);
+  key.params = params_key_;
+  for (NodeOperationInput &socket : inputs_) {
+    if (!socket.is_connected()) {
+      continue;
+    }
+
+    NodeOperation &input = socket.get_link()->get_operation();
+    const bool is_constant = input.get_flags().is_constant_operation;
+    key.inputs.append(is_constant);
+    if (is_constant) {
+      const float *elem = ((ConstantOperation *)&input)->get_constant_elem();
+      const int num_channels = COM_data_type_num_channels(socket.get_data_type());
+      for (const int i : IndexRange(num_channels)) {
+        key.inputs.append(get_default_hash(elem[i]));
+      }
+      continue;
+    }
+
+    const std::optional<size_t> input_hash = input_content_hash_fn(input);
+    if (!input_hash) {
+      return std::nullopt;
+    }
+    key.inputs.append(*input_hash);
+  }
+
+  key.hash = get_default_hash(hash->type_hash_, hash->params_hash_);
+  for (const uint64_t value : key.inputs) {
+    combine_hashes(key.hash, value);
+  }
+  return key;
+}
+
 NodeOperationOutput *NodeOperation::get_output_socket(uint index)
 {
   return &outputs_[index];
@@ -317,6 +361,9 @@ std::ostream &operator<<(std::ostream &os, const NodeOperationFlags &node_operat
   if (node_operation_flags.can_be_constant) {
     os << "can_be_constant,";
   }
+  if (node_operation_flags.can_be_fused) {
+    os << "can_be_fused,";
+  }
 
   return os;
 }
@@ -6,7 +6,9 @@
 
 #include <functional>
 #include <list>
+#include <typeinfo>
 
+#include "BLI_function_ref.hh"
 #include "BLI_ghash.h"
 #include "BLI_hash.hh"
 #include "BLI_math_base.hh"
@@ -206,6 +208,14 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether operation output pixels only depend on the input pixels at the same coordinates,
+   * computed in a single #MultiThreadedOperation pass without any started/finished callbacks.
+   * Such operations can be executed together without intermediate buffers,
+   * see #PixelOperationFuser.
+   */
+  bool can_be_fused : 1;
+
   NodeOperationFlags()
   {
     use_render_border = false;
@@ -217,6 +227,7 @@ struct NodeOperationFlags {
     use_datatype_conversion = true;
     is_constant_operation = false;
     can_be_constant = false;
+    can_be_fused = false;
   }
 };
 
@@ -256,6 +267,31 @@ struct NodeOperationHash {
   }
 };
 
+/**
+ * Identifies an operation output result across executions, see
+ * #NodeOperation::generate_content_key. Besides the hash, it keeps the hashed values so that
+ * results are never confused because of hash collisions.
+ */
+struct NodeOperationContentKey {
+  size_t hash;
+  const std::type_info *type;
+  /** Hash of every parameter, which is the value itself for integer and float parameters. */
+  Vector<uint64_t> params;
+  /** Values of constant inputs and content hashes of the other inputs, in socket order. */
+  Vector<uint64_t> inputs;
+
+  friend bool operator==(const NodeOperationContentKey &a, const NodeOperationContentKey &b)
+  {
+    return a.hash == b.hash && *a.type == *b.type && a.params == b.params &&
+           a.inputs == b.inputs;
+  }
+
+  friend bool operator!=(const NodeOperationContentKey &a, const NodeOperationContentKey &b)
+  {
+    return !(a == b);
+  }
+};
+
 /**
  * \brief NodeOperation contains calculation logic
  *
@@ -272,6 +308,8 @@ class NodeOperation {
   Vector<NodeOperationOutput> outputs_;
 
   size_t params_hash_;
+  /** Hash of every parameter combined into #params_hash_. */
+  Vector<uint64_t> params_key_;
   bool is_hash_output_params_implemented_;
 
   /**
@@ -345,6 +383,15 @@ class NodeOperation {
    */
   std::optional<NodeOperationHash> generate_hash();
 
+  /**
+   * Generate a key that identifies the operation result across executions, from its parameters
+   * and the content of its inputs. The content hash of non constant inputs is given by
+   * #input_content_hash_fn, if any of them has none `std::nullopt` is returned. Like
+   * #generate_hash, it requires `hash_output_params` to be implemented.
+   */
+  std::optional<NodeOperationContentKey> generate_content_key(
+      FunctionRef<std::optional<size_t>(NodeOperation &input)> input_content_hash_fn);
+
   unsigned int get_number_of_input_sockets() const
   {
     return inputs_.size();
@@ -522,8 +569,10 @@ class NodeOperation {
  protected:
   NodeOperation();
 
-  /* Overridden by subclasses to allow merging equal operations on compiling. Implementations must
-   * hash any subclass parameter that affects the output result using `hash_params` methods. */
+  /* Overridden by subclasses to allow merging equal operations on compiling and caching results
+   * across executions. Implementations must hash any subclass parameter that affects the output
+   * result using `hash_params` methods, including the identity and version of any data read from
+   * outside of the node tree. */
   virtual void hash_output_params()
   {
     is_hash_output_params_implemented_ = false;
@@ -536,17 +585,22 @@ class NodeOperation {
 
   template<typename T> void hash_param(T param)
   {
-    combine_hashes(params_hash_, get_default_hash(param));
+    const uint64_t param_hash = get_default_hash(param);
+    combine_hashes(params_hash_, param_hash);
+    params_key_.append(param_hash);
   }
 
   template<typename T1, typename T2> void hash_params(T1 param1, T2 param2)
   {
-    combine_hashes(params_hash_, get_default_hash(param1, param2));
+    hash_param(param1);
+    hash_param(param2);
   }
 
   template<typename T1, typename T2, typename T3> void hash_params(T1 param1, T2 param2, T3 param3)
   {
-    combine_hashes(params_hash_, get_default_hash(param1, param2, param3));
+    hash_param(param1);
+    hash_param(param2);
+    hash_param(param3);
   }
 
   void add_input_socket(DataType datatype, ResizeMode resize_mode = ResizeMode::Center);
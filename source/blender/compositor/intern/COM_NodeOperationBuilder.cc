@@ -5,6 +5,7 @@
 #include <set>
 
 #include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
 
 #include "BKE_node_runtime.hh"
 
@@ -18,7 +19,9 @@
 #include "COM_ViewerOperation.h"
 
 #include "COM_ConstantFolder.h"
+#include "COM_FusedPixelOperation.h"
 #include "COM_NodeOperationBuilder.h" /* own include */
+#include "COM_PixelOperationFuser.h"
 
 namespace blender::compositor {
 
@@ -90,6 +93,10 @@ void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
   save_graphviz("compositor_prior_merging");
   merge_equal_operations();
 
+  save_graphviz("compositor_prior_fusing");
+  PixelOperationFuser fuser(*this);
+  fuser.fuse_operations();
+
   /* links not available from here on */
   /* XXX make links_ a local variable to avoid confusion! */
   links_.clear();
@@ -122,6 +129,42 @@ void NodeOperationBuilder::replace_operation_with_constant(NodeOperation *operat
   add_operation(constant_operation);
 }
 
+void NodeOperationBuilder::replace_operations_with_fused(FusedPixelOperation *fused_operation)
+{
+  Span<MultiThreadedOperation *> members = fused_operation->get_members();
+  const NodeOperation *output_member = members.last();
+  Set<const NodeOperation *> members_set;
+  for (const NodeOperation *member : members) {
+    members_set.add_new(member);
+  }
+
+  /* Member input sockets keep their links, they are still used to execute the group. */
+  int i = 0;
+  while (i < links_.size()) {
+    Link &link = links_[i];
+    if (members_set.contains(&link.to()->get_operation())) {
+      links_.remove(i);
+      continue;
+    }
+
+    if (&link.from()->get_operation() == output_member) {
+      link.to()->set_link(fused_operation->get_output_socket());
+      links_[i] = Link(fused_operation->get_output_socket(), link.to());
+    }
+    i++;
+  }
+
+  const Span<NodeOperationOutput *> input_links = fused_operation->get_input_links();
+  for (const int input_index : input_links.index_range()) {
+    add_link(input_links[input_index], fused_operation->get_input_socket(input_index));
+  }
+
+  for (MultiThreadedOperation *member : members) {
+    operations_.remove_first_occurrence_and_reorder(member);
+  }
+  add_operation(fused_operation);
+}
+
 void NodeOperationBuilder::unlink_inputs_and_relink_outputs(NodeOperation *unlinked_op,
                                                             NodeOperation *linked_op)
 {
@@ -25,6 +25,7 @@ class NodeOperationOutput;
 class PreviewOperation;
 class ViewerOperation;
 class ConstantOperation;
+class FusedPixelOperation;
 
 class NodeOperationBuilder {
  public:
@@ -82,6 +83,8 @@ class NodeOperationBuilder {
   void add_operation(NodeOperation *operation);
   void replace_operation_with_constant(NodeOperation *operation,
                                        ConstantOperation *constant_operation);
+  /** Replace the member operations of the fused operation, relinking their inputs & output. */
+  void replace_operations_with_fused(FusedPixelOperation *fused_operation);
 
   /** Map input socket of the current node to an operation socket */
   void map_input_socket(NodeInput *node_socket, NodeOperationInput *operation_socket);
@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "COM_CompositorContext.h"
+#include "COM_FusedPixelOperation.h"
+#include "COM_NodeOperationBuilder.h"
+#include "COM_PixelOperationFuser.h"
+
+namespace blender::compositor {
+
+PixelOperationFuser::PixelOperationFuser(NodeOperationBuilder &operations_builder)
+    : operations_builder_(operations_builder)
+{
+}
+
+bool PixelOperationFuser::is_fusable(NodeOperation *operation) const
+{
+  if (!operation->get_flags().can_be_fused || operation->get_number_of_output_sockets() != 1 ||
+      operation->is_output_operation(operations_builder_.context().is_rendering()))
+  {
+    return false;
+  }
+  if (operation->get_width() == 0 || operation->get_height() == 0) {
+    return false;
+  }
+  for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+    if (operation->get_input_operation(i) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void sort_group_recursive(Vector<MultiThreadedOperation *> &sorted,
+                                 Set<NodeOperation *> &visited,
+                                 const Set<NodeOperation *> &group,
+                                 NodeOperation *operation)
+{
+  if (!group.contains(operation) || !visited.add(operation)) {
+    return;
+  }
+  for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+    sort_group_recursive(sorted, visited, group, operation->get_input_operation(i));
+  }
+  sorted.append(static_cast<MultiThreadedOperation *>(operation));
+}
+
+Vector<MultiThreadedOperation *> PixelOperationFuser::find_group(
+    NodeOperation *output_operation, const Set<NodeOperation *> &grouped_operations)
+{
+  Vector<NodeOperation *> group = {output_operation};
+  Set<NodeOperation *> group_set = {output_operation};
+
+  /* An input operation can only be added once all the operations reading it are in the group,
+   * so iterate until no more operations are added. */
+  bool any_added = true;
+  while (any_added) {
+    any_added = false;
+    for (int group_index = 0; group_index < group.size(); group_index++) {
+      NodeOperation *operation = group[group_index];
+      for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+        NodeOperation *input = operation->get_input_operation(i);
+        if (group_set.contains(input) || grouped_operations.contains(input) || !is_fusable(input))
+        {
+          continue;
+        }
+        if (!BLI_rcti_compare(&input->get_canvas(), &output_operation->get_canvas())) {
+          continue;
+        }
+        bool is_read_outside_group = false;
+        for (NodeOperation *reader : output_operations_.lookup(input)) {
+          if (!group_set.contains(reader)) {
+            is_read_outside_group = true;
+            break;
+          }
+        }
+        if (is_read_outside_group) {
+          continue;
+        }
+        group.append(input);
+        group_set.add(input);
+        any_added = true;
+      }
+    }
+  }
+
+  Vector<MultiThreadedOperation *> sorted_group;
+  Set<NodeOperation *> visited;
+  sort_group_recursive(sorted_group, visited, group_set, output_operation);
+  BLI_assert(sorted_group.size() == group.size());
+  return sorted_group;
+}
+
+/* Depth-first sorting, inputs before the operations reading them. */
+static void sort_operations_recursive(Vector<NodeOperation *> &sorted,
+                                      Set<NodeOperation *> &visited,
+                                      NodeOperation *operation)
+{
+  if (!visited.add(operation)) {
+    return;
+  }
+  for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+    NodeOperation *input = operation->get_input_operation(i);
+    if (input) {
+      sort_operations_recursive(sorted, visited, input);
+    }
+  }
+  sorted.append(operation);
+}
+
+int PixelOperationFuser::fuse_operations()
+{
+  for (const NodeOperationBuilder::Link &link : operations_builder_.get_links()) {
+    output_operations_.add(&link.from()->get_operation(), &link.to()->get_operation());
+  }
+
+  Vector<NodeOperation *> sorted_operations;
+  Set<NodeOperation *> visited;
+  for (NodeOperation *operation : operations_builder_.get_operations()) {
+    sort_operations_recursive(sorted_operations, visited, operation);
+  }
+
+  /* Visit operations before their inputs, so that groups start at their output operation. */
+  Set<NodeOperation *> grouped_operations;
+  int fused_count = 0;
+  std::reverse(sorted_operations.begin(), sorted_operations.end());
+  for (NodeOperation *operation : sorted_operations) {
+    if (grouped_operations.contains(operation) || !is_fusable(operation)) {
+      continue;
+    }
+    Vector<MultiThreadedOperation *> group = find_group(operation, grouped_operations);
+    for (MultiThreadedOperation *member : group) {
+      grouped_operations.add(member);
+    }
+    if (group.size() < 2) {
+      continue;
+    }
+
+    for (MultiThreadedOperation *member : group) {
+      member->set_bnodetree(operations_builder_.context().get_bnodetree());
+    }
+    /* Replace right away, groups of the inputs are created afterwards and must be linked to the
+     * fused operation instead of its members. */
+    operations_builder_.replace_operations_with_fused(new FusedPixelOperation(std::move(group)));
+    fused_count++;
+  }
+
+  return fused_count;
+}
+
+}  // namespace blender::compositor
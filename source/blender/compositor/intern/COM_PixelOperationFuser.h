@@ -0,0 +1,54 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
+
+#include "COM_defines.h"
+
+namespace blender::compositor {
+
+class NodeOperation;
+class NodeOperationBuilder;
+class MultiThreadedOperation;
+
+/**
+ * Replaces groups of connected operations that can be fused with a #FusedPixelOperation,
+ * so chains of per-pixel operations (e.g. Mix, Math, Color Balance, Curves) don't need a full
+ * size buffer for every intermediate result.
+ */
+class PixelOperationFuser {
+ private:
+  NodeOperationBuilder &operations_builder_;
+
+  /** Operations reading the output of each operation. */
+  MultiValueMap<NodeOperation *, NodeOperation *> output_operations_;
+
+ public:
+  /**
+   * \param operations_builder: Contains all operations to fuse. Canvases must be determined and
+   * links still available.
+   */
+  PixelOperationFuser(NodeOperationBuilder &operations_builder);
+
+  /**
+   * Fuse all possible operations.
+   * \return Number of created fused operations.
+   */
+  int fuse_operations();
+
+ private:
+  bool is_fusable(NodeOperation *operation) const;
+
+  /**
+   * Find the largest group of operations that can be fused with the given output operation.
+   * \return The group sorted by dependency, the output operation last.
+   */
+  Vector<MultiThreadedOperation *> find_group(NodeOperation *output_operation,
+                                              const Set<NodeOperation *> &grouped_operations);
+};
+
+}  // namespace blender::compositor
@@ -0,0 +1,211 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BLI_array.hh"
+#include "BLI_math_base.h"
+#include "BLI_task.hh"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_RecursiveGaussianBlur.h"
+
+namespace blender::compositor {
+
+/**
+ * Number of lines filtered at once. Every step of the recursion is computed for all of them,
+ * which is enough to fill the SIMD registers with some room for instruction level parallelism.
+ */
+static constexpr int LANES_NUM = 16;
+
+/**
+ * Coefficients of the Young/van Vliet filter and the Triggs/Sdika boundary matrix. All factors are
+ * in double precision, because in single precision the filter blows up for `sigma > ~200`.
+ */
+struct RecursiveGaussianCoefficients {
+  /** Feed-forward gain followed by the (negated) feedback coefficients. */
+  double cf[4];
+  /** Maps the end of the causal pass to the initial values of the anti-causal pass. */
+  double tsM[9];
+
+  RecursiveGaussianCoefficients(const float sigma)
+  {
+    double q;
+    if (sigma >= 3.556f) {
+      q = 0.9804f * (sigma - 3.556f) + 2.5091f;
+    }
+    else { /* `sigma >= 0.5`. */
+      q = (0.0561f * sigma + 0.5784f) * sigma - 0.2568f;
+    }
+    const double q2 = q * q;
+    double sc = (1.1668 + q) * (3.203729649 + (2.21566 + q) * q);
+    cf[1] = q * (5.788961737 + (6.76492 + 3.0 * q) * q) / sc;
+    cf[2] = -q2 * (3.38246 + 3.0 * q) / sc;
+    cf[3] = q2 * q / sc;
+    cf[0] = 1.0 - cf[1] - cf[2] - cf[3];
+
+    /* Extra scale factor here to not have to do it in the filter. */
+    sc = cf[0] / ((1.0 + cf[1] - cf[2] + cf[3]) * (1.0 - cf[1] - cf[2] - cf[3]) *
+                  (1.0 + cf[2] + (cf[1] - cf[3]) * cf[3]));
+    tsM[0] = sc * (-cf[3] * cf[1] + 1.0 - cf[3] * cf[3] - cf[2]);
+    tsM[1] = sc * ((cf[3] + cf[1]) * (cf[2] + cf[3] * cf[1]));
+    tsM[2] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+    tsM[3] = sc * (cf[1] + cf[3] * cf[2]);
+    tsM[4] = sc * (-(cf[2] - 1.0) * (cf[2] + cf[3] * cf[1]));
+    tsM[5] = sc * (-(cf[3] * cf[1] + cf[3] * cf[3] + cf[2] - 1.0) * cf[3]);
+    tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
+    tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
+                   cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
+    tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+  }
+};
+
+/**
+ * Filter #LANES_NUM lines of the given length in place. The lines are interleaved, sample `i` of
+ * line `lane` is at `lines[i * LANES_NUM + lane]`, so the inner loops over the lanes vectorize.
+ */
+static void filter_lines(double *lines,
+                         const int64_t length,
+                         const RecursiveGaussianCoefficients &coefficients)
+{
+  BLI_assert(length >= 3);
+  const double *cf = coefficients.cf;
+  const double *tsM = coefficients.tsM;
+  const auto sample = [&](const int64_t i) { return lines + i * LANES_NUM; };
+
+  /* The boundary values are overwritten by the causal pass, so keep a copy. */
+  double first[LANES_NUM];
+  double last[LANES_NUM];
+  for (int lane = 0; lane < LANES_NUM; lane++) {
+    first[lane] = sample(0)[lane];
+    last[lane] = sample(length - 1)[lane];
+  }
+
+  /* Causal pass, the first value is assumed to extend infinitely before the line. */
+  double *w0 = sample(0);
+  double *w1 = sample(1);
+  double *w2 = sample(2);
+  for (int lane = 0; lane < LANES_NUM; lane++) {
+    w0[lane] = (cf[0] + cf[1] + cf[2] + cf[3]) * first[lane];
+    w1[lane] = cf[0] * w1[lane] + cf[1] * w0[lane] + (cf[2] + cf[3]) * first[lane];
+    w2[lane] = cf[0] * w2[lane] + cf[1] * w1[lane] + cf[2] * w0[lane] + cf[3] * first[lane];
+  }
+  for (int64_t i = 3; i < length; i++) {
+    double *w = sample(i);
+    const double *w_1 = sample(i - 1);
+    const double *w_2 = sample(i - 2);
+    const double *w_3 = sample(i - 3);
+    for (int lane = 0; lane < LANES_NUM; lane++) {
+      w[lane] = cf[0] * w[lane] + cf[1] * w_1[lane] + cf[2] * w_2[lane] + cf[3] * w_3[lane];
+    }
+  }
+
+  /* Anti-causal pass, initialized from the end of the causal pass such that the last value is
+   * assumed to extend infinitely after the line. */
+  double *y0 = sample(length - 1);
+  double *y1 = sample(length - 2);
+  double *y2 = sample(length - 3);
+  for (int lane = 0; lane < LANES_NUM; lane++) {
+    const double u0 = y0[lane] - last[lane];
+    const double u1 = y1[lane] - last[lane];
+    const double u2 = y2[lane] - last[lane];
+    const double v0 = tsM[0] * u0 + tsM[1] * u1 + tsM[2] * u2 + last[lane];
+    const double v1 = tsM[3] * u0 + tsM[4] * u1 + tsM[5] * u2 + last[lane];
+    const double v2 = tsM[6] * u0 + tsM[7] * u1 + tsM[8] * u2 + last[lane];
+    y0[lane] = cf[0] * y0[lane] + cf[1] * v0 + cf[2] * v1 + cf[3] * v2;
+    y1[lane] = cf[0] * y1[lane] + cf[1] * y0[lane] + cf[2] * v0 + cf[3] * v1;
+    y2[lane] = cf[0] * y2[lane] + cf[1] * y1[lane] + cf[2] * y0[lane] + cf[3] * v0;
+  }
+  for (int64_t i = length - 4; i >= 0; i--) {
+    double *y = sample(i);
+    const double *y_1 = sample(i + 1);
+    const double *y_2 = sample(i + 2);
+    const double *y_3 = sample(i + 3);
+    for (int lane = 0; lane < LANES_NUM; lane++) {
+      y[lane] = cf[0] * y[lane] + cf[1] * y_1[lane] + cf[2] * y_2[lane] + cf[3] * y_3[lane];
+    }
+  }
+}
+
+/**
+ * Filter the given channels of all lines of the buffer data. Channel `c` of line `l` starts at
+ * `l * line_stride + c` and its consecutive samples are `sample_stride` apart.
+ */
+static void blur_lines(float *data,
+                       const int64_t lines_num,
+                       const int64_t line_stride,
+                       const int64_t length,
+                       const int64_t sample_stride,
+                       const IndexRange channels,
+                       const float sigma)
+{
+  const RecursiveGaussianCoefficients coefficients(sigma);
+
+  /* Every channel of every line is an independent signal. Adjacent signals are filtered together,
+   * they are adjacent in memory for vertical passes. */
+  const int64_t signals_num = lines_num * channels.size();
+  const int64_t blocks_num = int64_t(divide_ceil_ul(uint64_t(signals_num), LANES_NUM));
+
+  threading::parallel_for(IndexRange(blocks_num), 1, [&](const IndexRange blocks_range) {
+    Array<double> lines(length * LANES_NUM);
+    for (const int64_t block : blocks_range) {
+      const IndexRange block_signals = IndexRange(block * LANES_NUM, LANES_NUM)
+                                           .intersect(IndexRange(signals_num));
+      const int lanes_num = int(block_signals.size());
+
+      int64_t offsets[LANES_NUM];
+      for (const int lane : IndexRange(lanes_num)) {
+        const int64_t signal = block_signals[lane];
+        offsets[lane] = (signal / channels.size()) * line_stride +
+                        channels[signal % channels.size()];
+      }
+
+      for (const int64_t i : IndexRange(length)) {
+        const float *samples = data + i * sample_stride;
+        double *line_samples = &lines[i * LANES_NUM];
+        for (int lane = 0; lane < lanes_num; lane++) {
+          line_samples[lane] = samples[offsets[lane]];
+        }
+        /* Unused lanes are still filtered, keep them at zero. */
+        for (int lane = lanes_num; lane < LANES_NUM; lane++) {
+          line_samples[lane] = 0.0;
+        }
+      }
+
+      filter_lines(lines.data(), length, coefficients);
+
+      for (const int64_t i : IndexRange(length)) {
+        float *samples = data + i * sample_stride;
+        const double *line_samples = &lines[i * LANES_NUM];
+        for (int lane = 0; lane < lanes_num; lane++) {
+          samples[offsets[lane]] = float(line_samples[lane]);
+        }
+      }
+    }
+  });
+}
+
+void recursive_gaussian_blur(MemoryBuffer &buffer, const float2 sigma, const IndexRange channels)
+{
+  BLI_assert(!buffer.is_a_single_elem());
+  BLI_assert(channels.one_after_last() <= buffer.get_num_channels());
+
+  const int width = buffer.get_width();
+  const int height = buffer.get_height();
+  float *data = buffer.get_buffer();
+
+  /* Values less than 0.5 are not valid, though can have a possibly useful sort of sharpening
+   * effect. The boundary initialization needs at least 3 pixels. */
+  if (sigma.x >= 0.5f && width >= 3) {
+    blur_lines(data, height, buffer.row_stride, width, buffer.elem_stride, channels, sigma.x);
+  }
+  if (sigma.y >= 0.5f && height >= 3) {
+    blur_lines(data, width, buffer.elem_stride, height, buffer.row_stride, channels, sigma.y);
+  }
+}
+
+void recursive_gaussian_blur(MemoryBuffer &buffer, const float2 sigma)
+{
+  recursive_gaussian_blur(buffer, sigma, IndexRange(buffer.get_num_channels()));
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,33 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Blur the given \a channels of \a buffer in place with a recursive approximation of a Gaussian
+ * filter, horizontally with `sigma.x` and vertically with `sigma.y`. A sigma less than 0.5 skips
+ * blurring in its direction, as do buffers smaller than 3 pixels in that direction.
+ *
+ * This is the third order IIR filter from "Recursive Gabor Filtering" by Young and van Vliet, with
+ * the boundary initialization from Triggs and Sdika, meaning pixels outside of the buffer are
+ * assumed to be the closest pixel inside. The cost per pixel doesn't depend on sigma.
+ *
+ * Lines are filtered in parallel, several at once: every step of the recursion is computed for a
+ * block of adjacent channels and lines, such that it vectorizes across them.
+ */
+void recursive_gaussian_blur(MemoryBuffer &buffer, float2 sigma, IndexRange channels);
+
+/**
+ * Same as above, for all channels of the buffer.
+ */
+void recursive_gaussian_blur(MemoryBuffer &buffer, float2 sigma);
+
+}  // namespace blender::compositor
@@ -0,0 +1,230 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <mutex>
+
+#include "BLI_hash.hh"
+#include "BLI_memory_counter.hh"
+
+#include "BKE_image.h"
+#include "BKE_image_partial_update.hh"
+
+#include "DNA_image_types.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_ResultCache.h"
+#include "COM_SharedOperationBuffers.h"
+
+namespace blender::compositor {
+
+/* -------------------------------------------------------------------- */
+/** \name Cached Results
+ * \{ */
+
+uint64_t OperationResultKey::hash() const
+{
+  uint64_t hash = content.hash;
+  for (const rcti &area : areas) {
+    hash = get_default_hash(
+        hash, get_default_hash(area.xmin, area.xmax), get_default_hash(area.ymin, area.ymax));
+  }
+  return hash;
+}
+
+bool OperationResultKey::equal_to(const GenericKey &other) const
+{
+  if (const auto *other_typed = dynamic_cast<const OperationResultKey *>(&other)) {
+    if (content != other_typed->content || areas.size() != other_typed->areas.size()) {
+      return false;
+    }
+    for (const int i : areas.index_range()) {
+      if (!BLI_rcti_compare(&areas[i], &other_typed->areas[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+std::unique_ptr<GenericKey> OperationResultKey::to_storable() const
+{
+  return std::make_unique<OperationResultKey>(*this);
+}
+
+CachedOperationResult::CachedOperationResult(std::unique_ptr<MemoryBuffer> buffer)
+    : buffer(std::move(buffer))
+{
+}
+
+CachedOperationResult::~CachedOperationResult() = default;
+
+void CachedOperationResult::count_memory(MemoryCounter &memory) const
+{
+  memory.add(int64_t(buffer->get_memory_width()) * buffer->get_memory_height() *
+             buffer->get_num_channels() * sizeof(float));
+}
+
+const NodeOperationContentKey *ResultCache::ensure_content_key(NodeOperation &op)
+{
+  if (!content_keys_.contains(&op)) {
+    std::optional<NodeOperationContentKey> content_key = op.generate_content_key(
+        [&](NodeOperation &input) -> std::optional<size_t> {
+          const NodeOperationContentKey *input_key = this->ensure_content_key(input);
+          if (!input_key) {
+            return std::nullopt;
+          }
+          return input_key->hash;
+        });
+    content_keys_.add_new(&op, std::move(content_key));
+  }
+  /* The pointer is only valid until more keys are added. */
+  const std::optional<NodeOperationContentKey> &content_key = content_keys_.lookup(&op);
+  return content_key ? &*content_key : nullptr;
+}
+
+void ResultCache::acquire_cached_results(const Span<NodeOperation *> operations,
+                                         SharedOperationBuffers &shared_buffers)
+{
+  content_keys_.clear();
+  operations_to_cache_.clear();
+
+  for (NodeOperation *reader : operations) {
+    if (ensure_content_key(*reader)) {
+      continue;
+    }
+
+    for (const int i : IndexRange(reader->get_number_of_input_sockets())) {
+      NodeOperation *op = reader->get_input_operation(i);
+      if (op->get_flags().is_constant_operation || op->get_width() == 0 ||
+          op->get_height() == 0 || operations_to_cache_.contains(op) ||
+          shared_buffers.is_operation_rendered(op))
+      {
+        continue;
+      }
+
+      const NodeOperationContentKey *content_key = ensure_content_key(*op);
+      if (!content_key) {
+        continue;
+      }
+
+      OperationResultKey key;
+      key.content = *content_key;
+      key.areas = shared_buffers.get_areas_to_render(op, 0, 0);
+      if (key.areas.is_empty()) {
+        continue;
+      }
+
+      std::shared_ptr<const CachedOperationResult> result =
+          memory_cache::find<CachedOperationResult>(key);
+      if (result) {
+        shared_buffers.set_cached_buffer(op, std::move(result));
+      }
+      else {
+        operations_to_cache_.add_new(op, std::move(key));
+      }
+    }
+  }
+}
+
+bool ResultCache::should_store_result(NodeOperation *op) const
+{
+  return operations_to_cache_.contains(op);
+}
+
+std::shared_ptr<const CachedOperationResult> ResultCache::store_result(
+    NodeOperation *op, std::unique_ptr<MemoryBuffer> buffer)
+{
+  const OperationResultKey &key = operations_to_cache_.lookup(op);
+  /* If an equal result was stored in the meantime by another execution, given buffer is freed
+   * and the stored result is used instead. */
+  return memory_cache::get<CachedOperationResult>(
+      key, [&]() { return std::make_unique<CachedOperationResult>(std::move(buffer)); });
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Image Versions
+ *
+ * Image changes are detected with the image partial update mechanism, using a partial update
+ * user per image that is kept across executions.
+ * \{ */
+
+struct ImageVersion {
+  PartialUpdateUser *partial_update_user;
+  uint64_t version;
+  bool is_used;
+};
+
+struct ImageVersions {
+  std::mutex mutex;
+  /** Keyed by #ID::session_uid, so freed images are never confused with new ones. */
+  Map<uint32_t, ImageVersion> versions;
+  /**
+   * Versions are unique across images, so that the version of an image whose partial update user
+   * was freed in the meantime never matches one of its older versions.
+   */
+  uint64_t last_version = 0;
+};
+
+static ImageVersions &get_image_versions()
+{
+  static ImageVersions image_versions;
+  return image_versions;
+}
+
+uint64_t ResultCache::get_image_version(Image *image)
+{
+  using namespace bke::image::partial_update;
+
+  ImageVersions &image_versions = get_image_versions();
+  std::scoped_lock lock(image_versions.mutex);
+  ImageVersion &image_version = image_versions.versions.lookup_or_add_cb(
+      image->id.session_uid, [&]() {
+        return ImageVersion{BKE_image_partial_update_create(image), 0, false};
+      });
+  if (BKE_image_partial_update_collect_changes(image, image_version.partial_update_user) !=
+      ePartialUpdateCollectResult::NoChangesDetected)
+  {
+    image_version.version = ++image_versions.last_version;
+  }
+  image_version.is_used = true;
+  return image_version.version;
+}
+
+void ResultCache::free_unused_image_versions()
+{
+  ImageVersions &image_versions = get_image_versions();
+  std::scoped_lock lock(image_versions.mutex);
+  image_versions.versions.remove_if([](auto item) {
+    if (!item.value.is_used) {
+      BKE_image_partial_update_free(item.value.partial_update_user);
+      return true;
+    }
+    return false;
+  });
+  for (ImageVersion &image_version : image_versions.versions.values()) {
+    image_version.is_used = false;
+  }
+}
+
+void ResultCache::free_all()
+{
+  memory_cache::remove_if([](const GenericKey &key) {
+    return dynamic_cast<const OperationResultKey *>(&key) != nullptr;
+  });
+
+  ImageVersions &image_versions = get_image_versions();
+  std::scoped_lock lock(image_versions.mutex);
+  for (ImageVersion &image_version : image_versions.versions.values()) {
+    BKE_image_partial_update_free(image_version.partial_update_user);
+  }
+  image_versions.versions.clear_and_shrink();
+}
+
+/** \} */
+
+}  // namespace blender::compositor
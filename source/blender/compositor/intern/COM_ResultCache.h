@@ -0,0 +1,119 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "BLI_map.hh"
+#include "BLI_memory_cache.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_vec_types.h"
+
+#include "COM_NodeOperation.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+struct Image;
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+class SharedOperationBuffers;
+
+/**
+ * Rendered operation buffer stored in the global #memory_cache. It's shared by all executions
+ * that use it and must not be modified.
+ */
+class CachedOperationResult : public memory_cache::CachedValue {
+ public:
+  std::unique_ptr<MemoryBuffer> buffer;
+
+  CachedOperationResult(std::unique_ptr<MemoryBuffer> buffer);
+  ~CachedOperationResult();
+
+  void count_memory(MemoryCounter &memory) const override;
+};
+
+/**
+ * Identifies the result of an operation by its content and the areas it renders.
+ */
+class OperationResultKey : public GenericKey {
+ public:
+  NodeOperationContentKey content;
+  Vector<rcti> areas;
+
+  uint64_t hash() const override;
+  bool equal_to(const GenericKey &other) const override;
+  std::unique_ptr<GenericKey> to_storable() const override;
+};
+
+/**
+ * Reuses operations results across executions, e.g. across interactive edits of the node tree and
+ * across animation frames with static inputs.
+ *
+ * Results are keyed by their content: the operation parameters, the areas it renders and
+ * recursively the content of its inputs (see #NodeOperation::generate_content_key). Only the
+ * results of cacheable operations read by operations that aren't cacheable are stored, reusing
+ * them skips rendering all the cacheable operations they depend on.
+ */
+class ResultCache {
+ private:
+  /** Content key of every operation, `std::nullopt` when it's not cacheable. */
+  Map<NodeOperation *, std::optional<NodeOperationContentKey>> content_keys_;
+  /** Operations whose result is stored once rendered. */
+  Map<NodeOperation *, OperationResultKey> operations_to_cache_;
+
+ public:
+  /**
+   * Determines the operations to cache and sets the buffers of the ones already cached as
+   * rendered. Must be called once the areas to render are registered and before the reads are.
+   */
+  void acquire_cached_results(Span<NodeOperation *> operations,
+                              SharedOperationBuffers &shared_buffers);
+
+  /**
+   * Whether given operation result should be stored with #store_result once rendered.
+   */
+  bool should_store_result(NodeOperation *op) const;
+
+  /**
+   * Stores given operation rendered buffer, ownership is transferred to the returned cached
+   * result.
+   */
+  std::shared_ptr<const CachedOperationResult> store_result(NodeOperation *op,
+                                                            std::unique_ptr<MemoryBuffer> buffer);
+
+  /**
+   * Get a version of the image pixels which changes whenever they are modified, e.g. by painting
+   * or reloading. Meant to be hashed by operations reading images.
+   */
+  static uint64_t get_image_version(Image *image);
+
+  /**
+   * Free the image versions of images that weren't used since the last call, e.g. because the
+   * images were freed. Their results can't be reused afterwards.
+   */
+  static void free_unused_image_versions();
+
+  /**
+   * Free all cached results and image versions.
+   */
+  static void free_all();
+
+ private:
+  /** Get the content key of given operation, null when it's not cacheable. */
+  const NodeOperationContentKey *ensure_content_key(NodeOperation &op);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:ResultCache")
+#endif
+};
+
+}  // namespace blender::compositor
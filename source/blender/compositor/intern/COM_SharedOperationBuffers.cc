@@ -3,7 +3,9 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "COM_SharedOperationBuffers.h"
+#include "COM_MemoryBuffer.h"
 #include "COM_NodeOperation.h"
+#include "COM_ResultCache.h"
 
 namespace blender::compositor {
 
@@ -12,6 +14,11 @@ SharedOperationBuffers::BufferData::BufferData()
 {
 }
 
+void SharedOperationBuffers::set_storage(const MemoryBufferStorage storage)
+{
+  storage_ = storage;
+}
+
 SharedOperationBuffers::BufferData &SharedOperationBuffers::get_buffer_data(NodeOperation *op)
 {
   return buffers_.lookup_or_add_cb(op, []() { return BufferData(); });
@@ -72,12 +79,56 @@ void SharedOperationBuffers::set_rendered_buffer(NodeOperation *op,
   BLI_assert(buf_data.buffer == nullptr);
   buf_data.buffer = std::move(buffer);
   buf_data.is_rendered = true;
+  if (buf_data.buffer) {
+    unpacked_ops_.append(op);
+  }
+}
+
+void SharedOperationBuffers::set_cached_buffer(NodeOperation *op,
+                                               std::shared_ptr<const CachedOperationResult> result)
+{
+  BufferData &buf_data = get_buffer_data(op);
+  BLI_assert(buf_data.received_reads == 0);
+  BLI_assert(buf_data.buffer == nullptr);
+  /* The cached buffer is only read, use a view of it so that it's never packed nor freed. */
+  MemoryBuffer &cached_buffer = *result->buffer;
+  buf_data.buffer = std::make_unique<MemoryBuffer>(cached_buffer.get_buffer(),
+                                                   cached_buffer.get_num_channels(),
+                                                   cached_buffer.get_rect(),
+                                                   cached_buffer.is_a_single_elem());
+  buf_data.cached_result = std::move(result);
+  buf_data.is_rendered = true;
 }
 
 MemoryBuffer *SharedOperationBuffers::get_rendered_buffer(NodeOperation *op)
 {
   BLI_assert(is_operation_rendered(op));
-  return get_buffer_data(op).buffer.get();
+  MemoryBuffer *buffer = get_buffer_data(op).buffer.get();
+  if (buffer && buffer->is_packed()) {
+    buffer->unpack();
+    unpacked_ops_.append(op);
+  }
+  return buffer;
+}
+
+void SharedOperationBuffers::pack_unread_buffers(NodeOperation *read_op)
+{
+  if (storage_ == MemoryBufferStorage::Float) {
+    return;
+  }
+
+  unpacked_ops_.remove_if([&](NodeOperation *op) {
+    for (int i = 0; i < read_op->get_number_of_input_sockets(); i++) {
+      if (read_op->get_input_operation(i) == op) {
+        return false;
+      }
+    }
+    MemoryBuffer *buffer = get_buffer_data(op).buffer.get();
+    if (buffer) {
+      buffer->pack(storage_);
+    }
+    return true;
+  });
 }
 
 void SharedOperationBuffers::read_finished(NodeOperation *read_op)
@@ -88,6 +139,11 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   if (buf_data.received_reads == buf_data.registered_reads) {
     /* Dispose buffer. */
     buf_data.buffer = nullptr;
+    buf_data.cached_result = nullptr;
+    const int64_t unpacked_index = unpacked_ops_.first_index_of_try(read_op);
+    if (unpacked_index != -1) {
+      unpacked_ops_.remove_and_reorder(unpacked_index);
+    }
   }
 }
 
@@ -9,12 +9,15 @@
 
 #include "DNA_vec_types.h"
 
+#include "COM_Enums.h"
+
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
 
 namespace blender::compositor {
 
+class CachedOperationResult;
 class MemoryBuffer;
 class NodeOperation;
 
@@ -28,6 +31,8 @@ class SharedOperationBuffers {
    public:
     BufferData();
     std::unique_ptr<MemoryBuffer> buffer;
+    /** Owner of the buffer data when it's shared with the result cache. */
+    std::shared_ptr<const CachedOperationResult> cached_result;
     blender::Vector<rcti> render_areas;
     int registered_reads;
     int received_reads;
@@ -35,7 +40,17 @@ class SharedOperationBuffers {
   } BufferData;
   blender::Map<NodeOperation *, BufferData> buffers_;
 
+  /** How rendered buffers are stored while waiting to be read. */
+  MemoryBufferStorage storage_ = MemoryBufferStorage::Float;
+  /** Operations with a rendered buffer which has float data in memory and may be packed. */
+  blender::Vector<NodeOperation *> unpacked_ops_;
+
  public:
+  /**
+   * Sets how rendered buffers are stored while waiting to be read.
+   */
+  void set_storage(MemoryBufferStorage storage);
+
   /**
    * Whether given operation area to render is already registered.
    */
@@ -68,10 +83,20 @@ class SharedOperationBuffers {
    */
   void set_rendered_buffer(NodeOperation *op, std::unique_ptr<MemoryBuffer> buffer);
   /**
-   * Get given operation rendered buffer.
+   * Stores given operation result from the result cache as its rendered buffer.
+   */
+  void set_cached_buffer(NodeOperation *op, std::shared_ptr<const CachedOperationResult> result);
+  /**
+   * Get given operation rendered buffer. It's unpacked if needed.
    */
   MemoryBuffer *get_rendered_buffer(NodeOperation *op);
 
+  /**
+   * Packs the rendered buffers given operation doesn't read, so that only the buffers being
+   * read are kept as float data in memory.
+   */
+  void pack_unread_buffers(NodeOperation *read_op);
+
   /**
    * Reports an operation has finished reading given operation. If all given operation dependencies
    * have finished its buffer will be disposed.
@@ -13,6 +13,7 @@
 #include "BKE_scene.hh"
 
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.hh"
 
@@ -107,6 +108,7 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    blender::compositor::ResultCache::free_all();
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
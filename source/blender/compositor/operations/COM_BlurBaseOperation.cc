@@ -49,6 +49,15 @@ void BlurBaseOperation::init_data()
   }
 }
 
+void BlurBaseOperation::hash_output_params()
+{
+  hash_params(data_.sizex, data_.sizey, data_.filtertype);
+  hash_params(data_.relative, data_.aspect, data_.fac);
+  hash_params(data_.percentx, data_.percenty, int(data_.gamma));
+  hash_params(size_, sizeavailable_, extend_bounds_);
+  hash_param(use_variable_size_);
+}
+
 float *BlurBaseOperation::make_gausstab(float rad, int size)
 {
   float *gausstab, sum, val;
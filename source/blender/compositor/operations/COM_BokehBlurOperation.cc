@@ -7,6 +7,8 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "COM_ConstantOperation.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_FFTConvolution.h"
 
 namespace blender::compositor {
 
@@ -96,6 +98,59 @@ void BokehBlurOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+/* Weight of the pixel at the given offset from the blurred pixel, sampled from the bokeh image. */
+static float4 get_bokeh_weight(const MemoryBuffer *bokeh_input,
+                               const int radius,
+                               const int xi,
+                               const int yi)
+{
+  const int2 bokeh_size = int2(bokeh_input->get_width(), bokeh_input->get_height());
+  const float2 normalized_texel = (float2(xi, yi) + radius + 0.5f) / (radius * 2.0f + 1.0f);
+  const float2 weight_texel = (1.0f - normalized_texel) * float2(bokeh_size - 1);
+  return float4(bokeh_input->get_elem(int(weight_texel.x), int(weight_texel.y)));
+}
+
+void BokehBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                              const rcti &area,
+                                              Span<MemoryBuffer *> inputs)
+{
+  const float max_dim = std::max(this->get_width(), this->get_height());
+  const int radius = size_ * max_dim / 100.0f;
+
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  if (image_input->is_a_single_elem() || !use_fft_convolution(int2(radius))) {
+    MultiThreadedOperation::update_memory_buffer(output, area, inputs);
+    return;
+  }
+
+  /* The kernel is the same for all pixels, so large ones are convolved in the frequency domain. */
+  const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  MemoryBuffer kernel(DataType::Color, radius * 2 + 1, radius * 2 + 1);
+  for (int yi = -radius; yi <= radius; ++yi) {
+    for (int xi = -radius; xi <= radius; ++xi) {
+      const float4 weight = get_bokeh_weight(bokeh_input, radius, xi, yi);
+      copy_v4_v4(kernel.get_elem(xi + radius, yi + radius), weight);
+    }
+  }
+  fft_convolve(*image_input, kernel, FFTConvolutionBoundary::Extend, *output, area);
+
+  /* Pixels outside of the bounding box are not blurred. */
+  MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
+  if (bounding_input->is_a_single_elem() && *bounding_input->get_elem(0, 0) > 0.0f) {
+    return;
+  }
+  exec_system_->execute_work(area, [=](const rcti &split_rect) {
+    for (BuffersIterator<float> it = output->iterate_with({bounding_input}, split_rect);
+         !it.is_end();
+         ++it)
+    {
+      if (*it.in(0) <= 0.0f) {
+        image_input->read_elem(it.x, it.y, it.out);
+      }
+    }
+  });
+}
+
 void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                       const rcti &area,
                                                       Span<MemoryBuffer *> inputs)
@@ -105,7 +160,6 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
 
   const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
   const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
-  const int2 bokeh_size = int2(bokeh_input->get_width(), bokeh_input->get_height());
   MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
   BuffersIterator<float> it = output->iterate_with({bounding_input}, area);
   for (; !it.is_end(); ++it) {
@@ -121,9 +175,7 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
     float4 accumulated_weight = float4(0.0f);
     for (int yi = -radius; yi <= radius; ++yi) {
       for (int xi = -radius; xi <= radius; ++xi) {
-        const float2 normalized_texel = (float2(xi, yi) + radius + 0.5f) / (radius * 2.0f + 1.0f);
-        const float2 weight_texel = (1.0f - normalized_texel) * float2(bokeh_size - 1);
-        const float4 weight = bokeh_input->get_elem(int(weight_texel.x), int(weight_texel.y));
+        const float4 weight = get_bokeh_weight(bokeh_input, radius, xi, yi);
         const float4 color = float4(image_input->get_elem_clamped(x + xi, y + yi)) * weight;
         accumulated_color += color;
         accumulated_weight += weight;
@@ -15,6 +15,7 @@ ColorRampOperation::ColorRampOperation()
 
   color_band_ = nullptr;
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void ColorRampOperation::update_memory_buffer_partial(MemoryBuffer *output,
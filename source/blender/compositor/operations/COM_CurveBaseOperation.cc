@@ -12,6 +12,7 @@ CurveBaseOperation::CurveBaseOperation()
 {
   curve_mapping_ = nullptr;
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 CurveBaseOperation::~CurveBaseOperation()
@@ -13,6 +13,7 @@ DotproductOperation::DotproductOperation()
   this->add_output_socket(DataType::Value);
   this->set_canvas_input_index(0);
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void DotproductOperation::update_memory_buffer_partial(MemoryBuffer *output,
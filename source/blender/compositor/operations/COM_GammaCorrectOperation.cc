@@ -11,6 +11,7 @@ GammaCorrectOperation::GammaCorrectOperation()
   this->add_input_socket(DataType::Color);
   this->add_output_socket(DataType::Color);
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void GammaCorrectOperation::update_memory_buffer_partial(MemoryBuffer *output,
@@ -46,6 +47,7 @@ GammaUncorrectOperation::GammaUncorrectOperation()
   this->add_input_socket(DataType::Color);
   this->add_output_socket(DataType::Color);
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void GammaUncorrectOperation::update_memory_buffer_partial(MemoryBuffer *output,
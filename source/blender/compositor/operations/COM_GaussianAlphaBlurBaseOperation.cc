@@ -23,6 +23,12 @@ void GaussianAlphaBlurBaseOperation::init_data()
   filtersize_ = min_ii(ceil(rad_), MAX_GAUSSTAB_RADIUS);
 }
 
+void GaussianAlphaBlurBaseOperation::hash_output_params()
+{
+  BlurBaseOperation::hash_output_params();
+  hash_params(falloff_, do_subtract_);
+}
+
 void GaussianAlphaBlurBaseOperation::init_execution()
 {
   BlurBaseOperation::init_execution();
@@ -18,6 +18,8 @@ class GaussianAlphaBlurBaseOperation : public BlurBaseOperation {
   float rad_;
   eDimension dimension_;
 
+  void hash_output_params() override;
+
  public:
   GaussianAlphaBlurBaseOperation(eDimension dim);
 
@@ -2,10 +2,19 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "COM_ExecutionSystem.h"
 #include "COM_GaussianBlurBaseOperation.h"
+#include "COM_RecursiveGaussianBlur.h"
 
 namespace blender::compositor {
 
+/**
+ * Gaussian filters of at least this radius are blurred with a recursive filter, whose cost doesn't
+ * depend on the radius. Smaller ones are cheaper to convolve with the explicit weights, which
+ * are also exact rather than an approximation.
+ */
+static constexpr int RECURSIVE_BLUR_MIN_RADIUS = 16;
+
 GaussianBlurBaseOperation::GaussianBlurBaseOperation(eDimension dim)
     : BlurBaseOperation(DataType::Color)
 {
@@ -16,6 +25,7 @@ GaussianBlurBaseOperation::GaussianBlurBaseOperation(eDimension dim)
   filtersize_ = 0;
   rad_ = 0.0f;
   dimension_ = dim;
+  use_recursive_ = false;
 }
 
 void GaussianBlurBaseOperation::init_data()
@@ -24,6 +34,7 @@ void GaussianBlurBaseOperation::init_data()
   rad_ = max_ff(size_ * this->get_blur_size(dimension_), 0.0f);
   rad_ = min_ff(rad_, MAX_GAUSSTAB_RADIUS);
   filtersize_ = min_ii(ceil(rad_), MAX_GAUSSTAB_RADIUS);
+  use_recursive_ = data_.filtertype == R_FILTER_GAUSS && filtersize_ >= RECURSIVE_BLUR_MIN_RADIUS;
 }
 
 void GaussianBlurBaseOperation::init_execution()
@@ -61,6 +72,22 @@ void GaussianBlurBaseOperation::get_area_of_interest(const int input_idx,
   }
 
   r_input_area = output_area;
+  if (use_recursive_) {
+    /* The recursive filter reads whole lines of the input. */
+    const rcti &input_canvas = get_input_operation(IMAGE_INPUT_INDEX)->get_canvas();
+    switch (dimension_) {
+      case eDimension::X:
+        r_input_area.xmin = input_canvas.xmin;
+        r_input_area.xmax = input_canvas.xmax;
+        break;
+      case eDimension::Y:
+        r_input_area.ymin = input_canvas.ymin;
+        r_input_area.ymax = input_canvas.ymax;
+        break;
+    }
+    return;
+  }
+
   switch (dimension_) {
     case eDimension::X:
       r_input_area.xmin = output_area.xmin - filtersize_ - 1;
@@ -73,6 +100,46 @@ void GaussianBlurBaseOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+void GaussianBlurBaseOperation::update_memory_buffer(MemoryBuffer *output,
+                                                     const rcti &area,
+                                                     Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  if (!use_recursive_ || input->is_a_single_elem()) {
+    MultiThreadedOperation::update_memory_buffer(output, area, inputs);
+    return;
+  }
+
+  /* Blur whole lines covering both the area and the input. Pixels outside of the input are the
+   * closest pixel inside, like with the explicit weights. */
+  const rcti &input_rect = input->get_rect();
+  rcti lines_rect = area;
+  switch (dimension_) {
+    case eDimension::X:
+      lines_rect.xmin = min_ii(area.xmin, input_rect.xmin);
+      lines_rect.xmax = max_ii(area.xmax, input_rect.xmax);
+      break;
+    case eDimension::Y:
+      lines_rect.ymin = min_ii(area.ymin, input_rect.ymin);
+      lines_rect.ymax = max_ii(area.ymax, input_rect.ymax);
+      break;
+  }
+
+  MemoryBuffer lines(DataType::Color, lines_rect);
+  exec_system_->execute_work(lines_rect, [&](const rcti &split_rect) {
+    for (BuffersIterator<float> it = lines.iterate_with({}, split_rect); !it.is_end(); ++it) {
+      copy_v4_v4(it.out, input->get_elem_clamped(it.x, it.y));
+    }
+  });
+
+  /* The filter is truncated at three standard deviations, see #RE_filter_value. */
+  const float sigma = rad_ / 3.0f;
+  recursive_gaussian_blur(lines,
+                          dimension_ == eDimension::X ? float2(sigma, 0.0f) : float2(0.0f, sigma));
+
+  output->copy_from(&lines, area);
+}
+
 void GaussianBlurBaseOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                              const rcti &area,
                                                              Span<MemoryBuffer *> inputs)
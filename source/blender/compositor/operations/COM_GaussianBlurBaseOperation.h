@@ -17,6 +17,8 @@ class GaussianBlurBaseOperation : public BlurBaseOperation {
   int filtersize_;
   float rad_;
   eDimension dimension_;
+  /** Large Gaussian filters are blurred with a recursive filter, see #update_memory_buffer. */
+  bool use_recursive_;
 
  public:
   GaussianBlurBaseOperation(eDimension dim);
@@ -26,6 +28,9 @@ class GaussianBlurBaseOperation : public BlurBaseOperation {
   virtual void deinit_execution() override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override;
   virtual void update_memory_buffer_partial(MemoryBuffer *output,
                                             const rcti &area,
                                             Span<MemoryBuffer *> inputs) override;
@@ -7,6 +7,7 @@
 #include "BLI_index_range.hh"
 #include "BLI_math_vector.hh"
 
+#include "COM_FFTConvolution.h"
 #include "COM_GaussianBokehBlurOperation.h"
 
 #include "RE_pipeline.h"
@@ -112,6 +113,24 @@ void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
   r_input_area.ymin = output_area.ymin - rady_;
 }
 
+void GaussianBokehBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  if (gausstab_ == nullptr || input->is_a_single_elem() ||
+      !use_fft_convolution(int2(radx_, rady_)))
+  {
+    MultiThreadedOperation::update_memory_buffer(output, area, inputs);
+    return;
+  }
+
+  /* The filter is the same for all pixels, so large ones are convolved in the frequency domain.
+   * Pixels outside of the input are skipped, like in the spatial domain. */
+  const MemoryBuffer kernel(gausstab_, 1, radx_ * 2 + 1, rady_ * 2 + 1);
+  fft_convolve(*input, kernel, FFTConvolutionBoundary::Zero, *output, area);
+}
+
 void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                               const rcti &area,
                                                               Span<MemoryBuffer *> inputs)
@@ -6,6 +6,8 @@
 
 #include "BKE_scene.hh"
 
+#include "COM_ResultCache.h"
+
 #include "IMB_colormanagement.hh"
 #include "IMB_interp.hh"
 
@@ -76,6 +78,28 @@ void BaseImageOperation::determine_canvas(const rcti & /*preferred_area*/, rcti
   BKE_image_release_ibuf(image_, stackbuf, nullptr);
 }
 
+void BaseImageOperation::hash_output_params()
+{
+  if (image_ == nullptr) {
+    return;
+  }
+  if (image_->source == IMA_SRC_VIEWER) {
+    /* Render results and viewer images aren't tracked by image versions, don't hash them so
+     * their results are never cached. */
+    NodeOperation::hash_output_params();
+    return;
+  }
+
+  hash_params(image_->id.session_uid, ResultCache::get_image_version(image_));
+  /* Still images are the same for any frame. */
+  if (BKE_image_is_animated(image_)) {
+    hash_param(image_user_.framenr);
+  }
+  hash_params(image_user_.layer, image_user_.pass, image_user_.view);
+  hash_params(int(image_->alpha_mode), StringRef(image_->colorspace_settings.name));
+  hash_param(StringRef(view_name_ ? view_name_ : ""));
+}
+
 void ImageOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                   const rcti &area,
                                                   Span<MemoryBuffer *> /*inputs*/)
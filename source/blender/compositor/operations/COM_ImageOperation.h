@@ -38,6 +38,8 @@ class BaseImageOperation : public MultiThreadedOperation {
    */
   void determine_canvas(const rcti &preferred_area, rcti &r_area) override;
 
+  void hash_output_params() override;
+
   virtual ImBuf *get_im_buf();
 
  public:
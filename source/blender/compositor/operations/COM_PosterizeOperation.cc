@@ -12,6 +12,7 @@ PosterizeOperation::PosterizeOperation()
   this->add_input_socket(DataType::Value);
   this->add_output_socket(DataType::Color);
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void PosterizeOperation::update_memory_buffer_partial(MemoryBuffer *output,
@@ -7,6 +7,7 @@
 #include "BLI_math_interp.hh"
 #include "BLI_string.h"
 
+#include "BKE_global.hh"
 #include "BKE_image.h"
 
 namespace blender::compositor {
@@ -90,6 +91,29 @@ void RenderLayersProg::determine_canvas(const rcti & /*preferred_area*/, rcti &r
   }
 }
 
+void RenderLayersProg::hash_output_params()
+{
+  if (G.is_rendering) {
+    /* The render result may be incomplete, e.g. when the node tree is executed for the viewer
+     * during a render, and it has the same start time once the render is done. Don't hash it so
+     * that the result is never reused. */
+    NodeOperation::hash_output_params();
+    return;
+  }
+
+  Scene *scene = this->get_scene();
+  Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
+  if (re) {
+    /* Identify the render result by the start time of its render as well, the result of a
+     * following render may be allocated at the same address. */
+    const RenderResult *rr = RE_AcquireResultRead(re);
+    hash_params(rr, RE_GetStats(re)->starttime);
+    RE_ReleaseResult(re);
+  }
+  hash_params(layer_id_, pass_name_, elementsize_);
+  hash_param(StringRef(view_name_ ? view_name_ : ""));
+}
+
 std::unique_ptr<MetaData> RenderLayersProg::get_meta_data()
 {
   Scene *scene = this->get_scene();
@@ -5,6 +5,8 @@
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 
+#include "COM_ExecutionSystem.h"
+#include "COM_FFTConvolution.h"
 #include "COM_VariableSizeBokehBlurOperation.h"
 
 namespace blender::compositor {
@@ -70,6 +72,67 @@ void VariableSizeBokehBlurOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+void VariableSizeBokehBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                                          const rcti &area,
+                                                          Span<MemoryBuffer *> inputs)
+{
+  MemoryBuffer *input_buffer = inputs[0];
+  MemoryBuffer *bokeh_buffer = inputs[1];
+  MemoryBuffer *size_buffer = inputs[2];
+  MemoryBuffer *mask_buffer = inputs[3];
+
+  const float max_dim = std::max(get_width(), get_height());
+  const float base_size = do_size_scale_ ? (max_dim / 100.0f) : 1.0f;
+  const float size = math::max(0.0f, *size_buffer->get_elem(0, 0) * base_size);
+  const int search_radius = math::clamp(int(size), 0, max_blur_);
+
+  /* With a single size, all pixels are blurred with the same kernel, so large ones are convolved
+   * in the frequency domain. Otherwise the kernel varies per pixel. */
+  if (!size_buffer->is_a_single_elem() || input_buffer->is_a_single_elem() ||
+      size < threshold_ || !use_fft_convolution(int2(search_radius)))
+  {
+    MultiThreadedOperation::update_memory_buffer(output, area, inputs);
+    return;
+  }
+
+  MemoryBuffer kernel(DataType::Color, search_radius * 2 + 1, search_radius * 2 + 1);
+  for (int yi = -search_radius; yi <= search_radius; ++yi) {
+    for (int xi = -search_radius; xi <= search_radius; ++xi) {
+      float4 weight = float4(0.0f);
+      if (xi == 0 && yi == 0) {
+        weight = float4(1.0f);
+      }
+      else if (math::max(math::abs(xi), math::abs(yi)) <= size) {
+        const float2 normalized_texel = (float2(xi, yi) + size + 0.5f) / (size * 2.0f + 1.0f);
+        const float2 weight_texel = 1.0f - normalized_texel;
+        weight = bokeh_buffer->texture_bilinear_extend(weight_texel);
+      }
+      copy_v4_v4(kernel.get_elem(xi + search_radius, yi + search_radius), weight);
+    }
+  }
+  fft_convolve(*input_buffer, kernel, FFTConvolutionBoundary::Extend, *output, area);
+
+  const bool use_mask = !mask_buffer->is_a_single_elem() || *mask_buffer->get_elem(0, 0) <= 0.0f;
+  const bool use_blend = (size > threshold_) && (size < threshold_ * 2.0f);
+  if (!use_mask && !use_blend) {
+    return;
+  }
+  exec_system_->execute_work(area, [=](const rcti &split_rect) {
+    for (BuffersIterator<float> it = output->iterate_with({}, split_rect); !it.is_end(); ++it) {
+      if (*mask_buffer->get_elem(it.x, it.y) <= 0.0f) {
+        copy_v4_v4(it.out, input_buffer->get_elem(it.x, it.y));
+        continue;
+      }
+
+      /* blend in out values over the threshold, otherwise we get sharp, ugly transitions */
+      if (use_blend) {
+        const float fac = (size - threshold_) / threshold_;
+        interp_v4_v4v4(it.out, input_buffer->get_elem(it.x, it.y), it.out, fac);
+      }
+    }
+  });
+}
+
 void VariableSizeBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                                   const rcti &area,
                                                                   Span<MemoryBuffer *> inputs)
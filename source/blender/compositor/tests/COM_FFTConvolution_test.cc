@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_math_vector.hh"
+
+#include "COM_FFTConvolution.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+static void fill_image(MemoryBuffer &image)
+{
+  const rcti &rect = image.get_rect();
+  for (int y = rect.ymin; y < rect.ymax; y++) {
+    for (int x = rect.xmin; x < rect.xmax; x++) {
+      float *color = image.get_elem(x, y);
+      color[0] = float((x * 7 + y * 3) % 11) / 11.0f;
+      color[1] = float((x * y) % 5) / 5.0f;
+      color[2] = (x + y) % 2 ? 4.0f : 0.0f;
+      color[3] = 1.0f;
+    }
+  }
+}
+
+static void fill_kernel(MemoryBuffer &kernel)
+{
+  const int channels_num = kernel.get_num_channels();
+  for (int y = 0; y < kernel.get_height(); y++) {
+    for (int x = 0; x < kernel.get_width(); x++) {
+      for (int channel = 0; channel < channels_num; channel++) {
+        kernel.get_elem(x, y)[channel] = float(1 + (x * 3 + y + channel) % 4);
+      }
+    }
+  }
+}
+
+/* Reference convolution in the spatial domain. */
+static float4 convolve_pixel(const MemoryBuffer &image,
+                             const MemoryBuffer &kernel,
+                             const FFTConvolutionBoundary boundary,
+                             const int x,
+                             const int y)
+{
+  const int2 radius = int2(kernel.get_width(), kernel.get_height()) / 2;
+  const rcti &rect = image.get_rect();
+  float4 accumulated_color = float4(0.0f);
+  float4 accumulated_weight = float4(0.0f);
+  for (int yi = -radius.y; yi <= radius.y; yi++) {
+    for (int xi = -radius.x; xi <= radius.x; xi++) {
+      const float *weights = kernel.get_elem(xi + radius.x, yi + radius.y);
+      const float4 weight = kernel.get_num_channels() == 1 ? float4(weights[0]) :
+                                                             float4(weights);
+      const bool is_inside = x + xi >= rect.xmin && x + xi < rect.xmax && y + yi >= rect.ymin &&
+                             y + yi < rect.ymax;
+      if (boundary == FFTConvolutionBoundary::Zero && !is_inside) {
+        continue;
+      }
+      accumulated_color += float4(image.get_elem_clamped(x + xi, y + yi)) * weight;
+      accumulated_weight += weight;
+    }
+  }
+  return math::safe_divide(accumulated_color, accumulated_weight);
+}
+
+static void test_convolution(const int kernel_channels_num, const FFTConvolutionBoundary boundary)
+{
+  if (!use_fft_convolution(int2(8))) {
+    GTEST_SKIP() << "Built without FFTW";
+  }
+
+  MemoryBuffer image(DataType::Color, 61, 37);
+  fill_image(image);
+
+  const int2 radius = int2(9, 6);
+  MemoryBuffer kernel(kernel_channels_num == 1 ? DataType::Value : DataType::Color,
+                      radius.x * 2 + 1,
+                      radius.y * 2 + 1);
+  fill_kernel(kernel);
+
+  /* Output area partially outside of the image to test the boundary, but close enough for all
+   * pixels to be covered by the kernel. */
+  rcti area;
+  BLI_rcti_init(&area, -4, 50, 5, 42);
+  MemoryBuffer output(DataType::Color, area);
+  fft_convolve(image, kernel, boundary, output, area);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      const float4 expected = convolve_pixel(image, kernel, boundary, x, y);
+      const float *result = output.get_elem(x, y);
+      for (int channel = 0; channel < 4; channel++) {
+        EXPECT_NEAR(result[channel], expected[channel], 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(FFTConvolution, ZeroBoundarySingleChannelKernel)
+{
+  test_convolution(1, FFTConvolutionBoundary::Zero);
+}
+
+TEST(FFTConvolution, ZeroBoundaryColorKernel)
+{
+  test_convolution(4, FFTConvolutionBoundary::Zero);
+}
+
+TEST(FFTConvolution, ExtendBoundarySingleChannelKernel)
+{
+  test_convolution(1, FFTConvolutionBoundary::Extend);
+}
+
+TEST(FFTConvolution, ExtendBoundaryColorKernel)
+{
+  test_convolution(4, FFTConvolutionBoundary::Extend);
+}
+
+}  // namespace blender::compositor::tests
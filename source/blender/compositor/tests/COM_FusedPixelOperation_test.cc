@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "COM_FusedPixelOperation.h"
+
+namespace blender::compositor::tests {
+
+class InputOperation : public NodeOperation {
+ public:
+  InputOperation(const rcti &canvas)
+  {
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+  }
+};
+
+/** Adds one to its input. */
+class AddOneOperation : public MultiThreadedOperation {
+ public:
+  AddOneOperation(NodeOperation &input, const rcti &canvas)
+  {
+    add_input_socket(DataType::Value);
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+    flags_.can_be_fused = true;
+
+    get_input_socket(0)->set_link(input.get_output_socket());
+  }
+
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override
+  {
+    for (BuffersIterator<float> it = output->iterate_with(inputs, area); !it.is_end(); ++it) {
+      it.out[0] = it.in(0)[0] + 1.0f;
+    }
+  }
+};
+
+/** Multiplies its two inputs. */
+class MultiplyOperation : public MultiThreadedOperation {
+ public:
+  MultiplyOperation(NodeOperation &input_a, NodeOperation &input_b, const rcti &canvas)
+  {
+    add_input_socket(DataType::Value);
+    add_input_socket(DataType::Value);
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+    flags_.can_be_fused = true;
+
+    get_input_socket(0)->set_link(input_a.get_output_socket());
+    get_input_socket(1)->set_link(input_b.get_output_socket());
+  }
+
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override
+  {
+    for (BuffersIterator<float> it = output->iterate_with(inputs, area); !it.is_end(); ++it) {
+      it.out[0] = it.in(0)[0] * it.in(1)[0];
+    }
+  }
+};
+
+class TestFusedPixelOperation : public FusedPixelOperation {
+ public:
+  using FusedPixelOperation::FusedPixelOperation;
+  using FusedPixelOperation::update_memory_buffer_partial;
+};
+
+TEST(FusedPixelOperation, execute)
+{
+  /* Wide enough to be evaluated in multiple strips. */
+  const rcti area = {0, 20000, 0, 3};
+
+  InputOperation input(area);
+  AddOneOperation *add = new AddOneOperation(input, area);
+  MultiplyOperation *multiply = new MultiplyOperation(*add, input, area);
+  TestFusedPixelOperation fused({add, multiply});
+
+  /* Inputs read by several members are only added once. */
+  EXPECT_EQ(fused.get_number_of_input_sockets(), 1);
+  EXPECT_EQ(fused.get_input_links()[0], input.get_output_socket());
+  EXPECT_EQ(fused.get_output_socket()->get_data_type(), DataType::Value);
+  EXPECT_TRUE(BLI_rcti_compare(&fused.get_canvas(), &area));
+
+  MemoryBuffer input_buffer(DataType::Value, area);
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      *input_buffer.get_elem(x, y) = float(x % 7 + y);
+    }
+  }
+  MemoryBuffer output(DataType::Value, area);
+  fused.update_memory_buffer_partial(&output, area, {&input_buffer});
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      const float value = float(x % 7 + y);
+      EXPECT_FLOAT_EQ(*output.get_elem(x, y), (value + 1.0f) * value);
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
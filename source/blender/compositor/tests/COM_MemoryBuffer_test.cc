@@ -0,0 +1,80 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+/* Values exactly representable as half floats, so packing doesn't lose precision. */
+static float value_for_index(const int index)
+{
+  return (index % 2048) * 0.25f - 256.0f;
+}
+
+static void fill_buffer(MemoryBuffer &buffer)
+{
+  const int values_num = buffer.get_width() * buffer.get_height() * buffer.get_num_channels();
+  float *data = buffer.get_buffer();
+  for (int i = 0; i < values_num; i++) {
+    data[i] = value_for_index(i);
+  }
+}
+
+static void expect_buffer_filled(MemoryBuffer &buffer)
+{
+  const int values_num = buffer.get_width() * buffer.get_height() * buffer.get_num_channels();
+  const float *data = buffer.get_buffer();
+  for (int i = 0; i < values_num; i++) {
+    EXPECT_EQ(data[i], value_for_index(i));
+  }
+}
+
+TEST(MemoryBuffer, PackHalf)
+{
+  rcti rect;
+  /* Enough rows for several packed tiles. */
+  BLI_rcti_init(&rect, 0, 1000, 0, 300);
+  MemoryBuffer buffer(DataType::Color, rect);
+  fill_buffer(buffer);
+
+  buffer.pack(MemoryBufferStorage::Half);
+  EXPECT_TRUE(buffer.is_packed());
+  buffer.unpack();
+  EXPECT_FALSE(buffer.is_packed());
+  expect_buffer_filled(buffer);
+
+  /* Packing again reuses the packed data. */
+  buffer.pack(MemoryBufferStorage::Half);
+  EXPECT_TRUE(buffer.is_packed());
+  buffer.unpack();
+  expect_buffer_filled(buffer);
+}
+
+TEST(MemoryBuffer, PackFloat)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, 10, 0, 10);
+  MemoryBuffer buffer(DataType::Value, rect);
+  fill_buffer(buffer);
+
+  buffer.pack(MemoryBufferStorage::Float);
+  EXPECT_FALSE(buffer.is_packed());
+  expect_buffer_filled(buffer);
+}
+
+TEST(MemoryBuffer, PackSingleElem)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, 10, 0, 10);
+  MemoryBuffer buffer(DataType::Value, rect, true);
+  buffer.get_buffer()[0] = 1.0f / 3.0f;
+
+  buffer.pack(MemoryBufferStorage::Half);
+  EXPECT_FALSE(buffer.is_packed());
+  EXPECT_EQ(buffer.get_buffer()[0], 1.0f / 3.0f);
+}
+
+}  // namespace blender::compositor::tests
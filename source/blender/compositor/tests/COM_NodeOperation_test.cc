@@ -149,4 +149,63 @@ TEST(NodeOperation, generate_hash)
   }
 }
 
+TEST(NodeOperation, generate_content_key)
+{
+  auto input_content_hash_fn = [](NodeOperation &input) -> std::optional<size_t> {
+    /* Inputs with equal ids have equal content. */
+    return input.get_id();
+  };
+  auto no_input_content_hash_fn = [](NodeOperation & /*input*/) -> std::optional<size_t> {
+    return std::nullopt;
+  };
+
+  /* Constant inputs are hashed by value. */
+  {
+    NonHashedConstantOperation input_op1(1);
+    HashedOperation op1(input_op1, 6, 4);
+    NonHashedConstantOperation input_op2(2);
+    HashedOperation op2(input_op2, 6, 4);
+    EXPECT_NE(op1.generate_content_key(no_input_content_hash_fn), std::nullopt);
+    EXPECT_EQ(op1.generate_content_key(no_input_content_hash_fn),
+              op2.generate_content_key(no_input_content_hash_fn));
+
+    input_op2.set_constant(3.0f);
+    EXPECT_NE(op1.generate_content_key(no_input_content_hash_fn),
+              op2.generate_content_key(no_input_content_hash_fn));
+  }
+
+  /* Non constant inputs are hashed by content. */
+  {
+    NonHashedOperation input_op1(1);
+    HashedOperation op1(input_op1, 6, 4);
+    EXPECT_EQ(input_op1.generate_content_key(input_content_hash_fn), std::nullopt);
+    EXPECT_EQ(op1.generate_content_key(no_input_content_hash_fn), std::nullopt);
+
+    NonHashedOperation input_op2(2);
+    HashedOperation op2(input_op2, 6, 4);
+    EXPECT_NE(op1.generate_content_key(input_content_hash_fn),
+              op2.generate_content_key(input_content_hash_fn));
+
+    input_op2.set_id(1);
+    EXPECT_EQ(op1.generate_content_key(input_content_hash_fn),
+              op2.generate_content_key(input_content_hash_fn));
+
+    op2.set_param1(-1);
+    EXPECT_NE(op1.generate_content_key(input_content_hash_fn),
+              op2.generate_content_key(input_content_hash_fn));
+  }
+
+  /* Keys with equal hashes are only equal if the hashed values are. */
+  {
+    NonHashedOperation input_op(1);
+    HashedOperation op1(input_op, 6, 4);
+    HashedOperation op2(input_op, 6, 4);
+    op2.set_param1(-1);
+    NodeOperationContentKey key1 = *op1.generate_content_key(input_content_hash_fn);
+    NodeOperationContentKey key2 = *op2.generate_content_key(input_content_hash_fn);
+    key2.hash = key1.hash;
+    EXPECT_NE(key1, key2);
+  }
+}
+
 }  // namespace blender::compositor::tests
@@ -0,0 +1,102 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "COM_MemoryBuffer.h"
+#include "COM_RecursiveGaussianBlur.h"
+
+namespace blender::compositor::tests {
+
+static void fill_buffer(MemoryBuffer &buffer)
+{
+  const int values_num = buffer.get_width() * buffer.get_height() * buffer.get_num_channels();
+  float *data = buffer.get_buffer();
+  for (int i = 0; i < values_num; i++) {
+    data[i] = float((i * 7919) % 101) / 101.0f;
+  }
+}
+
+/* Reference horizontal Gaussian blur, with the closest pixel used outside of the buffer. */
+static float blur_pixel_x(
+    const MemoryBuffer &buffer, const float sigma, const int x, const int y, const int channel)
+{
+  const int radius = int(std::ceil(sigma * 6.0f));
+  double accumulated_value = 0.0;
+  double accumulated_weight = 0.0;
+  for (int i = -radius; i <= radius; i++) {
+    const double weight = std::exp(-double(i * i) / (2.0 * sigma * sigma));
+    accumulated_value += weight * buffer.get_elem_clamped(x + i, y)[channel];
+    accumulated_weight += weight;
+  }
+  return float(accumulated_value / accumulated_weight);
+}
+
+TEST(RecursiveGaussianBlur, ApproximatesGaussian)
+{
+  MemoryBuffer input(DataType::Color, 57, 23);
+  fill_buffer(input);
+  MemoryBuffer output(input);
+
+  const float sigma = 6.0f;
+  recursive_gaussian_blur(output, float2(sigma, 0.0f));
+
+  for (int y = 0; y < input.get_height(); y++) {
+    for (int x = 0; x < input.get_width(); x++) {
+      for (int channel = 0; channel < 4; channel++) {
+        EXPECT_NEAR(output.get_elem(x, y)[channel],
+                    blur_pixel_x(input, sigma, x, y, channel),
+                    0.05f);
+      }
+    }
+  }
+}
+
+TEST(RecursiveGaussianBlur, PreservesConstant)
+{
+  MemoryBuffer buffer(DataType::Value, 40, 300);
+  const float value = 0.75f;
+  buffer.fill(buffer.get_rect(), &value);
+
+  recursive_gaussian_blur(buffer, float2(3.0f, 250.0f));
+
+  for (int y = 0; y < buffer.get_height(); y++) {
+    for (int x = 0; x < buffer.get_width(); x++) {
+      EXPECT_NEAR(*buffer.get_elem(x, y), 0.75f, 1e-5f);
+    }
+  }
+}
+
+TEST(RecursiveGaussianBlur, Channels)
+{
+  MemoryBuffer input(DataType::Color, 31, 29);
+  fill_buffer(input);
+
+  /* Blurring channels separately gives the same result as blurring them together. */
+  MemoryBuffer all_channels(input);
+  recursive_gaussian_blur(all_channels, float2(2.0f, 5.0f));
+  MemoryBuffer single_channels(input);
+  for (int channel = 0; channel < 4; channel++) {
+    recursive_gaussian_blur(single_channels, float2(2.0f, 5.0f), IndexRange(channel, 1));
+  }
+
+  /* Other channels are not modified. */
+  MemoryBuffer second_channel(input);
+  recursive_gaussian_blur(second_channel, float2(2.0f, 5.0f), IndexRange(1, 1));
+
+  for (int y = 0; y < input.get_height(); y++) {
+    for (int x = 0; x < input.get_width(); x++) {
+      for (int channel = 0; channel < 4; channel++) {
+        EXPECT_FLOAT_EQ(single_channels.get_elem(x, y)[channel],
+                        all_channels.get_elem(x, y)[channel]);
+        const MemoryBuffer &expected = channel == 1 ? all_channels : input;
+        EXPECT_FLOAT_EQ(second_channel.get_elem(x, y)[channel], expected.get_elem(x, y)[channel]);
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
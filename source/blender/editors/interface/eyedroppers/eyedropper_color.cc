@@ -218,7 +218,12 @@ static bool eyedropper_cryptomatte_sample_view3d_fl(bContext *C,
   return true;
 }
 
+/**
+ * \param image: The multi-layer image the render layer belongs to, or null for the render result
+ * of a scene. Passes of images are read from the file when first sampled.
+ */
 static bool eyedropper_cryptomatte_sample_renderlayer_fl(RenderLayer *render_layer,
+                                                         Image *image,
                                                          const char *prefix,
                                                          const float fpos[2],
                                                          float r_col[3])
@@ -247,6 +252,9 @@ static bool eyedropper_cryptomatte_sample_renderlayer_fl(RenderLayer *render_lay
         !STREQLEN(render_pass->name, render_pass_name_prefix, sizeof(render_pass->name)))
     {
       BLI_assert(render_pass->channels == 4);
+      if (image && !BKE_image_multilayer_ensure_pass_loaded(image, render_pass)) {
+        return false;
+      }
       const int x = int(fpos[0] * render_pass->rectx);
       const int y = int(fpos[1] * render_pass->recty);
       const int offset = 4 * (y * render_pass->rectx + x);
@@ -274,7 +282,8 @@ static bool eyedropper_cryptomatte_sample_render_fl(const bNode *node,
     if (rr) {
       LISTBASE_FOREACH (ViewLayer *, view_layer, &scene->view_layers) {
         RenderLayer *render_layer = RE_GetRenderLayer(rr, view_layer->name);
-        success = eyedropper_cryptomatte_sample_renderlayer_fl(render_layer, prefix, fpos, r_col);
+        success = eyedropper_cryptomatte_sample_renderlayer_fl(
+            render_layer, nullptr, prefix, fpos, r_col);
         if (success) {
           break;
         }
@@ -300,7 +309,8 @@ static bool eyedropper_cryptomatte_sample_image_fl(const bNode *node,
     ImBuf *ibuf = BKE_image_acquire_ibuf(image, iuser, nullptr);
     if (image->rr) {
       LISTBASE_FOREACH (RenderLayer *, render_layer, &image->rr->layers) {
-        success = eyedropper_cryptomatte_sample_renderlayer_fl(render_layer, prefix, fpos, r_col);
+        success = eyedropper_cryptomatte_sample_renderlayer_fl(
+            render_layer, image, prefix, fpos, r_col);
         if (success) {
           break;
         }
@@ -130,9 +130,26 @@ struct UndoMesh {
   struct { /* most data is stored as 'custom' data */
     BArrayCustomData *vdata, *edata, *ldata, *pdata;
     BArrayState *face_offset_indices;
+    /** Used instead of #face_offset_indices when the topology is shared with the reference. */
+    blender::ImplicitSharingInfoAndData face_offset_indices_shared;
     BArrayState **keyblocks;
     BArrayState *mselect;
   } store;
+
+  /**
+   * References to this step's expanded topology arrays, kept for the next undo push of the same
+   * mesh. Most edit-mode operations (transform, selection, attribute edits) don't change the
+   * topology. In that case the next step shares these arrays, skipping the topology conversion
+   * and storing it in the array store. Released once the next step has been created.
+   */
+  struct {
+    blender::ImplicitSharingInfoAndData edges;
+    blender::ImplicitSharingInfoAndData corner_verts;
+    blender::ImplicitSharingInfoAndData corner_edges;
+    blender::ImplicitSharingInfoAndData face_offsets;
+  } topology;
+  /** The topology arrays are shared with the reference step, see #UndoMesh::topology. */
+  bool topology_is_shared;
 #endif /* USE_ARRAY_STORE */
 
   size_t undo_size;
@@ -175,9 +192,19 @@ static struct {
 
 } um_arraystore = {{{nullptr}}};
 
+static bool um_arraystore_layer_is_topology(const CustomDataLayer &layer)
+{
+  return STR_ELEM(layer.name, ".edge_verts", ".corner_vert", ".corner_edge");
+}
+
+/**
+ * \param share_topology: Store the topology layers using implicit sharing, they are the same
+ * arrays as the reference step's, see #UndoMesh::topology.
+ */
 static void um_arraystore_cd_compact(CustomData *cdata,
                                      const size_t data_len,
                                      const bool create,
+                                     const bool share_topology,
                                      const int bs_index,
                                      const BArrayCustomData *bcd_reference,
                                      BArrayCustomData **r_bcd_first)
@@ -262,7 +289,8 @@ static void um_arraystore_cd_compact(CustomData *cdata,
     for (int i = 0; i < layer_len; i++, layer++) {
       if (create) {
         if (layer->data) {
-          if (layer_type_is_dynamic) {
+          if (layer_type_is_dynamic || (share_topology && um_arraystore_layer_is_topology(*layer)))
+          {
             /* See comment on `layer_type_is_dynamic` above. */
             const ImplicitSharingInfo *sharing_info;
             if (layer->sharing_info) {
@@ -277,7 +305,12 @@ static void um_arraystore_cd_compact(CustomData *cdata,
           else {
             BArrayState *state_reference = nullptr;
             if (bcd_reference_current && i < bcd_reference_current->states.size()) {
-              state_reference = std::get<BArrayState *>(bcd_reference_current->states[i]);
+              /* The reference may have stored a shared topology layer. */
+              if (BArrayState *const *state = std::get_if<BArrayState *>(
+                      &bcd_reference_current->states[i]))
+              {
+                state_reference = *state;
+              }
             }
 
             bcd->states[i] = BLI_array_store_state_add(
@@ -396,6 +429,7 @@ static void um_arraystore_compact_ex(UndoMesh *um, const UndoMesh *um_ref, bool
         um_arraystore_cd_compact(&mesh->vert_data,
                                  mesh->verts_num,
                                  create,
+                                 um->topology_is_shared,
                                  ARRAY_STORE_INDEX_VERT,
                                  um_ref ? um_ref->store.vdata : nullptr,
                                  &um->store.vdata);
@@ -404,6 +438,7 @@ static void um_arraystore_compact_ex(UndoMesh *um, const UndoMesh *um_ref, bool
         um_arraystore_cd_compact(&mesh->edge_data,
                                  mesh->edges_num,
                                  create,
+                                 um->topology_is_shared,
                                  ARRAY_STORE_INDEX_EDGE,
                                  um_ref ? um_ref->store.edata : nullptr,
                                  &um->store.edata);
@@ -412,6 +447,7 @@ static void um_arraystore_compact_ex(UndoMesh *um, const UndoMesh *um_ref, bool
         um_arraystore_cd_compact(&mesh->corner_data,
                                  mesh->corners_num,
                                  create,
+                                 um->topology_is_shared,
                                  ARRAY_STORE_INDEX_LOOP,
                                  um_ref ? um_ref->store.ldata : nullptr,
                                  &um->store.ldata);
@@ -420,14 +456,22 @@ static void um_arraystore_compact_ex(UndoMesh *um, const UndoMesh *um_ref, bool
         um_arraystore_cd_compact(&mesh->face_data,
                                  mesh->faces_num,
                                  create,
+                                 um->topology_is_shared,
                                  ARRAY_STORE_INDEX_POLY,
                                  um_ref ? um_ref->store.pdata : nullptr,
                                  &um->store.pdata);
       },
       [&]() {
         if (mesh->face_offset_indices) {
-          BLI_assert(create == (um->store.face_offset_indices == nullptr));
-          if (create) {
+          BLI_assert(create == (um->store.face_offset_indices == nullptr &&
+                                um->store.face_offset_indices_shared.data == nullptr));
+          if (create && um->topology_is_shared) {
+            const blender::ImplicitSharingInfo *sharing_info =
+                mesh->runtime->face_offsets_sharing_info;
+            sharing_info->add_user();
+            um->store.face_offset_indices_shared = {sharing_info, mesh->face_offset_indices};
+          }
+          else if (create) {
             BArrayState *state_reference = um_ref ? um_ref->store.face_offset_indices : nullptr;
             const size_t stride = sizeof(*mesh->face_offset_indices);
             BArrayStore *bs = BLI_array_store_at_size_ensure(
@@ -614,6 +658,14 @@ static void um_arraystore_expand(UndoMesh *um)
     BLI_assert((mesh->faces_num + 1) == (state_len / stride));
     UNUSED_VARS_NDEBUG(stride);
   }
+  else if (um->store.face_offset_indices_shared.data) {
+    const blender::ImplicitSharingInfoAndData &shared = um->store.face_offset_indices_shared;
+    blender::implicit_sharing::copy_shared_pointer(
+        static_cast<int *>(const_cast<void *>(shared.data)),
+        shared.sharing_info,
+        &mesh->face_offset_indices,
+        &mesh->runtime->face_offsets_sharing_info);
+  }
   if (um->store.mselect) {
     const size_t stride = sizeof(*mesh->mselect);
     BArrayState *state = um->store.mselect;
@@ -654,6 +706,10 @@ static void um_arraystore_free(UndoMesh *um)
     BLI_array_store_state_remove(bs, state);
     um->store.face_offset_indices = nullptr;
   }
+  else if (um->store.face_offset_indices_shared.data) {
+    um->store.face_offset_indices_shared.sharing_info->remove_user_and_delete_if_last();
+    um->store.face_offset_indices_shared = {};
+  }
   if (um->store.mselect) {
     const size_t stride = sizeof(*mesh->mselect);
     BArrayStore *bs = BLI_array_store_at_size_get(&um_arraystore.bs_stride[ARRAY_STORE_INDEX_MSEL],
@@ -733,6 +789,137 @@ static UndoMesh **mesh_undostep_reference_elems_from_objects(Object **object, in
   return um_references;
 }
 
+static blender::ImplicitSharingInfoAndData um_topology_layer_share(const CustomData &cdata,
+                                                                   const eCustomDataType type,
+                                                                   const char *name)
+{
+  const int layer_index = CustomData_get_named_layer_index(&cdata, type, name);
+  if (layer_index == -1) {
+    return {};
+  }
+  const CustomDataLayer &layer = cdata.layers[layer_index];
+  if (layer.data == nullptr || layer.sharing_info == nullptr) {
+    return {};
+  }
+  layer.sharing_info->add_user();
+  return {layer.sharing_info, layer.data};
+}
+
+static void um_topology_layer_release(blender::ImplicitSharingInfoAndData &shared)
+{
+  if (shared.sharing_info) {
+    shared.sharing_info->remove_user_and_delete_if_last();
+  }
+  shared = {};
+}
+
+/**
+ * Keep references to the topology arrays of the (still expanded) undo mesh,
+ * see #UndoMesh::topology.
+ */
+static void um_topology_share(UndoMesh *um)
+{
+  const Mesh *mesh = &um->mesh;
+  um->topology.edges = um_topology_layer_share(mesh->edge_data, CD_PROP_INT32_2D, ".edge_verts");
+  um->topology.corner_verts = um_topology_layer_share(
+      mesh->corner_data, CD_PROP_INT32, ".corner_vert");
+  um->topology.corner_edges = um_topology_layer_share(
+      mesh->corner_data, CD_PROP_INT32, ".corner_edge");
+  if (mesh->face_offset_indices && mesh->runtime->face_offsets_sharing_info) {
+    mesh->runtime->face_offsets_sharing_info->add_user();
+    um->topology.face_offsets = {mesh->runtime->face_offsets_sharing_info,
+                                 mesh->face_offset_indices};
+  }
+}
+
+static void um_topology_release(UndoMesh *um)
+{
+  um_topology_layer_release(um->topology.edges);
+  um_topology_layer_release(um->topology.corner_verts);
+  um_topology_layer_release(um->topology.corner_edges);
+  um_topology_layer_release(um->topology.face_offsets);
+}
+
+static bool um_topology_is_complete(const UndoMesh *um)
+{
+  const Mesh *mesh = &um->mesh;
+  return (mesh->edges_num == 0 || um->topology.edges.data) &&
+         (mesh->corners_num == 0 ||
+          (um->topology.corner_verts.data && um->topology.corner_edges.data)) &&
+         (mesh->faces_num == 0 || um->topology.face_offsets.data);
+}
+
+/**
+ * Initialize the empty undo mesh with the topology of the reference step. Converting the BMesh
+ * then keeps these arrays when its topology still matches, or replaces them otherwise.
+ */
+static void um_topology_init_from_reference(UndoMesh *um, const UndoMesh *um_ref)
+{
+  using namespace blender;
+  if (!um_topology_is_complete(um_ref)) {
+    return;
+  }
+  Mesh *mesh = &um->mesh;
+  mesh->verts_num = um_ref->mesh.verts_num;
+  mesh->edges_num = um_ref->mesh.edges_num;
+  mesh->corners_num = um_ref->mesh.corners_num;
+  mesh->faces_num = um_ref->mesh.faces_num;
+
+  const auto add_layer = [](CustomData &cdata,
+                            const eCustomDataType type,
+                            const int totelem,
+                            const char *name,
+                            const ImplicitSharingInfoAndData &shared) {
+    if (shared.data) {
+      CustomData_add_layer_named_with_data(
+          &cdata, type, const_cast<void *>(shared.data), totelem, name, shared.sharing_info);
+    }
+  };
+  add_layer(mesh->edge_data,
+            CD_PROP_INT32_2D,
+            mesh->edges_num,
+            ".edge_verts",
+            um_ref->topology.edges);
+  add_layer(mesh->corner_data,
+            CD_PROP_INT32,
+            mesh->corners_num,
+            ".corner_vert",
+            um_ref->topology.corner_verts);
+  add_layer(mesh->corner_data,
+            CD_PROP_INT32,
+            mesh->corners_num,
+            ".corner_edge",
+            um_ref->topology.corner_edges);
+  implicit_sharing::copy_shared_pointer(
+      static_cast<int *>(const_cast<void *>(um_ref->topology.face_offsets.data)),
+      um_ref->topology.face_offsets.sharing_info,
+      &mesh->face_offset_indices,
+      &mesh->runtime->face_offsets_sharing_info);
+}
+
+/**
+ * Check whether converting the BMesh kept the topology arrays of the reference step.
+ */
+static bool um_topology_is_shared_with(const UndoMesh *um, const UndoMesh *um_ref)
+{
+  const Mesh *mesh = &um->mesh;
+  if (!um_topology_is_complete(um_ref) || mesh->verts_num != um_ref->mesh.verts_num ||
+      mesh->edges_num != um_ref->mesh.edges_num ||
+      mesh->corners_num != um_ref->mesh.corners_num || mesh->faces_num != um_ref->mesh.faces_num)
+  {
+    return false;
+  }
+  return (mesh->edges_num == 0 ||
+          CustomData_get_layer_named(&mesh->edge_data, CD_PROP_INT32_2D, ".edge_verts") ==
+              um_ref->topology.edges.data) &&
+         (mesh->corners_num == 0 ||
+          (CustomData_get_layer_named(&mesh->corner_data, CD_PROP_INT32, ".corner_vert") ==
+               um_ref->topology.corner_verts.data &&
+           CustomData_get_layer_named(&mesh->corner_data, CD_PROP_INT32, ".corner_edge") ==
+               um_ref->topology.corner_edges.data)) &&
+         (mesh->faces_num == 0 || mesh->face_offset_indices == um_ref->topology.face_offsets.data);
+}
+
 /** \} */
 
 #endif /* USE_ARRAY_STORE */
@@ -772,6 +959,12 @@ static void *undomesh_from_editmesh(UndoMesh *um, BMEditMesh *em, Key *key, Undo
   BLI_assert(um->mesh.runtime == nullptr);
   um->mesh.runtime = new blender::bke::MeshRuntime();
 
+#ifdef USE_ARRAY_STORE
+  if (um_ref) {
+    um_topology_init_from_reference(um, um_ref);
+  }
+#endif
+
   CustomData_MeshMasks cd_mask_extra{};
   cd_mask_extra.vmask = CD_MASK_SHAPE_KEYINDEX;
   BMeshToMeshParams params{};
@@ -787,6 +980,12 @@ static void *undomesh_from_editmesh(UndoMesh *um, BMEditMesh *em, Key *key, Undo
 
 #ifdef USE_ARRAY_STORE
   {
+    if (um_ref) {
+      um->topology_is_shared = um_topology_is_shared_with(um, um_ref);
+      um_topology_release(um_ref);
+    }
+    um_topology_share(um);
+
     /* Add ourselves. */
     BLI_addtail(&um_arraystore.local_links, um);
 
@@ -887,6 +1086,8 @@ static void undomesh_free_data(UndoMesh *um)
   BLI_assert(BLI_findindex(&um_arraystore.local_links, um) != -1);
   BLI_remlink(&um_arraystore.local_links, um);
 
+  um_topology_release(um);
+
   um_arraystore_free(um);
 #endif
 
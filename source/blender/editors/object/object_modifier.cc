@@ -2830,6 +2830,9 @@ static int multires_external_save_exec(bContext *C, wmOperator *op)
     BLI_path_rel(filepath, BKE_main_blendfile_path(bmain));
   }
 
+  /* The external file stores every grid. */
+  multires_ensure_dense_grids(mesh);
+
   CustomData_external_add(&mesh->corner_data, &mesh->id, CD_MDISPS, mesh->corners_num, filepath);
   CustomData_external_write(
       &mesh->corner_data, &mesh->id, CD_MASK_MESH.lmask, mesh->corners_num, 0);
@@ -415,6 +415,7 @@ static void make_renderinfo_string(const RenderStats *rs,
   struct {
     char time_last[32];
     char time_elapsed[32];
+    char time_encode[32];
     char frame[16];
     char statistics[64];
   } info_buffers;
@@ -466,6 +467,15 @@ static void make_renderinfo_string(const RenderStats *rs,
   ret_array[i++] = info_time;
   ret_array[i++] = info_space;
 
+  /* Encoding time of the last saved frame. */
+  if (rs->lastencodetime != 0.0) {
+    BLI_timecode_string_from_time_simple(
+        info_buffers.time_encode, sizeof(info_buffers.time_encode), rs->lastencodetime);
+    ret_array[i++] = RPT_("Encoding:");
+    ret_array[i++] = info_buffers.time_encode;
+    ret_array[i++] = info_space;
+  }
+
   /* Statistics. */
   {
     const char *info_statistics = nullptr;
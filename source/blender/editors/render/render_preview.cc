@@ -24,8 +24,10 @@
 #include "BLI_blenlib.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
+#include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -100,11 +102,6 @@
 #include "ANIM_action.hh"
 #include "ANIM_pose.hh"
 
-#ifndef NDEBUG
-/* Used for database init assert(). */
-#  include "BLI_threads.h"
-#endif
-
 static void icon_copy_rect(ImBuf *ibuf, uint w, uint h, uint *rect);
 
 /* -------------------------------------------------------------------- */
@@ -1793,6 +1790,10 @@ void PreviewLoadJob::run_fn(void *customdata, wmJobWorkerStatus *worker_status)
 {
   PreviewLoadJob *job_data = static_cast<PreviewLoadJob *>(customdata);
 
+  /* Load the thumbnails of requests that are queued already together, in parallel. Limit the
+   * batch size so that loaded previews are shown and the job can be stopped in between. */
+  const int max_batch_size = BLI_system_thread_count() * 2;
+
   IMB_thumb_locks_acquire();
 
   while (RequestedPreview *request = static_cast<RequestedPreview *>(
@@ -1802,30 +1803,39 @@ void PreviewLoadJob::run_fn(void *customdata, wmJobWorkerStatus *worker_status)
       break;
     }
 
-    PreviewImage *preview = request->preview;
+    blender::Vector<RequestedPreview *> requests;
+    blender::Vector<ThumbBatchItem> items;
+    do {
+      PreviewImage *preview = request->preview;
 
-    const std::optional<int> source = BKE_previewimg_deferred_thumb_source_get(preview);
-    const char *filepath = BKE_previewimg_deferred_filepath_get(preview);
+      const std::optional<int> source = BKE_previewimg_deferred_thumb_source_get(preview);
+      const char *filepath = BKE_previewimg_deferred_filepath_get(preview);
 
-    if (!source || !filepath) {
-      continue;
-    }
-
-    // printf("loading deferred %dx%d preview for %s\n", request->sizex, request->sizey, filepath);
-
-    IMB_thumb_path_lock(filepath);
-    ImBuf *thumb = IMB_thumb_manage(filepath, THB_LARGE, ThumbSource(*source));
-    IMB_thumb_path_unlock(filepath);
-
-    if (thumb) {
-      /* PreviewImage assumes premultiplied alpha... */
-      IMB_premultiply_alpha(thumb);
+      if (!source || !filepath) {
+        continue;
+      }
 
-      icon_copy_rect(thumb,
-                     preview->w[request->icon_size],
-                     preview->h[request->icon_size],
-                     preview->rect[request->icon_size]);
-      IMB_freeImBuf(thumb);
+      requests.append(request);
+      items.append({filepath, ThumbSource(*source), nullptr});
+    } while (items.size() < max_batch_size &&
+             (request = static_cast<RequestedPreview *>(
+                  BLI_thread_queue_pop_timeout(job_data->todo_queue_, 0))));
+
+    IMB_thumb_manage_batch(items, THB_LARGE);
+
+    for (const int i : items.index_range()) {
+      PreviewImage *preview = requests[i]->preview;
+      ImBuf *thumb = items[i].thumb;
+      if (thumb) {
+        /* PreviewImage assumes premultiplied alpha... */
+        IMB_premultiply_alpha(thumb);
+
+        icon_copy_rect(thumb,
+                       preview->w[requests[i]->icon_size],
+                       preview->h[requests[i]->icon_size],
+                       preview->rect[requests[i]->icon_size]);
+        IMB_freeImBuf(thumb);
+      }
     }
 
     worker_status->do_update = true;
@@ -190,10 +190,7 @@ static void calc_faces(const Depsgraph &depsgraph,
 
     tls.distances.resize(verts.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, positions, distances, factors);
 
     auto_mask::calc_vert_factors(depsgraph, object, cache.automasking.get(), node, verts, factors);
     scale_factors(factors, cache.bstrength);
@@ -252,10 +249,7 @@ static void calc_grids(const Depsgraph &depsgraph,
 
     tls.distances.resize(positions.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, positions, distances, factors);
 
     auto_mask::calc_grids_factors(
         depsgraph, object, cache.automasking.get(), node, grids, factors);
@@ -315,10 +309,7 @@ static void calc_bmesh(const Depsgraph &depsgraph,
 
     tls.distances.resize(verts.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, positions, distances, factors);
 
     auto_mask::calc_vert_factors(depsgraph, object, cache.automasking.get(), node, verts, factors);
     scale_factors(factors, cache.bstrength);
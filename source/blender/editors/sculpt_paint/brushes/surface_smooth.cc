@@ -88,11 +88,7 @@ BLI_NOINLINE static void do_surface_smooth_brush_mesh(const Depsgraph &depsgraph
 
     tls.distances.resize(verts.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(
-        ss, position_data.eval, verts, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, position_data.eval, verts, distances, factors);
 
     auto_mask::calc_vert_factors(
         depsgraph, object, cache.automasking.get(), nodes[i], verts, factors);
@@ -200,10 +196,7 @@ BLI_NOINLINE static void do_surface_smooth_brush_grids(
 
     tls.distances.resize(positions.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, positions, distances, factors);
 
     auto_mask::calc_grids_factors(
         depsgraph, object, cache.automasking.get(), nodes[i], grids, factors);
@@ -302,10 +295,7 @@ BLI_NOINLINE static void do_surface_smooth_brush_bmesh(
 
     tls.distances.resize(positions.size());
     const MutableSpan<float> distances = tls.distances;
-    calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), distances);
-    filter_distances_with_radius(cache.radius, distances, factors);
-    apply_hardness_to_distances(cache, distances);
-    calc_brush_strength_factors(cache, brush, distances, factors);
+    calc_brush_falloff_factors(ss, brush, positions, distances, factors);
 
     auto_mask::calc_vert_factors(
         depsgraph, object, cache.automasking.get(), nodes[i], verts, factors);
@@ -232,6 +232,30 @@ void calc_brush_distances_squared(const SculptSession &ss,
 /** Set the factor to zero for all distances greater than the radius. */
 void filter_distances_with_radius(float radius, Span<float> distances, MutableSpan<float> factors);
 
+/**
+ * Combination of #calc_brush_distances, #filter_distances_with_radius,
+ * #apply_hardness_to_distances and #calc_brush_strength_factors with the stroke cache's settings.
+ * The distances, radius test and hardness are calculated in a single vectorizable loop over the
+ * node's vertices, rather than reading and writing the distances once per step.
+ *
+ * Masking, automasking, texture and the final translation are not part of the loop. The mask and
+ * hide attributes are looked up differently for every PBVH type, automasking needs per-mode data
+ * like cavity, boundary and face set information, and the texture is sampled in between. Fusing
+ * them would need a kernel for every combination of brush settings. The remaining steps only
+ * touch the node sized factors array.
+ */
+void calc_brush_falloff_factors(const SculptSession &ss,
+                                const Brush &brush,
+                                Span<float3> vert_positions,
+                                Span<int> verts,
+                                MutableSpan<float> r_distances,
+                                MutableSpan<float> factors);
+void calc_brush_falloff_factors(const SculptSession &ss,
+                                const Brush &brush,
+                                Span<float3> positions,
+                                MutableSpan<float> r_distances,
+                                MutableSpan<float> factors);
+
 /**
  * Calculate distances based on a "square" brush tip falloff and ignore vertices that are too far
  * away.
@@ -14,6 +14,7 @@
 
 #include "BLI_math_matrix.h"
 #include "BLI_rand.hh"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_brush_types.h"
@@ -45,6 +46,8 @@
 #include "sculpt_cloth.hh"
 #include "sculpt_intern.hh"
 
+#include "CLG_log.h"
+
 // #define DEBUG_TIME
 
 #ifdef DEBUG_TIME
@@ -53,6 +56,8 @@
 
 namespace blender::ed::sculpt_paint {
 
+static CLG_LogRef LOG = {"paint.stroke"};
+
 struct PaintSample {
   float2 mouse;
   float pressure;
@@ -1671,8 +1676,21 @@ int paint_stroke_exec(bContext *C, wmOperator *op, PaintStroke *stroke)
   }
 
   if (stroke->stroke_started) {
+    /* Per-dab timings are used by the stroke replay benchmark, see
+     * `tests/performance/tests/sculpt_stroke_replay.py`. */
+    const bool log_dab_time = CLOG_CHECK(&LOG, 1);
+    int dab_index = 0;
     RNA_BEGIN (op->ptr, itemptr, "stroke") {
+      const double start_time = log_dab_time ? BLI_time_now_seconds() : 0.0;
       stroke->update_step(C, op, stroke, &itemptr);
+      if (log_dab_time) {
+        CLOG_INFO(&LOG,
+                  1,
+                  "Dab %d: %.4f ms",
+                  dab_index,
+                  (BLI_time_now_seconds() - start_time) * 1000.0);
+      }
+      dab_index++;
     }
     RNA_END;
   }
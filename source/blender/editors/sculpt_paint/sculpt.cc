@@ -6592,6 +6592,128 @@ void filter_distances_with_radius(const float radius,
   }
 }
 
+/**
+ * Shared loop for the fused brush distance calculation. Each element only depends on its own
+ * position and factor, and the radius test and hardness are applied with selects instead of
+ * branches, so the compiler can vectorize the loop.
+ */
+template<typename PositionFn, typename HardnessFn>
+BLI_NOINLINE static void calc_brush_distances_fused(const float3 &test_location,
+                                                    const std::optional<float4> &test_plane,
+                                                    const float radius,
+                                                    const PositionFn &position_fn,
+                                                    const HardnessFn &hardness_fn,
+                                                    const MutableSpan<float> r_distances,
+                                                    const MutableSpan<float> factors)
+{
+  if (test_plane) {
+    for (const int i : r_distances.index_range()) {
+      float3 projected;
+      closest_to_plane_normalized_v3(projected, *test_plane, position_fn(i));
+      const float distance = std::sqrt(math::distance_squared(projected, test_location));
+      factors[i] = distance > radius ? 0.0f : factors[i];
+      r_distances[i] = hardness_fn(distance);
+    }
+  }
+  else {
+    for (const int i : r_distances.index_range()) {
+      const float distance = std::sqrt(math::distance_squared(test_location, position_fn(i)));
+      factors[i] = distance > radius ? 0.0f : factors[i];
+      r_distances[i] = hardness_fn(distance);
+    }
+  }
+}
+
+template<typename PositionFn>
+static void calc_brush_falloff_factors_impl(const SculptSession &ss,
+                                            const Brush &brush,
+                                            const PositionFn &position_fn,
+                                            const MutableSpan<float> r_distances,
+                                            const MutableSpan<float> factors)
+{
+  const StrokeCache &cache = *ss.cache;
+  const float3 &test_location = cache.location_symm;
+  std::optional<float4> test_plane;
+  if (eBrushFalloffShape(brush.falloff_shape) == PAINT_FALLOFF_SHAPE_TUBE) {
+    test_plane.emplace();
+    plane_from_point_normal_v3(*test_plane, test_location, cache.view_normal_symm);
+  }
+
+  const float radius = cache.radius;
+  const float hardness = cache.hardness;
+  if (hardness == 0.0f) {
+    calc_brush_distances_fused(
+        test_location,
+        test_plane,
+        radius,
+        position_fn,
+        [](const float distance) { return distance; },
+        r_distances,
+        factors);
+  }
+  else if (hardness == 1.0f) {
+    calc_brush_distances_fused(
+        test_location,
+        test_plane,
+        radius,
+        position_fn,
+        [](const float /*distance*/) { return 0.0f; },
+        r_distances,
+        factors);
+  }
+  else {
+    /* See #apply_hardness_to_distances. */
+    const float radius_inv = math::rcp(radius);
+    const float hardness_inv_rcp = math::rcp(1.0f - hardness);
+    calc_brush_distances_fused(
+        test_location,
+        test_plane,
+        radius,
+        position_fn,
+        [&](const float distance) {
+          const float radius_factor = (distance * radius_inv - hardness) * hardness_inv_rcp;
+          return std::max(radius_factor, 0.0f) * radius;
+        },
+        r_distances,
+        factors);
+  }
+
+  calc_brush_strength_factors(cache, brush, r_distances, factors);
+}
+
+void calc_brush_falloff_factors(const SculptSession &ss,
+                                const Brush &brush,
+                                const Span<float3> vert_positions,
+                                const Span<int> verts,
+                                const MutableSpan<float> r_distances,
+                                const MutableSpan<float> factors)
+{
+  BLI_assert(verts.size() == r_distances.size());
+  BLI_assert(verts.size() == factors.size());
+  calc_brush_falloff_factors_impl(
+      ss,
+      brush,
+      [&](const int i) -> const float3 & { return vert_positions[verts[i]]; },
+      r_distances,
+      factors);
+}
+
+void calc_brush_falloff_factors(const SculptSession &ss,
+                                const Brush &brush,
+                                const Span<float3> positions,
+                                const MutableSpan<float> r_distances,
+                                const MutableSpan<float> factors)
+{
+  BLI_assert(positions.size() == r_distances.size());
+  BLI_assert(positions.size() == factors.size());
+  calc_brush_falloff_factors_impl(
+      ss,
+      brush,
+      [&](const int i) -> const float3 & { return positions[i]; },
+      r_distances,
+      factors);
+}
+
 void calc_brush_cube_distances(const Brush &brush,
                                const float4x4 &mat,
                                const Span<float3> positions,
@@ -0,0 +1,151 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup edsculpt
+ */
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+
+#include "BKE_paint.hh"
+
+#include "DNA_brush_types.h"
+
+#include "mesh_brush_common.hh"
+#include "sculpt_automask.hh"
+#include "sculpt_boundary.hh"
+#include "sculpt_cloth.hh"
+#include "sculpt_intern.hh"
+#include "sculpt_pose.hh"
+
+#include "testing/testing.h"
+
+namespace blender::ed::sculpt_paint::tests {
+
+constexpr int POSITIONS_NUM = 1000;
+constexpr float BRUSH_RADIUS = 0.5f;
+
+/** The separate steps that #calc_brush_falloff_factors combines. */
+static void calc_brush_falloff_factors_unfused(const SculptSession &ss,
+                                               const Brush &brush,
+                                               const Span<float3> positions,
+                                               const MutableSpan<float> r_distances,
+                                               const MutableSpan<float> factors)
+{
+  const StrokeCache &cache = *ss.cache;
+  calc_brush_distances(ss, positions, eBrushFalloffShape(brush.falloff_shape), r_distances);
+  filter_distances_with_radius(cache.radius, r_distances, factors);
+  apply_hardness_to_distances(cache, r_distances);
+  calc_brush_strength_factors(cache, brush, r_distances, factors);
+}
+
+static void test_fused_matches_unfused(const eBrushFalloffShape falloff_shape,
+                                       const eBrushCurvePreset curve_preset,
+                                       const float hardness)
+{
+  StrokeCache cache{};
+  cache.radius = BRUSH_RADIUS;
+  cache.hardness = hardness;
+  cache.location_symm = float3(0.1f, -0.2f, 0.05f);
+  cache.view_normal_symm = math::normalize(float3(0.3f, 0.2f, 1.0f));
+
+  SculptSession ss;
+  ss.cache = &cache;
+
+  Brush brush{};
+  brush.falloff_shape = falloff_shape;
+  brush.curve_preset = curve_preset;
+
+  /* Positions inside, on the edge of and outside of the brush radius. */
+  RandomNumberGenerator rng(0);
+  Array<float3> positions(POSITIONS_NUM);
+  for (float3 &position : positions) {
+    position = cache.location_symm + rng.get_unit_float3() * rng.get_float() * 2.0f * BRUSH_RADIUS;
+  }
+  /* Masked vertices should stay masked. */
+  Array<float> factors_initial(POSITIONS_NUM);
+  for (const int i : factors_initial.index_range()) {
+    factors_initial[i] = (i % 7 == 0) ? 0.0f : rng.get_float();
+  }
+
+  Array<float> distances_fused(POSITIONS_NUM);
+  Array<float> factors_fused = factors_initial;
+  calc_brush_falloff_factors(ss, brush, positions, distances_fused, factors_fused);
+
+  Array<float> distances(POSITIONS_NUM);
+  Array<float> factors = factors_initial;
+  calc_brush_falloff_factors_unfused(ss, brush, positions, distances, factors);
+
+  for (const int i : positions.index_range()) {
+    EXPECT_NEAR(factors_fused[i], factors[i], 1e-5f);
+    /* Distances of vertices outside of the radius are not used. */
+    if (factors[i] != 0.0f) {
+      EXPECT_NEAR(distances_fused[i], distances[i], 1e-5f);
+    }
+  }
+
+  ss.cache = nullptr;
+}
+
+TEST(brush_falloff, FusedMatchesUnfusedSphere)
+{
+  for (const float hardness : {0.0f, 0.5f, 1.0f}) {
+    test_fused_matches_unfused(PAINT_FALLOFF_SHAPE_SPHERE, BRUSH_CURVE_SMOOTH, hardness);
+    test_fused_matches_unfused(PAINT_FALLOFF_SHAPE_SPHERE, BRUSH_CURVE_SHARP, hardness);
+    test_fused_matches_unfused(PAINT_FALLOFF_SHAPE_SPHERE, BRUSH_CURVE_CONSTANT, hardness);
+  }
+}
+
+TEST(brush_falloff, FusedMatchesUnfusedTube)
+{
+  for (const float hardness : {0.0f, 0.5f, 1.0f}) {
+    test_fused_matches_unfused(PAINT_FALLOFF_SHAPE_TUBE, BRUSH_CURVE_SMOOTH, hardness);
+    test_fused_matches_unfused(PAINT_FALLOFF_SHAPE_TUBE, BRUSH_CURVE_LIN, hardness);
+  }
+}
+
+TEST(brush_falloff, FusedMatchesUnfusedIndexed)
+{
+  StrokeCache cache{};
+  cache.radius = BRUSH_RADIUS;
+  cache.hardness = 0.25f;
+  cache.location_symm = float3(0.0f);
+
+  SculptSession ss;
+  ss.cache = &cache;
+
+  Brush brush{};
+  brush.falloff_shape = PAINT_FALLOFF_SHAPE_SPHERE;
+  brush.curve_preset = BRUSH_CURVE_SMOOTH;
+
+  RandomNumberGenerator rng(1);
+  Array<float3> vert_positions(POSITIONS_NUM);
+  for (float3 &position : vert_positions) {
+    position = rng.get_unit_float3() * rng.get_float() * 2.0f * BRUSH_RADIUS;
+  }
+  /* Every third vertex, like the vertices of a node that are a subset of the mesh. */
+  Array<int> verts(POSITIONS_NUM / 3);
+  Array<float3> positions(verts.size());
+  for (const int i : verts.index_range()) {
+    verts[i] = i * 3;
+    positions[i] = vert_positions[verts[i]];
+  }
+
+  Array<float> distances_fused(verts.size());
+  Array<float> factors_fused(verts.size(), 1.0f);
+  calc_brush_falloff_factors(ss, brush, vert_positions, verts, distances_fused, factors_fused);
+
+  Array<float> distances(verts.size());
+  Array<float> factors(verts.size(), 1.0f);
+  calc_brush_falloff_factors_unfused(ss, brush, positions, distances, factors);
+
+  for (const int i : verts.index_range()) {
+    EXPECT_NEAR(factors_fused[i], factors[i], 1e-5f);
+  }
+
+  ss.cache = nullptr;
+}
+
+}  // namespace blender::ed::sculpt_paint::tests
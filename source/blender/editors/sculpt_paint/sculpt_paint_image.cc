@@ -324,11 +324,7 @@ static void do_paint_pixels(const Scene &scene,
           factors.fill(1.0f);
 
           distances.resize(pixel_positions.size());
-          calc_brush_distances(
-              ss, pixel_positions, eBrushFalloffShape(brush.falloff_shape), distances);
-          filter_distances_with_radius(cache.radius, distances, factors);
-          apply_hardness_to_distances(cache, distances);
-          calc_brush_strength_factors(cache, brush, distances, factors);
+          calc_brush_falloff_factors(ss, brush, pixel_positions, distances, factors);
           calc_brush_texture_factors(ss, brush, pixel_positions, factors);
           scale_factors(factors, cache.bstrength);
 
@@ -37,9 +37,11 @@
 
 #include "BLI_array.hh"
 #include "BLI_bit_group_vector.hh"
+#include "BLI_compression.hh"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -47,6 +49,7 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BKE_attribute.hh"
 #include "BKE_ccg.hh"
@@ -65,6 +68,8 @@
 #include "BKE_subsurf.hh"
 #include "BKE_undo_system.hh"
 
+#include "CLG_log.h"
+
 /* TODO(sergey): Ideally should be no direct call to such low level things. */
 #include "BKE_subdiv_eval.hh"
 
@@ -90,6 +95,8 @@
 
 namespace blender::ed::sculpt_paint::undo {
 
+static CLG_LogRef LOG = {"ed.sculpt.undo"};
+
 /* Uncomment to print the undo stack in the console on push/undo/redo. */
 // #define SCULPT_UNDO_DEBUG
 
@@ -166,6 +173,14 @@ struct Node {
   Array<int, 0> face_sets;
 
   Vector<int> face_indices;
+
+  /**
+   * Delta encoded and compressed contents of the arrays above, when undo compression is enabled
+   * (see #compress_node). The compressed arrays are empty then, and their sizes are stored in
+   * #compressed_array_sizes.
+   */
+  Array<std::byte, 0> compressed_data;
+  Vector<int64_t, 0> compressed_array_sizes;
 };
 
 struct SculptAttrRef {
@@ -257,6 +272,8 @@ struct StepData {
   Vector<std::unique_ptr<Node>> nodes;
 
   size_t undo_size;
+  /** The size of the step before compression, only used for reporting. */
+  size_t undo_size_uncompressed;
 };
 
 struct SculptUndoStep {
@@ -1795,6 +1812,223 @@ static void save_active_attribute(Object &object, SculptAttrRef *attr)
   attr->type = meta_data->data_type;
 }
 
+static size_t node_size_in_bytes(const Node &node)
+{
+  size_t size = sizeof(Node);
+  size += node.position.as_span().size_in_bytes();
+  size += node.orig_position.as_span().size_in_bytes();
+  size += node.normal.as_span().size_in_bytes();
+  size += node.col.as_span().size_in_bytes();
+  size += node.mask.as_span().size_in_bytes();
+  size += node.loop_col.as_span().size_in_bytes();
+  size += node.vert_indices.as_span().size_in_bytes();
+  size += node.corner_indices.as_span().size_in_bytes();
+  size += node.vert_hidden.size() / 8;
+  size += node.face_hidden.size() / 8;
+  size += node.grids.as_span().size_in_bytes();
+  size += node.grid_hidden.all_bits().size() / 8;
+  size += node.face_sets.as_span().size_in_bytes();
+  size += node.face_indices.as_span().size_in_bytes();
+  size += node.compressed_data.as_span().size_in_bytes();
+  size += node.compressed_array_sizes.as_span().size_in_bytes();
+  return size;
+}
+
+static size_t step_size_in_bytes(const StepData &step_data)
+{
+  return threading::parallel_reduce(
+      step_data.nodes.index_range(),
+      16,
+      size_t(0),
+      [&](const IndexRange range, size_t size) {
+        for (const int i : range) {
+          size += node_size_in_bytes(*step_data.nodes[i]);
+        }
+        return size;
+      },
+      std::plus<size_t>());
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Undo Data Compression
+ *
+ * With the experimental "Sculpt Undo Compression" option, the per-node arrays of finished undo
+ * steps are delta encoded and compressed with zstd in a background task. They are decompressed
+ * when the step is undone or redone, and compressed again afterwards.
+ *
+ * Like the mesh undo array store, the background task must have finished before undo data is
+ * accessed from the main thread, see #compression_wait.
+ * \{ */
+
+/** Zstd level, a low level is used to keep the background work short between strokes. */
+#define UNDO_COMPRESSION_LEVEL 3
+
+static struct {
+  TaskPool *task_pool;
+  /** Steps with compression running in the background, to update their size afterwards. */
+  Vector<SculptUndoStep *> pending_steps;
+} undo_compression = {};
+
+/** Call the function for every node array that is stored in #Node::compressed_data. */
+template<typename Fn> static void foreach_compressed_array(Node &node, const Fn &fn)
+{
+  fn(node.position);
+  fn(node.orig_position);
+  fn(node.col);
+  fn(node.mask);
+  fn(node.loop_col);
+  fn(node.vert_indices);
+  fn(node.face_sets);
+}
+
+template<typename T> static constexpr int values_per_element(const Array<T, 0> & /*array*/)
+{
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+  return sizeof(T) / sizeof(uint32_t);
+}
+
+static void compress_node(Node &node)
+{
+  if (!node.compressed_data.is_empty()) {
+    return;
+  }
+  int64_t values_num = 0;
+  foreach_compressed_array(node, [&](const auto &array) {
+    values_num += array.size() * values_per_element(array);
+  });
+  if (values_num == 0) {
+    return;
+  }
+
+  /* XOR each value with the same component of the previous element. Neighboring vertices have
+   * similar positions and often the same mask or color values, so many bits become zero. */
+  Array<uint32_t> values(values_num, NoInitialization());
+  int64_t offset = 0;
+  foreach_compressed_array(node, [&](const auto &array) {
+    const Span<uint32_t> src = array.as_span().template cast<uint32_t>();
+    MutableSpan<uint32_t> dst = values.as_mutable_span().slice(offset, src.size());
+    dst.copy_from(src);
+    compression::xor_delta_encode(dst, values_per_element(array));
+    offset += src.size();
+  });
+
+  node.compressed_data = compression::compress_zstd(values.as_span().cast<std::byte>(),
+                                                    UNDO_COMPRESSION_LEVEL);
+  if (node.compressed_data.is_empty()) {
+    /* Keep the uncompressed data. */
+    return;
+  }
+
+  foreach_compressed_array(node, [&](auto &array) {
+    node.compressed_array_sizes.append(array.size());
+    array = {};
+  });
+}
+
+static void decompress_node(Node &node)
+{
+  if (node.compressed_data.is_empty()) {
+    return;
+  }
+  int64_t values_num = 0;
+  int array_index = 0;
+  foreach_compressed_array(node, [&](const auto &array) {
+    values_num += node.compressed_array_sizes[array_index++] * values_per_element(array);
+  });
+
+  Array<uint32_t> values(values_num, NoInitialization());
+  if (!compression::decompress_zstd(node.compressed_data,
+                                    values.as_mutable_span().cast<std::byte>()))
+  {
+    BLI_assert_unreachable();
+    return;
+  }
+
+  int64_t offset = 0;
+  array_index = 0;
+  foreach_compressed_array(node, [&](auto &array) {
+    array.reinitialize(node.compressed_array_sizes[array_index++]);
+    MutableSpan<uint32_t> dst = array.as_mutable_span().template cast<uint32_t>();
+    MutableSpan<uint32_t> src = values.as_mutable_span().slice(offset, dst.size());
+    compression::xor_delta_decode(src, values_per_element(array));
+    dst.copy_from(src);
+    offset += dst.size();
+  });
+
+  node.compressed_data = {};
+  node.compressed_array_sizes.clear();
+}
+
+static void compress_step_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  StepData &step_data = *static_cast<StepData *>(taskdata);
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      compress_node(*step_data.nodes[i]);
+    }
+  });
+}
+
+/**
+ * Start compressing the step's nodes in the background. The step's data must not be accessed
+ * until #compression_wait is called.
+ */
+static void compress_step_async(SculptUndoStep &us)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_sculpt_undo_compression)) {
+    return;
+  }
+  if (us.data.nodes.is_empty()) {
+    return;
+  }
+  if (undo_compression.task_pool == nullptr) {
+    undo_compression.task_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  }
+  undo_compression.pending_steps.append(&us);
+  BLI_task_pool_push(undo_compression.task_pool, compress_step_task, &us.data, false, nullptr);
+}
+
+/**
+ * Wait for background compression to finish, and update the memory usage of the compressed steps.
+ */
+static void compression_wait()
+{
+  if (undo_compression.task_pool == nullptr) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(undo_compression.task_pool);
+  BLI_task_pool_free(undo_compression.task_pool);
+  undo_compression.task_pool = nullptr;
+
+  for (SculptUndoStep *us : undo_compression.pending_steps) {
+    us->data.undo_size = step_size_in_bytes(us->data);
+    us->step.data_size = us->data.undo_size;
+
+    char size_str[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
+    char size_uncompressed_str[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
+    BLI_str_format_byte_unit(size_str, us->data.undo_size, true);
+    BLI_str_format_byte_unit(size_uncompressed_str, us->data.undo_size_uncompressed, true);
+    CLOG_INFO(&LOG,
+              1,
+              "Undo step \"%s\" compressed from %s to %s",
+              us->step.name,
+              size_uncompressed_str,
+              size_str);
+  }
+  undo_compression.pending_steps.clear_and_shrink();
+}
+
+static void decompress_step(StepData &step_data)
+{
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      decompress_node(*step_data.nodes[i]);
+    }
+  });
+}
+
+/** \} */
+
 void push_begin(const Scene &scene, Object &ob, const wmOperator *op)
 {
   push_begin_ex(scene, ob, op->type->name);
@@ -1802,6 +2036,8 @@ void push_begin(const Scene &scene, Object &ob, const wmOperator *op)
 
 void push_begin_ex(const Scene & /*scene*/, Object &ob, const char *name)
 {
+  compression_wait();
+
   UndoStack *ustack = ED_undo_stack_get();
 
   /* If possible, we need to tag the object and its geometry data as 'changed in the future' in
@@ -1862,26 +2098,6 @@ void push_end(Object &ob)
   push_end_ex(ob, false);
 }
 
-static size_t node_size_in_bytes(const Node &node)
-{
-  size_t size = sizeof(Node);
-  size += node.position.as_span().size_in_bytes();
-  size += node.orig_position.as_span().size_in_bytes();
-  size += node.normal.as_span().size_in_bytes();
-  size += node.col.as_span().size_in_bytes();
-  size += node.mask.as_span().size_in_bytes();
-  size += node.loop_col.as_span().size_in_bytes();
-  size += node.vert_indices.as_span().size_in_bytes();
-  size += node.corner_indices.as_span().size_in_bytes();
-  size += node.vert_hidden.size() / 8;
-  size += node.face_hidden.size() / 8;
-  size += node.grids.as_span().size_in_bytes();
-  size += node.grid_hidden.all_bits().size() / 8;
-  size += node.face_sets.as_span().size_in_bytes();
-  size += node.face_indices.as_span().size_in_bytes();
-  return size;
-}
-
 void push_end_ex(Object &ob, const bool use_nested_undo)
 {
   StepData *step_data = get_step_data();
@@ -1898,17 +2114,8 @@ void push_end_ex(Object &ob, const bool use_nested_undo)
     unode->normal = {};
   }
 
-  step_data->undo_size = threading::parallel_reduce(
-      step_data->nodes.index_range(),
-      16,
-      0,
-      [&](const IndexRange range, size_t size) {
-        for (const int i : range) {
-          size += node_size_in_bytes(*step_data->nodes[i]);
-        }
-        return size;
-      },
-      std::plus<size_t>());
+  step_data->undo_size = step_size_in_bytes(*step_data);
+  step_data->undo_size_uncompressed = step_data->undo_size;
 
   /* We could remove this and enforce all callers run in an operator using 'OPTYPE_UNDO'. */
   wmWindowManager *wm = static_cast<wmWindowManager *>(G_MAIN->wm.first);
@@ -1927,6 +2134,8 @@ void push_end_ex(Object &ob, const bool use_nested_undo)
 
   save_active_attribute(ob, &us->active_color_end);
   print_nodes(ob, nullptr);
+
+  compress_step_async(*us);
 }
 
 /* -------------------------------------------------------------------- */
@@ -2011,8 +2220,10 @@ static void step_decode_undo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == true);
 
+  decompress_step(us->data);
   restore_list(C, depsgraph, us->data);
   us->step.is_applied = false;
+  compress_step_async(*us);
 
   print_nodes(*CTX_data_active_object(C), nullptr);
 }
@@ -2021,8 +2232,10 @@ static void step_decode_redo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == false);
 
+  decompress_step(us->data);
   restore_list(C, depsgraph, us->data);
   us->step.is_applied = true;
+  compress_step_async(*us);
 
   print_nodes(*CTX_data_active_object(C), nullptr);
 }
@@ -2086,6 +2299,8 @@ static void step_decode(
   /* NOTE: behavior for undo/redo closely matches image undo. */
   BLI_assert(dir != STEP_INVALID);
 
+  compression_wait();
+
   Depsgraph *depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
 
   /* Ensure sculpt mode. */
@@ -2136,6 +2351,7 @@ static void step_decode(
 static void step_free(UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
+  compression_wait();
   free_step_data(us->data);
 }
 
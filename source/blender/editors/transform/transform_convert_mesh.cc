@@ -11,14 +11,16 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
+#include "BLI_array.hh"
 #include "BLI_bitmap.h"
-#include "BLI_linklist_stack.h"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_memarena.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines_stack.h"
+#include "BLI_vector.hh"
 
 #include "BKE_context.hh"
 #include "BKE_crazyspace.hh"
@@ -808,73 +810,76 @@ void transform_convert_mesh_islands_calc(BMEditMesh *em,
 
     BM_mesh_elem_index_ensure(bm, BM_VERT);
 
-    /* May be an edge OR a face array. */
-    for (i = 0; i < data.island_tot; i++) {
-      BMEditSelection ese = {nullptr};
+    /* May be an edge OR a face array.
+     * Islands never share vertices, so each one can be handled independently. */
+    threading::parallel_for(IndexRange(data.island_tot), 64, [&](const IndexRange range) {
+      for (const int i : range) {
+        BMEditSelection ese = {nullptr};
 
-      const int fg_sta = group_index[i][0];
-      const int fg_len = group_index[i][1];
-      float co[3], no[3], tangent[3];
-      int j;
+        const int fg_sta = group_index[i][0];
+        const int fg_len = group_index[i][1];
+        float co[3], no[3], tangent[3];
+        int j;
 
-      zero_v3(co);
-      zero_v3(no);
-      zero_v3(tangent);
+        zero_v3(co);
+        zero_v3(no);
+        zero_v3(tangent);
 
-      ese.htype = htype;
+        ese.htype = htype;
 
-      /* Loop on each face or edge in this group:
-       * - Assign `r_vert_map`.
-       * - Calculate (`co`, `no`).
-       */
-      for (j = 0; j < fg_len; j++) {
-        ese.ele = static_cast<BMElem *>(ele_array[groups_array[fg_sta + j]]);
+        /* Loop on each face or edge in this group:
+         * - Assign `r_vert_map`.
+         * - Calculate (`co`, `no`).
+         */
+        for (j = 0; j < fg_len; j++) {
+          ese.ele = static_cast<BMElem *>(ele_array[groups_array[fg_sta + j]]);
 
-        if (data.center) {
-          float tmp_co[3];
-          BM_editselection_center(&ese, tmp_co);
-          add_v3_v3(co, tmp_co);
-        }
+          if (data.center) {
+            float tmp_co[3];
+            BM_editselection_center(&ese, tmp_co);
+            add_v3_v3(co, tmp_co);
+          }
 
-        if (data.axismtx) {
-          float tmp_no[3], tmp_tangent[3];
-          BM_editselection_normal(&ese, tmp_no);
-          BM_editselection_plane(&ese, tmp_tangent);
-          add_v3_v3(no, tmp_no);
-          add_v3_v3(tangent, tmp_tangent);
-        }
+          if (data.axismtx) {
+            float tmp_no[3], tmp_tangent[3];
+            BM_editselection_normal(&ese, tmp_no);
+            BM_editselection_plane(&ese, tmp_tangent);
+            add_v3_v3(no, tmp_no);
+            add_v3_v3(tangent, tmp_tangent);
+          }
 
-        {
-          /* Setup vertex map. */
-          BMIter iter;
-          BMVert *v;
+          {
+            /* Setup vertex map. */
+            BMIter iter;
+            BMVert *v;
 
-          /* Connected edge-verts. */
-          BM_ITER_ELEM (v, &iter, ese.ele, itype) {
-            data.island_vert_map[BM_elem_index_get(v)] = i;
+            /* Connected edge-verts. */
+            BM_ITER_ELEM (v, &iter, ese.ele, itype) {
+              data.island_vert_map[BM_elem_index_get(v)] = i;
+            }
           }
         }
-      }
 
-      if (data.center) {
-        mul_v3_v3fl(data.center[i], co, 1.0f / float(fg_len));
-      }
-
-      if (data.axismtx) {
-        if (createSpaceNormalTangent(data.axismtx[i], no, tangent)) {
-          /* Pass. */
+        if (data.center) {
+          mul_v3_v3fl(data.center[i], co, 1.0f / float(fg_len));
         }
-        else {
-          if (normalize_v3(no) != 0.0f) {
-            axis_dominant_v3_to_m3(data.axismtx[i], no);
-            invert_m3(data.axismtx[i]);
+
+        if (data.axismtx) {
+          if (createSpaceNormalTangent(data.axismtx[i], no, tangent)) {
+            /* Pass. */
           }
           else {
-            unit_m3(data.axismtx[i]);
+            if (normalize_v3(no) != 0.0f) {
+              axis_dominant_v3_to_m3(data.axismtx[i], no);
+              invert_m3(data.axismtx[i]);
+            }
+            else {
+              unit_m3(data.axismtx[i]);
+            }
           }
         }
       }
-    }
+    });
 
     MEM_freeN(groups_array);
     MEM_freeN(group_index);
@@ -947,13 +952,16 @@ void transform_convert_mesh_islanddata_free(TransIslandData *island_data)
 /** \name Connectivity Distance for Proportional Editing
  * \{ */
 
-/* Propagate distance from v1 and v2 to v0. */
-static bool bmesh_test_dist_add(BMVert *v0,
-                                BMVert *v1,
-                                BMVert *v2,
-                                float *dists, /* Optionally track original index. */
-                                int *index,
-                                const float mtx[3][3])
+/**
+ * Calculate the distance propagated from v1 and v2 to v0.
+ * \return true when this is shorter than the current distance of v0.
+ */
+static bool bmesh_test_dist_calc(const BMVert *v0,
+                                 const BMVert *v1,
+                                 const BMVert *v2,
+                                 const float *dists,
+                                 const float mtx[3][3],
+                                 float *r_dist)
 {
   if ((BM_elem_flag_test(v0, BM_ELEM_SELECT) == 0) && (BM_elem_flag_test(v0, BM_ELEM_HIDDEN) == 0))
   {
@@ -992,10 +1000,7 @@ static bool bmesh_test_dist_add(BMVert *v0,
     }
 
     if (dist0 < dists[i0]) {
-      dists[i0] = dist0;
-      if (index != nullptr) {
-        index[i0] = index[i1];
-      }
+      *r_dist = dist0;
       return true;
     }
   }
@@ -1021,139 +1026,191 @@ static bool bmesh_test_loose_edge(BMEdge *edge)
   return true;
 }
 
+/** A shorter distance for a vertex, found while propagating from a queued edge. */
+struct DistPropagation {
+  BMVert *v;
+  /** The queued edge the distance was propagated from. */
+  BMEdge *e;
+  float dist;
+  int index;
+  /** True when propagated along `e`, otherwise across a face using `e`. */
+  bool is_along_edge;
+};
+
+/**
+ * Find the vertices that can be reached with a shorter distance from a queued edge.
+ * Only reads `dists` & `index`, so this can run for all queued edges in parallel.
+ */
+static void bmesh_dist_propagate_from_edge(BMEdge *e,
+                                           const float *dists,
+                                           const int *index,
+                                           const float mtx[3][3],
+                                           const int tag_loose,
+                                           Vector<DistPropagation> &r_propagations)
+{
+  BMVert *v1 = e->v1;
+  BMVert *v2 = e->v2;
+  int i1 = BM_elem_index_get(v1);
+  int i2 = BM_elem_index_get(v2);
+  const bool is_loose = BM_elem_flag_test(e, tag_loose);
+
+  /* Propagate from vertex with smallest to largest distance. */
+  if (dists[i1] > dists[i2]) {
+    std::swap(i1, i2);
+    std::swap(v1, v2);
+  }
+  const int index_src = index ? index[i1] : i1;
+
+  if (is_loose || dists[i2] == FLT_MAX) {
+    /* Propagate along edge. */
+    float dist;
+    if (bmesh_test_dist_calc(v2, v1, nullptr, dists, mtx, &dist)) {
+      r_propagations.append({v2, e, dist, index_src, true});
+    }
+    /* Propagating across needs both distances,
+     * a non-loose edge is queued again once `v2` has been reached. */
+    return;
+  }
+
+  /* Propagate across edge to vertices in adjacent faces. */
+  BMLoop *l;
+  BMIter liter;
+  BM_ITER_ELEM (l, &liter, e, BM_LOOPS_OF_EDGE) {
+    if (BM_elem_flag_test(l->f, BM_ELEM_HIDDEN)) {
+      continue;
+    }
+    /* Don't check hidden edges or vertices in this loop
+     * since any hidden edge causes the face to be hidden too. */
+    for (BMLoop *l_other = l->next->next; l_other != l; l_other = l_other->next) {
+      BMVert *v_other = l_other->v;
+      BLI_assert(!ELEM(v_other, v1, v2));
+
+      float dist;
+      if (bmesh_test_dist_calc(v_other, v1, v2, dists, mtx, &dist)) {
+        r_propagations.append({v_other, e, dist, index_src, false});
+      }
+    }
+  }
+}
+
 void transform_convert_mesh_connectivity_distance(BMesh *bm,
                                                   const float mtx[3][3],
                                                   float *dists,
                                                   int *index)
 {
-  BLI_LINKSTACK_DECLARE(queue, BMEdge *);
-
   /* Any BM_ELEM_TAG'd edge is in 'queue_next', so we don't add in twice. */
   const int tag_queued = BM_ELEM_TAG;
   const int tag_loose = BM_ELEM_TAG_ALT;
 
-  BLI_LINKSTACK_DECLARE(queue_next, BMEdge *);
-
-  BLI_LINKSTACK_INIT(queue);
-  BLI_LINKSTACK_INIT(queue_next);
-
-  {
-    /* Set indexes and initial distances for selected vertices. */
-    BMIter viter;
-    BMVert *v;
-    int i;
-
-    BM_ITER_MESH_INDEX (v, &viter, bm, BM_VERTS_OF_MESH, i) {
-      float dist;
-      BM_elem_index_set(v, i); /* set_inline */
+  BM_mesh_elem_index_ensure(bm, BM_VERT);
+  BM_mesh_elem_table_ensure(bm, BM_VERT | BM_EDGE);
 
+  /* Set initial distances for selected vertices. */
+  threading::parallel_for(IndexRange(bm->totvert), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const BMVert *v = BM_vert_at_index(bm, i);
       if (BM_elem_flag_test(v, BM_ELEM_SELECT) == 0 || BM_elem_flag_test(v, BM_ELEM_HIDDEN)) {
-        dist = FLT_MAX;
-        if (index != nullptr) {
-          index[i] = i;
-        }
+        dists[i] = FLT_MAX;
       }
       else {
-        dist = 0.0f;
-        if (index != nullptr) {
-          index[i] = i;
-        }
+        dists[i] = 0.0f;
+      }
+      if (index != nullptr) {
+        index[i] = i;
       }
-
-      dists[i] = dist;
     }
-    bm->elem_index_dirty &= ~BM_VERT;
-  }
-
-  {
-    /* Add edges with at least one selected vertex to the queue. */
-    BMIter eiter;
-    BMEdge *e;
-
-    BM_ITER_MESH (e, &eiter, bm, BM_EDGES_OF_MESH) {
+  });
 
+  threading::parallel_for(IndexRange(bm->totedge), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMEdge *e = BM_edge_at_index(bm, i);
       /* Always clear to satisfy the assert, also predictable to leave in cleared state. */
       BM_elem_flag_disable(e, tag_queued);
-
-      if (BM_elem_flag_test(e, BM_ELEM_HIDDEN)) {
-        continue;
+      if (!BM_elem_flag_test(e, BM_ELEM_HIDDEN)) {
+        BM_elem_flag_set(e, tag_loose, bmesh_test_loose_edge(e));
       }
+    }
+  });
 
-      BMVert *v1 = e->v1;
-      BMVert *v2 = e->v2;
-      int i1 = BM_elem_index_get(v1);
-      int i2 = BM_elem_index_get(v2);
-
-      if (dists[i1] != FLT_MAX || dists[i2] != FLT_MAX) {
-        BLI_LINKSTACK_PUSH(queue, e);
-      }
-      BM_elem_flag_set(e, tag_loose, bmesh_test_loose_edge(e));
+  /* Add edges with at least one selected vertex to the queue. */
+  Vector<BMEdge *> queue;
+  Vector<BMEdge *> queue_next;
+  for (int i = 0; i < bm->totedge; i++) {
+    BMEdge *e = BM_edge_at_index(bm, i);
+    if (BM_elem_flag_test(e, BM_ELEM_HIDDEN)) {
+      continue;
     }
-  }
+    if (dists[BM_elem_index_get(e->v1)] != FLT_MAX || dists[BM_elem_index_get(e->v2)] != FLT_MAX)
+    {
+      queue.append(e);
+    }
+  }
+
+  /* Propagate one wave-front at a time: the shorter distances are found for all queued edges in
+   * parallel, then applied in queue order, which also keeps the result deterministic. */
+  const int64_t chunk_size = 1024;
+  while (!queue.is_empty()) {
+    const int64_t chunks_num = divide_ceil_ul(queue.size(), chunk_size);
+    Array<Vector<DistPropagation>> chunk_propagations(chunks_num);
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        const IndexRange edges = queue.index_range().slice(
+            chunk * chunk_size, std::min(chunk_size, queue.size() - chunk * chunk_size));
+        for (BMEdge *e : queue.as_span().slice(edges)) {
+          bmesh_dist_propagate_from_edge(
+              e, dists, index, mtx, tag_loose, chunk_propagations[chunk]);
+        }
+      }
+    });
 
-  do {
-    BMEdge *e;
-
-    while ((e = BLI_LINKSTACK_POP(queue))) {
-      BMVert *v1 = e->v1;
-      BMVert *v2 = e->v2;
-      int i1 = BM_elem_index_get(v1);
-      int i2 = BM_elem_index_get(v2);
-
-      if (BM_elem_flag_test(e, tag_loose) || (dists[i1] == FLT_MAX || dists[i2] == FLT_MAX)) {
-        /* Propagate along edge from vertex with smallest to largest distance. */
-        if (dists[i1] > dists[i2]) {
-          std::swap(i1, i2);
-          std::swap(v1, v2);
+    for (const Span<DistPropagation> propagations : chunk_propagations) {
+      for (const DistPropagation &propagation : propagations) {
+        BMVert *v = propagation.v;
+        BMEdge *e = propagation.e;
+        const int i = BM_elem_index_get(v);
+        /* Another edge in this wave-front may have found a shorter distance already. */
+        if (propagation.dist >= dists[i]) {
+          continue;
+        }
+        dists[i] = propagation.dist;
+        if (index != nullptr) {
+          index[i] = propagation.index;
         }
 
-        if (bmesh_test_dist_add(v2, v1, nullptr, dists, index, mtx)) {
+        if (propagation.is_along_edge) {
           /* Add adjacent loose edges to the queue, or all edges if this is a loose edge.
-           * Other edges are handled by propagation across edges below. */
+           * Other edges are handled by propagation across edges. */
           BMEdge *e_other;
           BMIter eiter;
-          BM_ITER_ELEM (e_other, &eiter, v2, BM_EDGES_OF_VERT) {
+          BM_ITER_ELEM (e_other, &eiter, v, BM_EDGES_OF_VERT) {
             if (e_other != e && BM_elem_flag_test(e_other, tag_queued) == 0 &&
                 !BM_elem_flag_test(e_other, BM_ELEM_HIDDEN) &&
                 (BM_elem_flag_test(e, tag_loose) || BM_elem_flag_test(e_other, tag_loose)))
             {
               BM_elem_flag_enable(e_other, tag_queued);
-              BLI_LINKSTACK_PUSH(queue_next, e_other);
+              queue_next.append(e_other);
             }
           }
-        }
-      }
-
-      if (!BM_elem_flag_test(e, tag_loose)) {
-        /* Propagate across edge to vertices in adjacent faces. */
-        BMLoop *l;
-        BMIter liter;
-        BM_ITER_ELEM (l, &liter, e, BM_LOOPS_OF_EDGE) {
-          if (BM_elem_flag_test(l->f, BM_ELEM_HIDDEN)) {
-            continue;
+          /* Both vertices now have a known distance, propagate across the edge too. */
+          if (!BM_elem_flag_test(e, tag_loose) && BM_elem_flag_test(e, tag_queued) == 0) {
+            BM_elem_flag_enable(e, tag_queued);
+            queue_next.append(e);
           }
-          /* Don't check hidden edges or vertices in this loop
-           * since any hidden edge causes the face to be hidden too. */
-          for (BMLoop *l_other = l->next->next; l_other != l; l_other = l_other->next) {
-            BMVert *v_other = l_other->v;
-            BLI_assert(!ELEM(v_other, v1, v2));
-
-            if (bmesh_test_dist_add(v_other, v1, v2, dists, index, mtx)) {
-              /* Add adjacent edges to the queue, if they are ready to propagate across/along.
-               * Always propagate along loose edges, and for other edges only propagate across
-               * if both vertices have a known distances. */
-              BMEdge *e_other;
-              BMIter eiter;
-              BM_ITER_ELEM (e_other, &eiter, v_other, BM_EDGES_OF_VERT) {
-                if (e_other != e && BM_elem_flag_test(e_other, tag_queued) == 0 &&
-                    !BM_elem_flag_test(e_other, BM_ELEM_HIDDEN) &&
-                    (BM_elem_flag_test(e_other, tag_loose) ||
-                     dists[BM_elem_index_get(BM_edge_other_vert(e_other, v_other))] != FLT_MAX))
-                {
-                  BM_elem_flag_enable(e_other, tag_queued);
-                  BLI_LINKSTACK_PUSH(queue_next, e_other);
-                }
-              }
+        }
+        else {
+          /* Add adjacent edges to the queue, if they are ready to propagate across/along.
+           * Always propagate along loose edges, and for other edges only propagate across
+           * if both vertices have a known distances. */
+          BMEdge *e_other;
+          BMIter eiter;
+          BM_ITER_ELEM (e_other, &eiter, v, BM_EDGES_OF_VERT) {
+            if (e_other != e && BM_elem_flag_test(e_other, tag_queued) == 0 &&
+                !BM_elem_flag_test(e_other, BM_ELEM_HIDDEN) &&
+                (BM_elem_flag_test(e_other, tag_loose) ||
+                 dists[BM_elem_index_get(BM_edge_other_vert(e_other, v))] != FLT_MAX))
+            {
+              BM_elem_flag_enable(e_other, tag_queued);
+              queue_next.append(e_other);
             }
           }
         }
@@ -1161,20 +1218,16 @@ void transform_convert_mesh_connectivity_distance(BMesh *bm,
     }
 
     /* Clear for the next loop. */
-    for (LinkNode *lnk = queue_next; lnk; lnk = lnk->next) {
-      BMEdge *e_link = static_cast<BMEdge *>(lnk->link);
-
-      BM_elem_flag_disable(e_link, tag_queued);
+    for (BMEdge *e : queue_next) {
+      BM_elem_flag_disable(e, tag_queued);
     }
 
-    BLI_LINKSTACK_SWAP(queue, queue_next);
+    std::swap(queue, queue_next);
+    queue_next.clear();
 
     /* None should be tagged now since 'queue_next' is empty. */
     BLI_assert(BM_iter_mesh_count_flag(BM_EDGES_OF_MESH, bm, tag_queued, true) == 0);
-  } while (BLI_LINKSTACK_SIZE(queue));
-
-  BLI_LINKSTACK_FREE(queue);
-  BLI_LINKSTACK_FREE(queue_next);
+  }
 }
 
 /** \} */
@@ -1627,43 +1680,69 @@ static void createTransEditVerts(bContext * /*C*/, TransInfo *t)
           MEM_callocN(tc->data_len * sizeof(TransDataExtension), "TransObData ext"));
     }
 
-    TransData *tob = tc->data;
-    TransDataMirror *td_mirror = tc->data_mirror;
-    BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, a) {
-      if (BM_elem_flag_test(eve, BM_ELEM_HIDDEN)) {
-        continue;
-      }
-
-      int island_index = -1;
-      if (island_data.island_vert_map) {
-        const int connected_index = (dists_index && dists_index[a] != -1) ? dists_index[a] : a;
-        island_index = island_data.island_vert_map[connected_index];
+    /* Assign the output slots up-front so the elements can be filled in parallel,
+     * keeping the same order as a serial loop over the vertices. */
+    BM_mesh_elem_index_ensure(bm, BM_VERT);
+    BM_mesh_elem_table_ensure(bm, BM_VERT);
+    Array<int> td_indices(bm->totvert, -1);
+    Array<int> td_mirror_indices(bm->totvert, -1);
+    {
+      int td_index = 0;
+      int td_mirror_index = 0;
+      for (a = 0; a < bm->totvert; a++) {
+        eve = BM_vert_at_index(bm, a);
+        if (BM_elem_flag_test(eve, BM_ELEM_HIDDEN)) {
+          continue;
+        }
+        if (mirror_data.vert_map && mirror_data.vert_map[a].index != -1) {
+          td_mirror_indices[a] = td_mirror_index++;
+        }
+        else if (prop_mode || BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
+          td_indices[a] = td_index++;
+        }
       }
+      BLI_assert(td_index == tc->data_len);
+      BLI_assert(td_mirror_index == tc->data_mirror_len);
+    }
 
-      if (mirror_data.vert_map && mirror_data.vert_map[a].index != -1) {
-        int elem_index = mirror_data.vert_map[a].index;
-        BMVert *v_src = BM_vert_at_index(bm, elem_index);
+    threading::parallel_for(IndexRange(bm->totvert), 1024, [&](const IndexRange range) {
+      for (const int a : range) {
+        if (td_indices[a] == -1 && td_mirror_indices[a] == -1) {
+          continue;
+        }
+        BMVert *eve = BM_vert_at_index(bm, a);
 
-        if (BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
-          mirror_data.vert_map[a].flag |= TD_SELECTED;
+        int island_index = -1;
+        if (island_data.island_vert_map) {
+          const int connected_index = (dists_index && dists_index[a] != -1) ? dists_index[a] :
+                                                                              a;
+          island_index = island_data.island_vert_map[connected_index];
         }
 
-        td_mirror->extra = eve;
-        td_mirror->loc = eve->co;
-        copy_v3_v3(td_mirror->iloc, eve->co);
-        td_mirror->flag = mirror_data.vert_map[a].flag;
-        td_mirror->loc_src = v_src->co;
-        mesh_transdata_center_copy(&island_data, island_index, td_mirror->iloc, td_mirror->center);
+        if (td_mirror_indices[a] != -1) {
+          TransDataMirror *td_mirror = &tc->data_mirror[td_mirror_indices[a]];
+          int elem_index = mirror_data.vert_map[a].index;
+          BMVert *v_src = BM_vert_at_index(bm, elem_index);
 
-        td_mirror++;
-      }
-      else if (prop_mode || BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
+          if (BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
+            mirror_data.vert_map[a].flag |= TD_SELECTED;
+          }
+
+          td_mirror->extra = eve;
+          td_mirror->loc = eve->co;
+          copy_v3_v3(td_mirror->iloc, eve->co);
+          td_mirror->flag = mirror_data.vert_map[a].flag;
+          td_mirror->loc_src = v_src->co;
+          mesh_transdata_center_copy(
+              &island_data, island_index, td_mirror->iloc, td_mirror->center);
+          continue;
+        }
+
+        TransData *tob = &tc->data[td_indices[a]];
         /* Do not use the island center in case we are using islands
          * only to get axis for snap/rotate to normal... */
-        VertsToTransData(t, tob, tx, em, eve, &island_data, island_index);
-        if (tx) {
-          tx++;
-        }
+        VertsToTransData(
+            t, tob, tx ? &tx[td_indices[a]] : nullptr, em, eve, &island_data, island_index);
 
         /* Selected. */
         if (BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
@@ -1700,10 +1779,8 @@ static void createTransEditVerts(bContext * /*C*/, TransInfo *t)
             tob->flag |= TD_MIRROR_EDGE_Z;
           }
         }
-
-        tob++;
       }
-    }
+    });
 
     transform_convert_mesh_islanddata_free(&island_data);
     transform_convert_mesh_mirrordata_free(&mirror_data);
@@ -2038,35 +2115,39 @@ static void mesh_partial_update(TransInfo *t,
 static void mesh_transdata_mirror_apply(TransDataContainer *tc)
 {
   if (tc->use_mirror_axis_any) {
-    int i;
-    TransData *td;
-    for (i = 0, td = tc->data; i < tc->data_len; i++, td++) {
-      if (td->flag & (TD_MIRROR_EDGE_X | TD_MIRROR_EDGE_Y | TD_MIRROR_EDGE_Z)) {
-        if (td->flag & TD_MIRROR_EDGE_X) {
-          td->loc[0] = 0.0f;
-        }
-        if (td->flag & TD_MIRROR_EDGE_Y) {
-          td->loc[1] = 0.0f;
-        }
-        if (td->flag & TD_MIRROR_EDGE_Z) {
-          td->loc[2] = 0.0f;
+    threading::parallel_for(IndexRange(tc->data_len), 4096, [&](const IndexRange range) {
+      for (TransData &td : MutableSpan(tc->data, tc->data_len).slice(range)) {
+        if (td.flag & (TD_MIRROR_EDGE_X | TD_MIRROR_EDGE_Y | TD_MIRROR_EDGE_Z)) {
+          if (td.flag & TD_MIRROR_EDGE_X) {
+            td.loc[0] = 0.0f;
+          }
+          if (td.flag & TD_MIRROR_EDGE_Y) {
+            td.loc[1] = 0.0f;
+          }
+          if (td.flag & TD_MIRROR_EDGE_Z) {
+            td.loc[2] = 0.0f;
+          }
         }
       }
-    }
+    });
 
-    TransDataMirror *td_mirror = tc->data_mirror;
-    for (i = 0; i < tc->data_mirror_len; i++, td_mirror++) {
-      copy_v3_v3(td_mirror->loc, td_mirror->loc_src);
-      if (td_mirror->flag & TD_MIRROR_X) {
-        td_mirror->loc[0] *= -1;
-      }
-      if (td_mirror->flag & TD_MIRROR_Y) {
-        td_mirror->loc[1] *= -1;
-      }
-      if (td_mirror->flag & TD_MIRROR_Z) {
-        td_mirror->loc[2] *= -1;
+    /* Run after the loop above, mirrored vertices read the locations it writes. */
+    threading::parallel_for(IndexRange(tc->data_mirror_len), 4096, [&](const IndexRange range) {
+      for (TransDataMirror &td_mirror :
+           MutableSpan(tc->data_mirror, tc->data_mirror_len).slice(range))
+      {
+        copy_v3_v3(td_mirror.loc, td_mirror.loc_src);
+        if (td_mirror.flag & TD_MIRROR_X) {
+          td_mirror.loc[0] *= -1;
+        }
+        if (td_mirror.flag & TD_MIRROR_Y) {
+          td_mirror.loc[1] *= -1;
+        }
+        if (td_mirror.flag & TD_MIRROR_Z) {
+          td_mirror.loc[2] *= -1;
+        }
       }
-    }
+    });
   }
 }
 
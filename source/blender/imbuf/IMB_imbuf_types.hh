@@ -112,6 +112,11 @@ enum eImBufFlags {
   IB_thumbnail = 1 << 16,
   IB_multiview = 1 << 17,
   IB_halffloat = 1 << 18,
+  /**
+   * With #IB_multilayer, only read the layers and passes of the file, the pixels of a pass are
+   * read when it's needed with #IMB_exr_read_pass.
+   */
+  IB_multilayer_lazy = 1 << 19,
 };
 
 /** \} */
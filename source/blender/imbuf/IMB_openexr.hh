@@ -75,6 +75,15 @@ float *IMB_exr_channel_rect(void *handle,
                             const char *viewname);
 
 void IMB_exr_read_channels(void *handle);
+/**
+ * Read the pixels of a single pass into \a rect, for handles of files loaded with
+ * #IB_multilayer_lazy. Only the channels of the pass are decoded to floats.
+ *
+ * \param passname: The pass name as stored in the file, without the layer.
+ * \return false when the pass is not found or could not be read.
+ */
+bool IMB_exr_read_pass(
+    void *handle, const char *layname, const char *passname, const char *viewname, float *rect);
 void IMB_exr_write_channels(void *handle);
 /**
  * Temporary function, used for FSA and Save Buffers.
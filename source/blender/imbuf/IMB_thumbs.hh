@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BLI_span.hh"
+
 struct ImBuf;
 
 /**
@@ -75,6 +77,21 @@ void IMB_thumb_delete(const char *file_or_lib_path, ThumbSize size);
  */
 ImBuf *IMB_thumb_manage(const char *file_or_lib_path, ThumbSize size, ThumbSource source);
 
+struct ThumbBatchItem {
+  /** File path or library-ID path, see #IMB_thumb_manage. */
+  const char *file_or_lib_path;
+  ThumbSource source;
+  /** The resulting thumbnail, owned by the caller. Null when there is none. */
+  ImBuf *thumb;
+};
+
+/**
+ * Same as #IMB_thumb_manage for many files at once. The thumbnails are read, created and written
+ * in parallel by the task scheduler. Items for the same path are processed once, the others get a
+ * copy of the thumbnail.
+ */
+void IMB_thumb_manage_batch(blender::MutableSpan<ThumbBatchItem> items, ThumbSize size);
+
 /**
  * Create the necessary directories to store the thumbnails.
  */
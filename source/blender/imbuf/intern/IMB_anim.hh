@@ -19,6 +19,19 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+
+/**
+ * Number of recently decoded frames kept by a movie. Kept small because the frames are not
+ * accounted for by any cache limit, a 4K 4:2:0 frame takes about 12 MB.
+ */
+#  define IMB_ANIM_DECODED_FRAMES_MAX 4
+
+/** Reference to a decoded frame and the PTS range it covers. */
+struct ImBufAnimDecodedFrame {
+  AVFrame *frame;
+  int64_t pts_start;
+  int64_t pts_end;
+};
 #endif
 
 struct IDProperty;
@@ -59,6 +72,17 @@ struct ImBufAnim {
   AVPacket *cur_packet;
 
   bool seek_before_decode;
+
+  /**
+   * Ring buffer of recently decoded frames, so that scrubbing back over them doesn't need to
+   * seek and decode their GOP again. Holds up to #IMB_ANIM_DECODED_FRAMES_MAX frames, the next
+   * decoded frame replaces `decoded_frames_next`.
+   */
+  ImBufAnimDecodedFrame decoded_frames[IMB_ANIM_DECODED_FRAMES_MAX];
+  int decoded_frames_num;
+  int decoded_frames_next;
+  /** Largest distance between consecutive key frames decoded so far, in PTS units. */
+  int64_t gop_pts_max;
 #endif
 
   char index_dir[768];
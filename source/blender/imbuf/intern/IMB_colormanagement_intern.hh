@@ -11,6 +11,8 @@
 #include "BLI_sys_types.h"
 #include "DNA_listBase.h"
 
+struct ColorManagedDisplaySettings;
+struct ColorManagedViewSettings;
 struct ImBuf;
 struct OCIO_ConstCPUProcessorRc;
 typedef struct OCIO_ConstCPUProcessorRc *OCIO_ConstCPUProcessorRcPtr;
@@ -112,3 +114,11 @@ void colorspace_set_default_role(char *colorspace, int size, int role);
 
 void colormanage_imbuf_set_default_spaces(ImBuf *ibuf);
 void colormanage_imbuf_make_linear(ImBuf *ibuf, const char *from_colorspace);
+
+/**
+ * Bake the lookup table that display buffers of large float images are computed with, which is
+ * otherwise only baked once the settings are used repeatedly. Returns false when the transform
+ * of the settings can't be represented accurately enough by a table.
+ */
+bool colormanage_display_lut_bake(const ColorManagedViewSettings *view_settings,
+                                  const ColorManagedDisplaySettings *display_settings);
@@ -216,6 +216,16 @@ ImBuf *imb_load_tiff(const unsigned char *mem,
                      size_t size,
                      int flags,
                      char colorspace[IM_MAX_SPACE]);
+/**
+ * Load a thumbnail of a TIFF file, from a reduced resolution sub-image or MIP level when the
+ * file contains one.
+ */
+ImBuf *imb_load_filepath_thumbnail_tiff(const char *filepath,
+                                        const int flags,
+                                        const size_t max_thumb_size,
+                                        char colorspace[IM_MAX_SPACE],
+                                        size_t *r_width,
+                                        size_t *r_height);
 /**
  * Saves a TIFF file.
  *
@@ -23,23 +23,13 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "GPU_texture.hh"
 
-static SpinLock refcounter_spin;
-
-void imb_refcounter_lock_init()
-{
-  BLI_spin_init(&refcounter_spin);
-}
-
-void imb_refcounter_lock_exit()
-{
-  BLI_spin_end(&refcounter_spin);
-}
-
 #ifndef WIN32
 static SpinLock mmap_spin;
 
@@ -250,16 +240,8 @@ void IMB_freeImBuf(ImBuf *ibuf)
     return;
   }
 
-  bool needs_free = false;
-
-  BLI_spin_lock(&refcounter_spin);
-  if (ibuf->refcounter > 0) {
-    ibuf->refcounter--;
-  }
-  else {
-    needs_free = true;
-  }
-  BLI_spin_unlock(&refcounter_spin);
+  /* The counter is the number of users besides the first one, the last user frees. */
+  const bool needs_free = atomic_sub_and_fetch_int32(&ibuf->refcounter, 1) < 0;
 
   if (needs_free) {
     /* Include this check here as the path may be manipulated after creation. */
@@ -277,9 +259,7 @@ void IMB_freeImBuf(ImBuf *ibuf)
 
 void IMB_refImBuf(ImBuf *ibuf)
 {
-  BLI_spin_lock(&refcounter_spin);
-  ibuf->refcounter++;
-  BLI_spin_unlock(&refcounter_spin);
+  atomic_add_and_fetch_int32(&ibuf->refcounter, 1);
 }
 
 ImBuf *IMB_makeSingleUser(ImBuf *ibuf)
@@ -288,9 +268,7 @@ ImBuf *IMB_makeSingleUser(ImBuf *ibuf)
     return nullptr;
   }
 
-  BLI_spin_lock(&refcounter_spin);
-  const bool is_single = (ibuf->refcounter == 0);
-  BLI_spin_unlock(&refcounter_spin);
+  const bool is_single = (atomic_load_int32(&ibuf->refcounter) == 0);
   if (is_single) {
     return ibuf;
   }
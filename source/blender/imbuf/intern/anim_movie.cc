@@ -356,6 +356,10 @@ static int startffmpeg(ImBufAnim *anim)
   anim->cur_packet = av_packet_alloc();
   anim->cur_packet->stream_index = -1;
 
+  anim->decoded_frames_num = 0;
+  anim->decoded_frames_next = 0;
+  anim->gop_pts_max = 0;
+
   anim->pFrame = av_frame_alloc();
   anim->pFrame_backup = av_frame_alloc();
   anim->pFrame_backup_complete = false;
@@ -551,7 +555,7 @@ static void ffmpeg_postprocess(ImBufAnim *anim, AVFrame *input, ImBuf *ibuf)
 
   if (anim->ib_flags & IB_animdeinterlace) {
     if (av_image_deinterlace(anim->pFrameDeinterlaced,
-                             anim->pFrame,
+                             input,
                              anim->pCodecCtx->pix_fmt,
                              anim->pCodecCtx->width,
                              anim->pCodecCtx->height) < 0)
@@ -656,14 +660,90 @@ static AVFrame *ffmpeg_frame_by_pts_get(ImBufAnim *anim, int64_t pts_to_search)
   return best_frame;
 }
 
+/**
+ * Keep a reference to the frame just decoded into `anim->pFrame`, replacing the oldest one.
+ * \param in_sequence: The previously added frame was decoded right before, without seeking.
+ */
+static void ffmpeg_decoded_frames_add(ImBufAnim *anim, const bool in_sequence)
+{
+  const int64_t pts_start = av_get_pts_from_frame(anim->pFrame);
+
+  /* Frame durations are not reliable, see #ffmpeg_frame_by_pts_get. When the previous frame was
+   * decoded right before, it ends where the new one starts. */
+  if (in_sequence && anim->decoded_frames_num > 0) {
+    const int last = (anim->decoded_frames_next + IMB_ANIM_DECODED_FRAMES_MAX - 1) %
+                     IMB_ANIM_DECODED_FRAMES_MAX;
+    ImBufAnimDecodedFrame &last_decoded = anim->decoded_frames[last];
+    if (last_decoded.pts_start < pts_start) {
+      last_decoded.pts_end = pts_start;
+    }
+  }
+
+  ImBufAnimDecodedFrame &decoded = anim->decoded_frames[anim->decoded_frames_next];
+  if (decoded.frame == nullptr) {
+    decoded.frame = av_frame_alloc();
+  }
+  else {
+    av_frame_unref(decoded.frame);
+  }
+  decoded.pts_start = pts_start;
+  decoded.pts_end = pts_start + av_get_frame_duration_in_pts_units(anim->pFrame);
+  if (av_frame_ref(decoded.frame, anim->pFrame) < 0) {
+    /* Empty range, never matched. */
+    decoded.pts_end = pts_start;
+  }
+
+  anim->decoded_frames_num = std::max(anim->decoded_frames_num, anim->decoded_frames_next + 1);
+  anim->decoded_frames_next = (anim->decoded_frames_next + 1) % IMB_ANIM_DECODED_FRAMES_MAX;
+}
+
+/* Return a recently decoded frame that matches `pts_to_search`, nullptr if there is none. */
+static AVFrame *ffmpeg_decoded_frames_find(ImBufAnim *anim, int64_t pts_to_search)
+{
+  for (int i = 0; i < anim->decoded_frames_num; i++) {
+    const ImBufAnimDecodedFrame &decoded = anim->decoded_frames[i];
+    /* The frame has to match the conversion context, the resolution can change with WebM. */
+    if (decoded.frame->width != anim->pCodecCtx->width ||
+        decoded.frame->height != anim->pCodecCtx->height ||
+        decoded.frame->format != anim->pCodecCtx->pix_fmt)
+    {
+      continue;
+    }
+    if (ffmpeg_pts_isect(decoded.pts_start, decoded.pts_end, pts_to_search)) {
+      final_frame_log(anim, decoded.pts_start, decoded.pts_end, "Cached");
+      return decoded.frame;
+    }
+  }
+  return nullptr;
+}
+
+static void ffmpeg_decoded_frames_free(ImBufAnim *anim)
+{
+  for (int i = 0; i < anim->decoded_frames_num; i++) {
+    av_frame_free(&anim->decoded_frames[i].frame);
+  }
+  anim->decoded_frames_num = 0;
+  anim->decoded_frames_next = 0;
+}
+
 static void ffmpeg_decode_store_frame_pts(ImBufAnim *anim)
 {
+  /* After seeking this is -1 until the first frame is decoded. */
+  const int64_t prev_pts = anim->cur_pts;
   anim->cur_pts = av_get_pts_from_frame(anim->pFrame);
 
   if (anim->pFrame->key_frame) {
+    /* The GOP is only known when its start was decoded without seeking in between. */
+    if (prev_pts != -1 && anim->cur_key_frame_pts != -1 &&
+        anim->cur_key_frame_pts < anim->cur_pts)
+    {
+      anim->gop_pts_max = std::max(anim->gop_pts_max, anim->cur_pts - anim->cur_key_frame_pts);
+    }
     anim->cur_key_frame_pts = anim->cur_pts;
   }
 
+  ffmpeg_decoded_frames_add(anim, prev_pts != -1);
+
   av_log(anim->pFormatCtx,
          AV_LOG_DEBUG,
          "  FRAME DONE: cur_pts=%" PRId64 ", guessed_pts=%" PRId64 "\n",
@@ -1086,9 +1166,27 @@ static bool ffmpeg_must_decode(ImBufAnim *anim, int position)
   return !anim->pFrame_complete || anim->cur_position != position;
 }
 
-static bool ffmpeg_must_seek(ImBufAnim *anim, int position)
+/* Without an index it's not known where the GOP of the requested frame starts. Decoding forward
+ * is cheaper than seeking while the frame is at most one GOP ahead, since decoding after seeking
+ * can also take up to a GOP. */
+static bool ffmpeg_can_scan_forward(ImBufAnim *anim, int position, int64_t pts_to_search)
+{
+  return position > anim->cur_position && anim->cur_pts != -1 &&
+         anim->cur_pts < pts_to_search && pts_to_search - anim->cur_pts <= anim->gop_pts_max;
+}
+
+static bool ffmpeg_must_seek(ImBufAnim *anim,
+                             int position,
+                             ImBufAnimIndex *tc_index,
+                             int64_t pts_to_search)
 {
   bool must_seek = position != anim->cur_position + 1 || ffmpeg_is_first_frame_decode(anim);
+  /* With an index, #ffmpeg_seek_to_key_frame knows whether the frame is in the current GOP. */
+  if (must_seek && tc_index == nullptr && !ffmpeg_is_first_frame_decode(anim) &&
+      ffmpeg_can_scan_forward(anim, position, pts_to_search))
+  {
+    must_seek = false;
+  }
   anim->seek_before_decode = must_seek;
   return must_seek;
 }
@@ -1117,12 +1215,18 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
          frame_rate,
          start_pts);
 
+  /* When scrubbing, the frame may have been decoded recently. It's used without seeking, and the
+   * decoder state including `anim->cur_position` stays as it is. */
+  AVFrame *cached_frame = nullptr;
   if (ffmpeg_must_decode(anim, position)) {
-    if (ffmpeg_must_seek(anim, position)) {
-      ffmpeg_seek_to_key_frame(anim, position, tc_index, pts_to_search);
-    }
+    cached_frame = ffmpeg_decoded_frames_find(anim, pts_to_search);
+    if (cached_frame == nullptr) {
+      if (ffmpeg_must_seek(anim, position, tc_index, pts_to_search)) {
+        ffmpeg_seek_to_key_frame(anim, position, tc_index, pts_to_search);
+      }
 
-    ffmpeg_decode_video_frame_scan(anim, pts_to_search);
+      ffmpeg_decode_video_frame_scan(anim, pts_to_search);
+    }
   }
 
   /* Update resolution as it can change per-frame with WebM. See #100741 & #100081. */
@@ -1146,7 +1250,8 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
 
   cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
 
-  AVFrame *final_frame = ffmpeg_frame_by_pts_get(anim, pts_to_search);
+  AVFrame *final_frame = cached_frame ? cached_frame :
+                                         ffmpeg_frame_by_pts_get(anim, pts_to_search);
   if (final_frame == nullptr) {
     /* No valid frame was decoded for requested PTS, fall back on most recent decoded frame, even
      * if it is incorrect. */
@@ -1159,7 +1264,9 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
     ffmpeg_postprocess(anim, final_frame, cur_frame_final);
   }
 
-  anim->cur_position = position;
+  if (cached_frame == nullptr) {
+    anim->cur_position = position;
+  }
 
   return cur_frame_final;
 }
@@ -1177,6 +1284,7 @@ static void free_anim_ffmpeg(ImBufAnim *anim)
 
     av_frame_free(&anim->pFrame);
     av_frame_free(&anim->pFrame_backup);
+    ffmpeg_decoded_frames_free(anim);
     av_frame_free(&anim->pFrameRGB);
     if (anim->pFrameDeinterlaced->data[0] != nullptr) {
       MEM_freeN(anim->pFrameDeinterlaced->data[0]);
@@ -1288,14 +1396,11 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
 #ifdef WITH_FFMPEG
   if (anim->state == ImBufAnim::State::Valid) {
     ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
-    }
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
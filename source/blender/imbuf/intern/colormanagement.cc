@@ -11,6 +11,8 @@
 
 #include <cmath>
 #include <cstring>
+#include <memory>
+#include <mutex>
 
 #include "DNA_color_types.h"
 #include "DNA_image_types.h"
@@ -28,14 +30,19 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_math_color.h"
 #include "BLI_math_color.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_appdir.hh"
 #include "BKE_colortools.hh"
@@ -79,6 +86,9 @@ static int global_tot_display = 0;
 static int global_tot_view = 0;
 static int global_tot_looks = 0;
 
+/** Incremented whenever a configuration is loaded, invalidating data derived from it. */
+static int global_config_id = 0;
+
 /* Luma coefficients and XYZ to RGB to be initialized by OCIO. */
 
 float imbuf_luma_coefficients[3] = {0.0f};
@@ -498,6 +508,8 @@ static bool colormanage_load_config(OCIO_ConstConfigRcPtr *config)
 {
   bool ok = true;
 
+  global_config_id++;
+
   /* get roles */
   ok &= colormanage_role_color_space_name_get(config, global_role_data, OCIO_ROLE_DATA, nullptr);
   ok &= colormanage_role_color_space_name_get(
@@ -733,9 +745,12 @@ void colormanagement_init()
   BLI_init_srgb_conversion();
 }
 
+static void display_lut_cache_free();
+
 void colormanagement_exit()
 {
   OCIO_gpuCacheFree();
+  display_lut_cache_free();
 
   if (global_gpu_state.curve_mapping) {
     BKE_curvemapping_free(global_gpu_state.curve_mapping);
@@ -1543,12 +1558,468 @@ bool IMB_colormanagement_set_whitepoint(const float whitepoint[3], float &temper
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Display Transform Lookup Table
+ *
+ * Applying the OCIO display processor to every pixel is the bulk of the cost of displaying large
+ * float images. For big enough images the display transform is baked into a 3D lookup table,
+ * which is then sampled with tetrahedral interpolation.
+ *
+ * The table axes are shaped with a fast log2 approximation so that the high dynamic range of
+ * scene linear values that view transforms like Filmic and AgX map to the display is covered.
+ * The range is adapted to where the transform saturates, and the table is validated against OCIO
+ * before it is used. Transforms which can not be represented accurately enough keep using OCIO,
+ * as do individual pixels outside of the table range (negative, very bright or NaN values).
+ * \{ */
+
+/** Number of table entries along each axis. */
+#define DISPLAY_LUT_SIZE 97
+/** Smaller images are transformed by OCIO directly, baking the table would not pay off. */
+#define DISPLAY_LUT_MIN_PIXELS (1024 * 1024)
+/** Largest allowed difference to OCIO, half a step of the 8 bit display buffer. */
+#define DISPLAY_LUT_TOLERANCE (0.5f / 255.0f)
+/** Output value below which the transform is considered black, and above which it is white. */
+#define DISPLAY_LUT_SATURATION_EPSILON (0.25f / 255.0f)
+#define DISPLAY_LUT_VALIDATE_SAMPLES 4096
+
+struct DisplayLUT {
+  /** Range of input values covered by the table, values below are clamped. */
+  float input_min;
+  float input_max;
+  /** Maps the bits of an input value to the table coordinate, see #display_lut_float_bits. */
+  float shaper_mul;
+  float shaper_add;
+  /** Output RGB indexed by `(b * DISPLAY_LUT_SIZE + g) * DISPLAY_LUT_SIZE + r`. */
+  blender::Array<blender::float4> table;
+};
+
+/** Configuration, view and display settings the cached table was baked for. */
+struct DisplayLUTKey {
+  int config_id;
+  char look[sizeof(ColorManagedViewSettings::look)];
+  char view_transform[sizeof(ColorManagedViewSettings::view_transform)];
+  char display_device[sizeof(ColorManagedDisplaySettings::display_device)];
+  float exposure;
+  float gamma;
+  float temperature;
+  float tint;
+  bool use_white_balance;
+};
+
+static struct DisplayLUTCache {
+  std::mutex mutex;
+  bool has_key = false;
+  DisplayLUTKey key;
+  /** Null when the transform for the key could not be baked accurately enough. */
+  std::shared_ptr<const DisplayLUT> lut;
+  /** Settings last requested while they had no table, it's baked once they're requested again. */
+  bool has_requested_key = false;
+  DisplayLUTKey requested_key;
+  bool is_baking = false;
+} global_display_lut_cache;
+
+/**
+ * The bits of a float interpreted as an integer are a piecewise linear approximation of log2
+ * (scaled by 2^23 and offset by 127). Unlike the real logarithm it is cheap to evaluate and
+ * exactly invertible, see #display_lut_exp2. It is exact at powers of two, where its slope
+ * changes, so table entries are placed there.
+ */
+BLI_INLINE int32_t display_lut_float_bits(const float value)
+{
+  int32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float display_lut_exp2(const double value)
+{
+  const int32_t bits = int32_t(round((value + 127.0) * double(1 << 23)));
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+BLI_INLINE bool display_lut_contains(const DisplayLUT &lut, const float *pixel)
+{
+  /* Written such that NaN is not contained. */
+  return pixel[0] >= 0.0f && pixel[0] <= lut.input_max && pixel[1] >= 0.0f &&
+         pixel[1] <= lut.input_max && pixel[2] >= 0.0f && pixel[2] <= lut.input_max;
+}
+
+/** Tetrahedral interpolation of the table, the pixel must be contained in the table range. */
+BLI_INLINE void display_lut_apply_pixel(const DisplayLUT &lut, float *pixel)
+{
+  using namespace blender;
+  constexpr int size = DISPLAY_LUT_SIZE;
+
+  /* Integer and fractional table coordinates. */
+  int index[4];
+  float frac[4];
+#if BLI_HAVE_SSE2
+  __m128 value = _mm_setr_ps(pixel[0], pixel[1], pixel[2], 0.0f);
+  value = _mm_max_ps(value, _mm_set1_ps(lut.input_min));
+  __m128 coord = _mm_cvtepi32_ps(_mm_castps_si128(value));
+  coord = _mm_add_ps(_mm_mul_ps(coord, _mm_set1_ps(lut.shaper_mul)), _mm_set1_ps(lut.shaper_add));
+  coord = _mm_min_ps(_mm_max_ps(coord, _mm_setzero_ps()), _mm_set1_ps(float(size - 1)));
+  /* Coordinates are small and non-negative, so the 16 bit minimum works on the 32 bit lanes. */
+  const __m128i coord_i = _mm_min_epi16(_mm_cvttps_epi32(coord), _mm_set1_epi32(size - 2));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(index), coord_i);
+  _mm_storeu_ps(frac, _mm_sub_ps(coord, _mm_cvtepi32_ps(coord_i)));
+#else
+  for (int i = 0; i < 3; i++) {
+    const float value = max_ff(pixel[i], lut.input_min);
+    const float coord = clamp_f(float(display_lut_float_bits(value)) * lut.shaper_mul +
+                                    lut.shaper_add,
+                                0.0f,
+                                float(size - 1));
+    index[i] = min_ii(int(coord), size - 2);
+    frac[i] = coord - float(index[i]);
+  }
+#endif
+
+  /* Sort the axes by descending fraction, which selects one of the six tetrahedra in the cell.
+   * The result is interpolated between its four corners, walking from the cell origin along the
+   * axes in that order. */
+  int stride[3] = {1, size, size * size};
+  if (frac[0] < frac[1]) {
+    std::swap(frac[0], frac[1]);
+    std::swap(stride[0], stride[1]);
+  }
+  if (frac[1] < frac[2]) {
+    std::swap(frac[1], frac[2]);
+    std::swap(stride[1], stride[2]);
+  }
+  if (frac[0] < frac[1]) {
+    std::swap(frac[0], frac[1]);
+    std::swap(stride[0], stride[1]);
+  }
+
+  const float4 *corner = lut.table.data() + (index[2] * size + index[1]) * size + index[0];
+  const float4 *c0 = corner;
+  const float4 *c1 = c0 + stride[0];
+  const float4 *c2 = c1 + stride[1];
+  const float4 *c3 = c2 + stride[2];
+  const float w0 = 1.0f - frac[0];
+  const float w1 = frac[0] - frac[1];
+  const float w2 = frac[1] - frac[2];
+  const float w3 = frac[2];
+
+#if BLI_HAVE_SSE2
+  __m128 result = _mm_mul_ps(_mm_loadu_ps(&c0->x), _mm_set1_ps(w0));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&c1->x), _mm_set1_ps(w1)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&c2->x), _mm_set1_ps(w2)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&c3->x), _mm_set1_ps(w3)));
+  float4 result_v;
+  _mm_storeu_ps(&result_v.x, result);
+#else
+  const float4 result_v = *c0 * w0 + *c1 * w1 + *c2 * w2 + *c3 * w3;
+#endif
+  pixel[0] = result_v.x;
+  pixel[1] = result_v.y;
+  pixel[2] = result_v.z;
+}
+
+/**
+ * Equivalent of #IMB_colormanagement_processor_apply for processors the table was baked from.
+ */
+static void display_lut_apply(const DisplayLUT &lut,
+                              ColormanageProcessor *cm_processor,
+                              float *buffer,
+                              const int width,
+                              const int height,
+                              const int channels,
+                              const bool predivide)
+{
+  using namespace blender;
+  const bool use_predivide = predivide && channels == 4;
+
+  /* Pixels outside of the table range, transformed by OCIO. */
+  Vector<int> fallback_indices;
+  Vector<float4> fallback_pixels;
+
+  for (int y = 0; y < height; y++) {
+    float *row = buffer + size_t(channels) * width * y;
+    fallback_indices.clear();
+
+    for (int x = 0; x < width; x++) {
+      float *pixel = row + size_t(channels) * x;
+      /* Same as OCIO, from premultiplied to straight alpha. */
+      if (use_predivide && pixel[3] != 0.0f && pixel[3] != 1.0f) {
+        mul_v3_fl(pixel, 1.0f / pixel[3]);
+      }
+      if (display_lut_contains(lut, pixel)) {
+        display_lut_apply_pixel(lut, pixel);
+      }
+      else {
+        fallback_indices.append(x);
+      }
+    }
+
+    if (!fallback_indices.is_empty()) {
+      fallback_pixels.resize(fallback_indices.size());
+      for (const int i : fallback_indices.index_range()) {
+        const float *pixel = row + size_t(channels) * fallback_indices[i];
+        fallback_pixels[i] = float4(pixel[0], pixel[1], pixel[2], 1.0f);
+      }
+      IMB_colormanagement_processor_apply(cm_processor,
+                                          reinterpret_cast<float *>(fallback_pixels.data()),
+                                          int(fallback_pixels.size()),
+                                          1,
+                                          4,
+                                          false);
+      for (const int i : fallback_indices.index_range()) {
+        float *pixel = row + size_t(channels) * fallback_indices[i];
+        copy_v3_v3(pixel, fallback_pixels[i]);
+      }
+    }
+
+    if (use_predivide) {
+      for (int x = 0; x < width; x++) {
+        float *pixel = row + size_t(channels) * x;
+        if (pixel[3] != 0.0f && pixel[3] != 1.0f) {
+          mul_v3_fl(pixel, pixel[3]);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Find the input range in which the transform is not saturated by sending a gray ramp through
+ * it. Returns false if the transform does not appear to map to the display range.
+ */
+static bool display_lut_find_input_range(ColormanageProcessor *cm_processor,
+                                         float *r_input_min,
+                                         float *r_input_max)
+{
+  using namespace blender;
+  constexpr int steps_per_octave = 8;
+  constexpr int octave_min = -24;
+  constexpr int octave_max = 16;
+
+  Array<float4> ramp((octave_max - octave_min) * steps_per_octave + 1);
+  for (const int i : ramp.index_range()) {
+    const float value = exp2f(float(octave_min) + float(i) / float(steps_per_octave));
+    ramp[i] = float4(value, value, value, 1.0f);
+  }
+  Array<float4> result = ramp;
+  IMB_colormanagement_processor_apply(
+      cm_processor, reinterpret_cast<float *>(result.data()), int(result.size()), 1, 4, false);
+
+  *r_input_min = ramp.first().x;
+  for (const int i : ramp.index_range()) {
+    if (max_fff(result[i].x, result[i].y, result[i].z) > DISPLAY_LUT_SATURATION_EPSILON) {
+      break;
+    }
+    /* Values below the range are clamped. Transforms which mix channels are still sensitive to
+     * small values in one channel when the others are bright, so keep a margin of a few octaves
+     * below where gray becomes black. */
+    *r_input_min = max_ff(ramp[i].x * (1.0f / 16.0f), ramp.first().x);
+  }
+
+  *r_input_max = ramp.last().x;
+  for (const int i : ramp.index_range()) {
+    if (min_fff(result[i].x, result[i].y, result[i].z) >= 1.0f - DISPLAY_LUT_SATURATION_EPSILON)
+    {
+      /* One octave of margin for colors which saturate later than gray. */
+      *r_input_max = min_ff(ramp[i].x * 2.0f, ramp.last().x);
+      break;
+    }
+  }
+
+  return *r_input_max > *r_input_min * 2.0f;
+}
+
+/** Compare the table to OCIO on random inputs within the table range. */
+static bool display_lut_validate(const DisplayLUT &lut, ColormanageProcessor *cm_processor)
+{
+  using namespace blender;
+  /* Also cover values below the table range, which are clamped. */
+  const float log_min = log2f(lut.input_min) - 4.0f;
+  const float log_max = log2f(lut.input_max);
+
+  RandomNumberGenerator rng(0);
+  Array<float4> samples(DISPLAY_LUT_VALIDATE_SAMPLES);
+  for (float4 &sample : samples) {
+    for (int i = 0; i < 3; i++) {
+      sample[i] = (rng.get_float() < 0.125f) ?
+                      0.0f :
+                      min_ff(exp2f(log_min + (log_max - log_min) * rng.get_float()),
+                             lut.input_max);
+    }
+    sample.w = 1.0f;
+  }
+
+  Array<float4> expected = samples;
+  IMB_colormanagement_processor_apply(
+      cm_processor, reinterpret_cast<float *>(expected.data()), int(expected.size()), 1, 4, false);
+
+  for (const int i : samples.index_range()) {
+    float4 result = samples[i];
+    display_lut_apply_pixel(lut, result);
+    for (int c = 0; c < 3; c++) {
+      if (fabsf(clamp_f(result[c], 0.0f, 1.0f) - clamp_f(expected[i][c], 0.0f, 1.0f)) >
+          DISPLAY_LUT_TOLERANCE)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static std::shared_ptr<const DisplayLUT> display_lut_bake(ColormanageProcessor *cm_processor)
+{
+  using namespace blender;
+  constexpr int size = DISPLAY_LUT_SIZE;
+
+  std::shared_ptr<DisplayLUT> lut = std::make_shared<DisplayLUT>();
+  if (!display_lut_find_input_range(cm_processor, &lut->input_min, &lut->input_max)) {
+    return nullptr;
+  }
+
+  /* Use a whole number of table intervals per octave, starting at a power of two. */
+  const int octave_min = int(floorf(log2f(lut->input_min)));
+  const int octaves_num = int(ceilf(log2f(lut->input_max))) - octave_min;
+  const int steps_per_octave = (size - 1) / octaves_num;
+  if (steps_per_octave < 1) {
+    return nullptr;
+  }
+  lut->input_min = ldexpf(1.0f, octave_min);
+  lut->input_max = display_lut_exp2(double(octave_min) + double(size - 1) / steps_per_octave);
+  lut->shaper_mul = float(steps_per_octave) / float(1 << 23);
+  lut->shaper_add = -float((127 + octave_min) * steps_per_octave);
+
+  Array<float> node_values(size);
+  for (const int i : node_values.index_range()) {
+    node_values[i] = display_lut_exp2(double(octave_min) + double(i) / steps_per_octave);
+  }
+
+  lut->table.reinitialize(size * size * size);
+  threading::parallel_for(IndexRange(size), 1, [&](const IndexRange range) {
+    for (const int b : range) {
+      float4 *slab = lut->table.data() + b * size * size;
+      for (int g = 0; g < size; g++) {
+        for (int r = 0; r < size; r++) {
+          slab[g * size + r] = float4(node_values[r], node_values[g], node_values[b], 1.0f);
+        }
+      }
+      IMB_colormanagement_processor_apply(
+          cm_processor, reinterpret_cast<float *>(slab), size * size, 1, 4, false);
+    }
+  });
+
+  if (!display_lut_validate(*lut, cm_processor)) {
+    return nullptr;
+  }
+  return lut;
+}
+
+static DisplayLUTKey display_lut_key(const ColorManagedViewSettings *view_settings,
+                                     const ColorManagedDisplaySettings *display_settings)
+{
+  DisplayLUTKey key = {};
+  key.config_id = global_config_id;
+  STRNCPY(key.look, view_settings->look);
+  STRNCPY(key.view_transform, view_settings->view_transform);
+  STRNCPY(key.display_device, display_settings->display_device);
+  key.exposure = view_settings->exposure;
+  key.gamma = view_settings->gamma;
+  key.temperature = view_settings->temperature;
+  key.tint = view_settings->tint;
+  key.use_white_balance = (view_settings->flag & COLORMANAGE_VIEW_USE_WHITE_BALANCE) != 0;
+  return key;
+}
+
+static bool display_lut_key_equal(const DisplayLUTKey &a, const DisplayLUTKey &b)
+{
+  return a.config_id == b.config_id && STREQ(a.look, b.look) &&
+         STREQ(a.view_transform, b.view_transform) &&
+         STREQ(a.display_device, b.display_device) && a.exposure == b.exposure &&
+         a.gamma == b.gamma && a.temperature == b.temperature && a.tint == b.tint &&
+         a.use_white_balance == b.use_white_balance;
+}
+
+/**
+ * Get the table for the display processor created from the given settings. Returns null when the
+ * processor is not suitable for a table or there is none yet, the caller should use the processor
+ * directly then.
+ *
+ * Settings that change on every call, e.g. while dragging the exposure, would bake tables that
+ * are used once. Unless \a bake_immediately is set, the table is only baked once the same
+ * settings are requested twice in a row. It's baked without holding the lock, other threads use
+ * the processor directly meanwhile.
+ */
+static std::shared_ptr<const DisplayLUT> display_lut_ensure(
+    ColormanageProcessor *cm_processor,
+    const ColorManagedViewSettings *view_settings,
+    const ColorManagedDisplaySettings *display_settings,
+    const bool bake_immediately)
+{
+  if (cm_processor->cpu_processor == nullptr || cm_processor->curve_mapping != nullptr ||
+      cm_processor->is_data_result)
+  {
+    return nullptr;
+  }
+
+  const DisplayLUTKey key = display_lut_key(view_settings, display_settings);
+
+  DisplayLUTCache &cache = global_display_lut_cache;
+  {
+    std::lock_guard lock(cache.mutex);
+    if (cache.has_key && display_lut_key_equal(cache.key, key)) {
+      return cache.lut;
+    }
+    const bool is_requested_again = cache.has_requested_key &&
+                                    display_lut_key_equal(cache.requested_key, key);
+    if (cache.is_baking || !(is_requested_again || bake_immediately)) {
+      cache.requested_key = key;
+      cache.has_requested_key = true;
+      return nullptr;
+    }
+    cache.is_baking = true;
+  }
+
+  std::shared_ptr<const DisplayLUT> lut = display_lut_bake(cm_processor);
+
+  std::lock_guard lock(cache.mutex);
+  cache.key = key;
+  cache.has_key = true;
+  cache.lut = lut;
+  cache.has_requested_key = false;
+  cache.is_baking = false;
+  return lut;
+}
+
+bool colormanage_display_lut_bake(const ColorManagedViewSettings *view_settings,
+                                  const ColorManagedDisplaySettings *display_settings)
+{
+  ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(view_settings,
+                                                                                 display_settings);
+  const bool has_lut = display_lut_ensure(cm_processor, view_settings, display_settings, true) !=
+                       nullptr;
+  IMB_colormanagement_processor_free(cm_processor);
+  return has_lut;
+}
+
+static void display_lut_cache_free()
+{
+  DisplayLUTCache &cache = global_display_lut_cache;
+  std::lock_guard lock(cache.mutex);
+  cache.lut.reset();
+  cache.has_key = false;
+  cache.has_requested_key = false;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Threaded Display Buffer Transform Routines
  * \{ */
 
 struct DisplayBufferThread {
   ColormanageProcessor *cm_processor;
+  const DisplayLUT *display_lut;
 
   const float *buffer;
   uchar *byte_buffer;
@@ -1572,6 +2043,7 @@ struct DisplayBufferThread {
 struct DisplayBufferInitData {
   ImBuf *ibuf;
   ColormanageProcessor *cm_processor;
+  const DisplayLUT *display_lut;
   const float *buffer;
   uchar *byte_buffer;
 
@@ -1603,6 +2075,7 @@ static void display_buffer_init_handle(void *handle_v,
   memset(handle, 0, sizeof(DisplayBufferThread));
 
   handle->cm_processor = init_data->cm_processor;
+  handle->display_lut = init_data->display_lut;
 
   if (init_data->buffer) {
     handle->buffer = init_data->buffer + offset;
@@ -1782,8 +2255,19 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 
   /* Apply processor (note: data buffers never get color space conversions). */
   if (!handle->is_data) {
-    IMB_colormanagement_processor_apply(
-        cm_processor, linear_buffer, width, height, channels, predivide);
+    if (handle->display_lut) {
+      display_lut_apply(*handle->display_lut,
+                        cm_processor,
+                        linear_buffer,
+                        width,
+                        height,
+                        channels,
+                        predivide);
+    }
+    else {
+      IMB_colormanagement_processor_apply(
+          cm_processor, linear_buffer, width, height, channels, predivide);
+    }
   }
 
   /* copy result to output buffers */
@@ -1826,12 +2310,14 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
                                           uchar *byte_buffer,
                                           float *display_buffer,
                                           uchar *display_buffer_byte,
-                                          ColormanageProcessor *cm_processor)
+                                          ColormanageProcessor *cm_processor,
+                                          const DisplayLUT *display_lut)
 {
   DisplayBufferInitData init_data;
 
   init_data.ibuf = ibuf;
   init_data.cm_processor = cm_processor;
+  init_data.display_lut = display_lut;
   init_data.buffer = buffer;
   init_data.byte_buffer = byte_buffer;
   init_data.display_buffer = display_buffer;
@@ -1912,12 +2398,22 @@ static void colormanage_display_buffer_process_ex(
     cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
   }
 
+  /* The table is only accurate enough for the byte display buffer. */
+  std::shared_ptr<const DisplayLUT> display_lut;
+  if (cm_processor && view_settings && display_buffer == nullptr && ibuf->channels >= 3 &&
+      (ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA) == 0 &&
+      size_t(ibuf->x) * size_t(ibuf->y) >= DISPLAY_LUT_MIN_PIXELS)
+  {
+    display_lut = display_lut_ensure(cm_processor, view_settings, display_settings, false);
+  }
+
   display_buffer_apply_threaded(ibuf,
                                 ibuf->float_buffer.data,
                                 ibuf->byte_buffer.data,
                                 display_buffer,
                                 display_buffer_byte,
-                                cm_processor);
+                                cm_processor,
+                                display_lut.get());
 
   if (cm_processor) {
     IMB_colormanagement_processor_free(cm_processor);
@@ -114,7 +114,7 @@ const ImFileType IMB_FILE_TYPES[] = {
         /*is_a*/ imb_is_a_tiff,
         /*load*/ imb_load_tiff,
         /*load_filepath*/ nullptr,
-        /*load_filepath_thumbnail*/ nullptr,
+        /*load_filepath_thumbnail*/ imb_load_filepath_thumbnail_tiff,
         /*save*/ imb_save_tiff,
         /*flag*/ 0,
         /*filetype*/ IMB_FTYPE_TIF,
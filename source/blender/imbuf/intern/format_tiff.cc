@@ -42,6 +42,25 @@ ImBuf *imb_load_tiff(const uchar *mem, size_t size, int flags, char colorspace[I
   return ibuf;
 }
 
+ImBuf *imb_load_filepath_thumbnail_tiff(const char *filepath,
+                                        const int flags,
+                                        const size_t max_thumb_size,
+                                        char colorspace[IM_MAX_SPACE],
+                                        size_t *r_width,
+                                        size_t *r_height)
+{
+  ImageSpec config;
+  config.attribute("oiio:UnassociatedAlpha", 1);
+
+  ReadContext ctx{nullptr, 0, "tif", IMB_FTYPE_TIF, flags};
+
+  /* All TIFFs should be in default byte colorspace. */
+  ctx.use_colorspace_role = COLOR_ROLE_DEFAULT_BYTE;
+
+  return imb_oiio_read_thumbnail(
+      ctx, filepath, config, max_thumb_size, colorspace, r_width, r_height);
+}
+
 bool imb_save_tiff(ImBuf *ibuf, const char *filepath, int flags)
 {
   const bool is_16bit = ((ibuf->foptions.flag & TIF_16BIT) && ibuf->float_buffer.data);
@@ -17,7 +17,6 @@
 
 void IMB_init()
 {
-  imb_refcounter_lock_init();
   imb_mmap_lock_init();
   imb_filetypes_init();
   colormanagement_init();
@@ -28,5 +27,4 @@ void IMB_exit()
   imb_filetypes_exit();
   colormanagement_exit();
   imb_mmap_lock_exit();
-  imb_refcounter_lock_exit();
 }
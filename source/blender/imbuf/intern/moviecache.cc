@@ -4,10 +4,21 @@
 
 /** \file
  * \ingroup bke
+ *
+ * Items of a cache are spread over several shards, each with its own hash and read/write lock, so
+ * that threads looking up different frames don't wait on each other. Memory of all caches is
+ * limited together against the cache limit of the user preferences: when it is exceeded, buffers
+ * of the least recently used items (or lowest priority, for caches with a priority callback) are
+ * freed, in one batch down to #MOVIECACHE_LIMIT_LOW_WATERMARK of the limit so that the following
+ * insertions don't have to scan the caches again. Access times come from a clock that only
+ * advances on insertion, so lookups don't write to memory shared between threads; the eviction
+ * order is only approximately LRU.
  */
 
 #undef DEBUG_MESSAGES
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib> /* for qsort */
 #include <memory.h>
 #include <mutex>
@@ -15,10 +26,15 @@
 #include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_ghash.h"
+#include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "IMB_moviecache.hh"
 
@@ -35,18 +51,30 @@
 #  define PRINT(format, ...)
 #endif
 
-static MEM_CacheLimiterC *limitor = nullptr;
+using blender::Vector;
+
+/** Number of independently locked parts of every cache. */
+#define MOVIECACHE_SHARDS_NUM 8
+
+/** Fraction of the memory limit that freeing items for the limit goes down to. */
+#define MOVIECACHE_LIMIT_LOW_WATERMARK 0.9
+
+struct MovieCacheShard {
+  ThreadRWMutex mutex;
 
-/* Image buffers managed by a moviecache might be using their own movie caches (used by color
- * management). In practice this means that, for example, freeing MovieCache used by MovieClip
- * will request freeing MovieCache owned by ImBuf. Freeing MovieCache needs to be thread-safe,
- * so regular mutex will not work here, hence the recursive lock. */
-static std::recursive_mutex limitor_lock;
+  GHash *hash;
+
+  BLI_mempool *keys_pool;
+  BLI_mempool *items_pool;
+  BLI_mempool *userkeys_pool;
+};
 
 struct MovieCache {
+  MovieCache *next, *prev;
+
   char name[64];
 
-  GHash *hash;
+  MovieCacheShard shards[MOVIECACHE_SHARDS_NUM];
   GHashHashFP hashfp;
   GHashCmpFP cmpfp;
   MovieCacheGetKeyDataFP getdatafp;
@@ -55,16 +83,15 @@ struct MovieCache {
   MovieCacheGetItemPriorityFP getitempriorityfp;
   MovieCachePriorityDeleterFP prioritydeleterfp;
 
-  BLI_mempool *keys_pool;
-  BLI_mempool *items_pool;
-  BLI_mempool *userkeys_pool;
-
   int keysize;
 
+  /** Key of the last insertion, for the priority callback. Only accessed with the lock held. */
   void *last_userkey;
+  std::mutex last_userkey_lock;
 
+  /** Set when items were added or freed, to recompute the segments. */
+  std::atomic<bool> points_outdated;
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
-  int pad;
 };
 
 struct MovieCacheKey {
@@ -75,12 +102,33 @@ struct MovieCacheKey {
 struct MovieCacheItem {
   MovieCache *cache_owner;
   ImBuf *ibuf;
-  MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
+  /** Memory of #ibuf accounted in #memory_in_use, only changed with the shard locked for write. */
+  size_t size;
+  /** Value of #access_clock when the item was last used. */
+  uint64_t last_used;
   /* Indicates that #ibuf is null, because there was an error during load. */
   bool added_empty;
 };
 
+/** All caches, for freeing items of any of them when the memory limit is exceeded. */
+static ListBase caches = {nullptr, nullptr};
+static std::mutex caches_lock;
+
+/** Only one thread frees items of over the memory limit at a time, others don't wait for it. */
+static std::mutex limit_lock;
+
+/** Total memory of the buffers of all caches. */
+static size_t memory_in_use = 0;
+/**
+ * Memory in use above which items are freed again, when freeing items did not get below the
+ * limit because the remaining ones can't be freed. Avoids scanning all caches on every insertion
+ * in that case. Zero when the limit itself applies.
+ */
+static size_t memory_retry_limit = 0;
+/** Advances on every insertion, lookups record its value in the item. */
+static uint64_t access_clock = 0;
+
 static uint moviecache_hashhash(const void *keyv)
 {
   const MovieCacheKey *key = (const MovieCacheKey *)keyv;
@@ -96,48 +144,64 @@ static bool moviecache_hashcmp(const void *av, const void *bv)
   return a->cache_owner->cmpfp(a->userkey, b->userkey);
 }
 
+static MovieCacheShard &moviecache_shard_get(MovieCache *cache, const void *userkey)
+{
+  /* The hash is mixed, because the hash tables of the shards use its lower bits as well. */
+  const uint hash = cache->hashfp(userkey);
+  return cache->shards[((hash >> 16) ^ hash) % MOVIECACHE_SHARDS_NUM];
+}
+
 static void moviecache_keyfree(void *val)
 {
   MovieCacheKey *key = (MovieCacheKey *)val;
+  MovieCacheShard &shard = moviecache_shard_get(key->cache_owner, key->userkey);
 
-  BLI_mempool_free(key->cache_owner->userkeys_pool, key->userkey);
+  BLI_mempool_free(shard.userkeys_pool, key->userkey);
 
-  BLI_mempool_free(key->cache_owner->keys_pool, key);
+  BLI_mempool_free(shard.keys_pool, key);
 }
 
-static void moviecache_valfree(void *val)
+/**
+ * Free the item, except for its buffer which is returned. Image buffers may own caches
+ * themselves (used by color management), so they are only freed once no shard is locked.
+ */
+static ImBuf *moviecache_valfree(MovieCacheShard &shard, MovieCacheItem *item)
 {
-  MovieCacheItem *item = (MovieCacheItem *)val;
   MovieCache *cache = item->cache_owner;
+  ImBuf *ibuf = item->ibuf;
 
   PRINT("%s: cache '%s' free item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
-  if (item->c_handle) {
-    limitor_lock.lock();
-    MEM_CacheLimiter_unmanage(item->c_handle);
-    limitor_lock.unlock();
-  }
-
-  if (item->ibuf) {
-    IMB_freeImBuf(item->ibuf);
-  }
+  atomic_sub_and_fetch_z(&memory_in_use, item->size);
 
   if (item->priority_data && cache->prioritydeleterfp) {
     cache->prioritydeleterfp(item->priority_data);
   }
 
-  BLI_mempool_free(item->cache_owner->items_pool, item);
+  BLI_mempool_free(shard.items_pool, item);
+
+  return ibuf;
+}
+
+/** Remove an item from a shard locked for writing, see #moviecache_valfree for the result. */
+static ImBuf *moviecache_shard_remove(MovieCacheShard &shard, const MovieCacheKey *key)
+{
+  MovieCacheItem *item = (MovieCacheItem *)BLI_ghash_popkey(shard.hash, key, moviecache_keyfree);
+  if (item == nullptr) {
+    return nullptr;
+  }
+  return moviecache_valfree(shard, item);
 }
 
-static void check_unused_keys(MovieCache *cache)
+static void check_unused_keys(MovieCacheShard &shard, Vector<ImBuf *> &r_ibufs)
 {
   GHashIterator gh_iter;
 
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
+  BLI_ghashIterator_init(&gh_iter, shard.hash);
 
   while (!BLI_ghashIterator_done(&gh_iter)) {
-    const MovieCacheKey *key = (const MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
-    const MovieCacheItem *item = (const MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
+    MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
+    MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
 
     BLI_ghashIterator_step(&gh_iter);
 
@@ -150,15 +214,24 @@ static void check_unused_keys(MovieCache *cache)
     bool remove = !item->ibuf;
 
     if (remove) {
-      PRINT("%s: cache '%s' remove item %p without buffer\n", __func__, cache->name, item);
-    }
+      PRINT("%s: cache '%s' remove item %p without buffer\n",
+            __func__,
+            item->cache_owner->name,
+            item);
 
-    if (remove) {
-      BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
+      BLI_ghash_remove(shard.hash, key, moviecache_keyfree, nullptr);
+      r_ibufs.append(moviecache_valfree(shard, item));
     }
   }
 }
 
+static void moviecache_free_ibufs(const Vector<ImBuf *> &ibufs)
+{
+  for (ImBuf *ibuf : ibufs) {
+    IMB_freeImBuf(ibuf);
+  }
+}
+
 static int compare_int(const void *av, const void *bv)
 {
   const int *a = (int *)av;
@@ -166,25 +239,6 @@ static int compare_int(const void *av, const void *bv)
   return *a - *b;
 }
 
-static void moviecache_destructor(void *p)
-{
-  MovieCacheItem *item = (MovieCacheItem *)p;
-
-  if (item && item->ibuf) {
-    MovieCache *cache = item->cache_owner;
-
-    PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
-
-    IMB_freeImBuf(item->ibuf);
-
-    item->ibuf = nullptr;
-    item->c_handle = nullptr;
-
-    /* force cached segments to be updated */
-    MEM_SAFE_FREE(cache->points);
-  }
-}
-
 static size_t get_size_in_memory(ImBuf *ibuf)
 {
   /* Keep textures in the memory to avoid constant file reload on viewport update. */
@@ -194,21 +248,9 @@ static size_t get_size_in_memory(ImBuf *ibuf)
 
   return IMB_get_size_in_memory(ibuf);
 }
-static size_t get_item_size(void *p)
-{
-  size_t size = sizeof(MovieCacheItem);
-  MovieCacheItem *item = (MovieCacheItem *)p;
-
-  if (item->ibuf) {
-    size += get_size_in_memory(item->ibuf);
-  }
-
-  return size;
-}
 
-static int get_item_priority(void *item_v, int default_priority)
+static int get_item_priority(MovieCacheItem *item, void *last_userkey, int default_priority)
 {
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
   MovieCache *cache = item->cache_owner;
   int priority;
 
@@ -222,18 +264,17 @@ static int get_item_priority(void *item_v, int default_priority)
     return default_priority;
   }
 
-  priority = cache->getitempriorityfp(cache->last_userkey, item->priority_data);
+  priority = cache->getitempriorityfp(last_userkey, item->priority_data);
 
   PRINT("%s: cache '%s' item %p priority %d\n", __func__, cache->name, item, priority);
 
   return priority;
 }
 
-static bool get_item_destroyable(void *item_v)
+static bool get_item_destroyable(MovieCacheItem *item)
 {
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
   if (item->ibuf == nullptr) {
-    return true;
+    return false;
   }
   /* IB_BITMAPDIRTY means image was modified from inside blender and
    * changes are not saved to disk.
@@ -246,20 +287,190 @@ static bool get_item_destroyable(void *item_v)
   return true;
 }
 
-void IMB_moviecache_init()
+/** An item which may be freed to get below the memory limit. */
+struct MovieCacheLimitCandidate {
+  MovieCache *cache;
+  MovieCacheShard *shard;
+  MovieCacheItem *item;
+  /** Offset of a copy of the user key, the item itself might be removed by other threads. */
+  int64_t userkey_offset;
+  size_t size;
+  uint64_t last_used;
+  int priority;
+  /** The cache has no priority callback, the priority follows from #last_used. */
+  bool use_default_priority;
+};
+
+/**
+ * Free buffers of items when the memory of all caches exceeds the limit, until it is below
+ * #MOVIECACHE_LIMIT_LOW_WATERMARK of it. The \a keep item was just added and is not freed.
+ */
+static void moviecache_enforce_limits(const MovieCacheItem *keep)
 {
-  limitor = new_MEM_CacheLimiter(moviecache_destructor, get_item_size);
+  const size_t max = MEM_CacheLimiter_get_maximum();
+
+  if (MEM_CacheLimiter_is_disabled() || max == 0) {
+    return;
+  }
+  if (atomic_load_z(&memory_in_use) <= std::max(max, atomic_load_z(&memory_retry_limit))) {
+    return;
+  }
 
-  MEM_CacheLimiter_ItemPriority_Func_set(limitor, get_item_priority);
-  MEM_CacheLimiter_ItemDestroyable_Func_set(limitor, get_item_destroyable);
+  std::unique_lock limit_lock_guard(limit_lock, std::try_to_lock);
+  if (!limit_lock_guard.owns_lock()) {
+    /* Another thread is freeing memory already. */
+    return;
+  }
+
+  const size_t low_watermark = size_t(double(max) * MOVIECACHE_LIMIT_LOW_WATERMARK);
+
+  Vector<ImBuf *> ibufs_to_free;
+  {
+    std::lock_guard caches_lock_guard(caches_lock);
+
+    /* Gather the items which can be freed, updating sizes of buffers modified after insertion.
+     * Only read locks are taken, so lookups continue meanwhile. Sizes of items are changed
+     * nonetheless: other than here, they're only accessed with the shard locked for writing. */
+    Vector<MovieCacheLimitCandidate> candidates;
+    Vector<char> userkeys;
+    Vector<char> last_userkey;
+    LISTBASE_FOREACH (MovieCache *, cache, &caches) {
+      if (cache->getitempriorityfp) {
+        /* Take a copy, insertions into any shard of the cache write the last key. */
+        std::lock_guard last_userkey_lock_guard(cache->last_userkey_lock);
+        last_userkey.resize(cache->keysize);
+        memcpy(last_userkey.data(), cache->last_userkey, cache->keysize);
+      }
+
+      for (MovieCacheShard &shard : cache->shards) {
+        BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_READ);
+        GHashIterator gh_iter;
+        GHASH_ITER (gh_iter, shard.hash) {
+          MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
+          MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
+          if (item->ibuf == nullptr) {
+            continue;
+          }
+
+          const size_t size = get_size_in_memory(item->ibuf);
+          if (size != item->size) {
+            atomic_add_and_fetch_z(&memory_in_use, size);
+            atomic_sub_and_fetch_z(&memory_in_use, item->size);
+            item->size = size;
+          }
+
+          if (item == keep || !get_item_destroyable(item)) {
+            continue;
+          }
+
+          MovieCacheLimitCandidate candidate;
+          candidate.cache = cache;
+          candidate.shard = &shard;
+          candidate.item = item;
+          candidate.userkey_offset = userkeys.size();
+          candidate.size = item->size;
+          candidate.last_used = item->last_used;
+          candidate.use_default_priority = cache->getitempriorityfp == nullptr;
+          candidate.priority = candidate.use_default_priority ?
+                                   0 :
+                                   get_item_priority(item, last_userkey.data(), 0);
+          userkeys.extend((const char *)key->userkey, cache->keysize);
+          candidates.append(candidate);
+        }
+        BLI_rw_mutex_unlock(&shard.mutex);
+      }
+    }
+
+    /* By default the least recently used items have the lowest priority, 0 being the most
+     * recently used one. */
+    std::sort(candidates.begin(),
+              candidates.end(),
+              [](const MovieCacheLimitCandidate &a, const MovieCacheLimitCandidate &b) {
+                return a.last_used > b.last_used;
+              });
+    for (const int64_t i : candidates.index_range()) {
+      if (candidates[i].use_default_priority) {
+        candidates[i].priority = -int(i);
+      }
+    }
+    std::stable_sort(candidates.begin(),
+                     candidates.end(),
+                     [](const MovieCacheLimitCandidate &a, const MovieCacheLimitCandidate &b) {
+                       return a.priority < b.priority;
+                     });
+
+    /* Pick the items to free up front, so every shard is only locked for writing once. */
+    Vector<const MovieCacheLimitCandidate *> candidates_to_free;
+    size_t memory_after = atomic_load_z(&memory_in_use);
+    for (const MovieCacheLimitCandidate &candidate : candidates) {
+      if (memory_after <= low_watermark) {
+        break;
+      }
+      memory_after -= std::min(memory_after, candidate.size);
+      candidates_to_free.append(&candidate);
+    }
+    std::sort(candidates_to_free.begin(),
+              candidates_to_free.end(),
+              [](const MovieCacheLimitCandidate *a, const MovieCacheLimitCandidate *b) {
+                return a->shard < b->shard;
+              });
+
+    MovieCacheShard *locked_shard = nullptr;
+    for (const MovieCacheLimitCandidate *candidate : candidates_to_free) {
+      MovieCacheShard &shard = *candidate->shard;
+      if (locked_shard != &shard) {
+        if (locked_shard) {
+          BLI_rw_mutex_unlock(&locked_shard->mutex);
+        }
+        BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_WRITE);
+        locked_shard = &shard;
+      }
+
+      MovieCacheKey key;
+      key.cache_owner = candidate->cache;
+      key.userkey = &userkeys[candidate->userkey_offset];
+
+      MovieCacheItem *item = (MovieCacheItem *)BLI_ghash_lookup(shard.hash, &key);
+      /* Skip items removed or replaced since they were gathered. */
+      if (item == candidate->item && get_item_destroyable(item)) {
+        PRINT("%s: cache '%s' destroy item %p buffer %p\n",
+              __func__,
+              candidate->cache->name,
+              item,
+              item->ibuf);
+
+        /* The key stays with an empty item, it's removed on the next insertion. */
+        ibufs_to_free.append(item->ibuf);
+        atomic_sub_and_fetch_z(&memory_in_use, item->size);
+        item->ibuf = nullptr;
+        item->size = 0;
+
+        /* force cached segments to be updated */
+        candidate->cache->points_outdated = true;
+      }
+    }
+    if (locked_shard) {
+      BLI_rw_mutex_unlock(&locked_shard->mutex);
+    }
+  }
+
+  /* When the remaining items can't be freed, only try again once as much memory was added as a
+   * successful run would have freed. */
+  const size_t memory_remaining = atomic_load_z(&memory_in_use);
+  atomic_store_z(&memory_retry_limit,
+                 memory_remaining > max ? memory_remaining + (max - low_watermark) : 0);
+
+  moviecache_free_ibufs(ibufs_to_free);
+}
+
+void IMB_moviecache_init()
+{
+  /* The state shared by all caches is static, there is nothing to initialize. */
 }
 
 void IMB_moviecache_destruct()
 {
-  if (limitor) {
-    delete_MEM_CacheLimiter(limitor);
-    limitor = nullptr;
-  }
+  /* Caches are freed by their owners, there is nothing to free here. */
 }
 
 MovieCache *IMB_moviecache_create(const char *name,
@@ -271,21 +482,27 @@ MovieCache *IMB_moviecache_create(const char *name,
 
   PRINT("%s: cache '%s' create\n", __func__, name);
 
-  cache = (MovieCache *)MEM_callocN(sizeof(MovieCache), "MovieCache");
+  cache = MEM_new<MovieCache>("MovieCache");
 
   STRNCPY(cache->name, name);
 
-  cache->keys_pool = BLI_mempool_create(sizeof(MovieCacheKey), 0, 64, BLI_MEMPOOL_NOP);
-  cache->items_pool = BLI_mempool_create(sizeof(MovieCacheItem), 0, 64, BLI_MEMPOOL_NOP);
-  cache->userkeys_pool = BLI_mempool_create(keysize, 0, 64, BLI_MEMPOOL_NOP);
-  cache->hash = BLI_ghash_new(
-      moviecache_hashhash, moviecache_hashcmp, "MovieClip ImBuf cache hash");
+  for (MovieCacheShard &shard : cache->shards) {
+    BLI_rw_mutex_init(&shard.mutex);
+    shard.keys_pool = BLI_mempool_create(sizeof(MovieCacheKey), 0, 64, BLI_MEMPOOL_NOP);
+    shard.items_pool = BLI_mempool_create(sizeof(MovieCacheItem), 0, 64, BLI_MEMPOOL_NOP);
+    shard.userkeys_pool = BLI_mempool_create(keysize, 0, 64, BLI_MEMPOOL_NOP);
+    shard.hash = BLI_ghash_new(
+        moviecache_hashhash, moviecache_hashcmp, "MovieClip ImBuf cache hash");
+  }
 
   cache->keysize = keysize;
   cache->hashfp = hashfp;
   cache->cmpfp = cmpfp;
   cache->proxy = -1;
 
+  std::lock_guard lock(caches_lock);
+  BLI_addtail(&caches, cache);
+
   return cache;
 }
 
@@ -306,137 +523,143 @@ void IMB_moviecache_set_priority_callback(MovieCache *cache,
   cache->prioritydeleterfp = prioritydeleterfp;
 }
 
-static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, bool need_lock)
+void IMB_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
+  MovieCacheShard &shard = moviecache_shard_get(cache, userkey);
   MovieCacheKey *key;
   MovieCacheItem *item;
-
-  if (!limitor) {
-    IMB_moviecache_init();
-  }
+  Vector<ImBuf *> ibufs_to_free;
 
   if (ibuf != nullptr) {
     IMB_refImBuf(ibuf);
   }
 
-  key = (MovieCacheKey *)BLI_mempool_alloc(cache->keys_pool);
+  void *priority_data = nullptr;
+  if (cache->getprioritydatafp) {
+    priority_data = cache->getprioritydatafp(userkey);
+  }
+
+  const size_t size = (ibuf == nullptr) ? 0 : get_size_in_memory(ibuf);
+  atomic_add_and_fetch_z(&memory_in_use, size);
+
+  BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_WRITE);
+
+  key = (MovieCacheKey *)BLI_mempool_alloc(shard.keys_pool);
   key->cache_owner = cache;
-  key->userkey = BLI_mempool_alloc(cache->userkeys_pool);
+  key->userkey = BLI_mempool_alloc(shard.userkeys_pool);
   memcpy(key->userkey, userkey, cache->keysize);
 
-  item = (MovieCacheItem *)BLI_mempool_alloc(cache->items_pool);
+  item = (MovieCacheItem *)BLI_mempool_alloc(shard.items_pool);
 
   PRINT("%s: cache '%s' put %p, item %p\n", __func__, cache->name, ibuf, item);
 
   item->ibuf = ibuf;
   item->cache_owner = cache;
-  item->c_handle = nullptr;
-  item->priority_data = nullptr;
+  item->priority_data = priority_data;
+  item->size = size;
+  item->last_used = atomic_add_and_fetch_uint64(&access_clock, 1);
   item->added_empty = ibuf == nullptr;
 
-  if (cache->getprioritydatafp) {
-    item->priority_data = cache->getprioritydatafp(userkey);
-  }
-
-  BLI_ghash_reinsert(cache->hash, key, item, moviecache_keyfree, moviecache_valfree);
+  /* Replace an existing item of the same key. */
+  ibufs_to_free.append(moviecache_shard_remove(shard, key));
+  BLI_ghash_insert(shard.hash, key, item);
 
   if (cache->last_userkey) {
+    std::lock_guard last_userkey_lock_guard(cache->last_userkey_lock);
     memcpy(cache->last_userkey, userkey, cache->keysize);
   }
 
-  if (need_lock) {
-    limitor_lock.lock();
-  }
-
-  item->c_handle = MEM_CacheLimiter_insert(limitor, item);
+  /* Buffers freed for the memory limit leave their keys behind. */
+  check_unused_keys(shard, ibufs_to_free);
 
-  MEM_CacheLimiter_ref(item->c_handle);
-  MEM_CacheLimiter_enforce_limits(limitor);
-  MEM_CacheLimiter_unref(item->c_handle);
+  BLI_rw_mutex_unlock(&shard.mutex);
 
-  if (need_lock) {
-    limitor_lock.unlock();
-  }
+  cache->points_outdated = true;
 
-  /* cache limiter can't remove unused keys which points to destroyed values */
-  check_unused_keys(cache);
-
-  MEM_SAFE_FREE(cache->points);
-}
+  moviecache_free_ibufs(ibufs_to_free);
 
-void IMB_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
-{
-  do_moviecache_put(cache, userkey, ibuf, true);
+  moviecache_enforce_limits(item);
 }
 
 bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
   size_t mem_in_use, mem_limit, elem_size;
-  bool result = false;
 
   elem_size = (ibuf == nullptr) ? 0 : get_size_in_memory(ibuf);
   mem_limit = MEM_CacheLimiter_get_maximum();
+  mem_in_use = atomic_load_z(&memory_in_use);
 
-  limitor_lock.lock();
-  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor);
-
+  /* Other threads might add items at the same time, so the limit is approximate. */
   if (mem_in_use + elem_size <= mem_limit) {
-    do_moviecache_put(cache, userkey, ibuf, false);
-    result = true;
+    IMB_moviecache_put(cache, userkey, ibuf);
+    return true;
   }
 
-  limitor_lock.unlock();
-
-  return result;
+  return false;
 }
 
 void IMB_moviecache_remove(MovieCache *cache, void *userkey)
 {
+  MovieCacheShard &shard = moviecache_shard_get(cache, userkey);
   MovieCacheKey key;
   key.cache_owner = cache;
   key.userkey = userkey;
-  BLI_ghash_remove(cache->hash, &key, moviecache_keyfree, moviecache_valfree);
+
+  BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_WRITE);
+  ImBuf *ibuf = moviecache_shard_remove(shard, &key);
+  BLI_rw_mutex_unlock(&shard.mutex);
+
+  IMB_freeImBuf(ibuf);
 }
 
 ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey, bool *r_is_cached_empty)
 {
+  MovieCacheShard &shard = moviecache_shard_get(cache, userkey);
   MovieCacheKey key;
   MovieCacheItem *item;
+  ImBuf *ibuf = nullptr;
 
   key.cache_owner = cache;
   key.userkey = userkey;
-  item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
 
   if (r_is_cached_empty) {
     *r_is_cached_empty = false;
   }
 
+  /* Any number of threads can look up items of the same shard at once. The buffer is referenced
+   * before unlocking, so it can't be freed for the memory limit before it's returned. */
+  BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_READ);
+  item = (MovieCacheItem *)BLI_ghash_lookup(shard.hash, &key);
+
   if (item) {
     if (item->ibuf) {
-      limitor_lock.lock();
-      MEM_CacheLimiter_touch(item->c_handle);
-      limitor_lock.unlock();
+      atomic_store_uint64(&item->last_used, atomic_load_uint64(&access_clock));
 
       IMB_refImBuf(item->ibuf);
 
-      return item->ibuf;
+      ibuf = item->ibuf;
     }
-    if (r_is_cached_empty && item->added_empty) {
+    else if (r_is_cached_empty && item->added_empty) {
       *r_is_cached_empty = true;
     }
   }
+  BLI_rw_mutex_unlock(&shard.mutex);
 
-  return nullptr;
+  return ibuf;
 }
 
 bool IMB_moviecache_has_frame(MovieCache *cache, void *userkey)
 {
+  MovieCacheShard &shard = moviecache_shard_get(cache, userkey);
   MovieCacheKey key;
   MovieCacheItem *item;
 
   key.cache_owner = cache;
   key.userkey = userkey;
-  item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
+
+  BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_READ);
+  item = (MovieCacheItem *)BLI_ghash_lookup(shard.hash, &key);
+  BLI_rw_mutex_unlock(&shard.mutex);
 
   return item != nullptr;
 }
@@ -445,11 +668,26 @@ void IMB_moviecache_free(MovieCache *cache)
 {
   PRINT("%s: cache '%s' free\n", __func__, cache->name);
 
-  BLI_ghash_free(cache->hash, moviecache_keyfree, moviecache_valfree);
+  {
+    /* Waits for items of the cache to be freed for the memory limit. */
+    std::lock_guard lock(caches_lock);
+    BLI_remlink(&caches, cache);
+  }
+
+  Vector<ImBuf *> ibufs_to_free;
+  for (MovieCacheShard &shard : cache->shards) {
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, shard.hash) {
+      MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
+      ibufs_to_free.append(moviecache_valfree(shard, item));
+    }
+    BLI_ghash_free(shard.hash, nullptr, nullptr);
 
-  BLI_mempool_destroy(cache->keys_pool);
-  BLI_mempool_destroy(cache->items_pool);
-  BLI_mempool_destroy(cache->userkeys_pool);
+    BLI_mempool_destroy(shard.keys_pool);
+    BLI_mempool_destroy(shard.items_pool);
+    BLI_mempool_destroy(shard.userkeys_pool);
+    BLI_rw_mutex_end(&shard.mutex);
+  }
 
   if (cache->points) {
     MEM_freeN(cache->points);
@@ -459,31 +697,46 @@ void IMB_moviecache_free(MovieCache *cache)
     MEM_freeN(cache->last_userkey);
   }
 
-  MEM_freeN(cache);
+  MEM_delete(cache);
+
+  moviecache_free_ibufs(ibufs_to_free);
 }
 
 void IMB_moviecache_cleanup(MovieCache *cache,
                             bool(cleanup_check_cb)(ImBuf *ibuf, void *userkey, void *userdata),
                             void *userdata)
 {
-  GHashIterator gh_iter;
+  Vector<ImBuf *> ibufs_to_free;
 
-  check_unused_keys(cache);
+  for (MovieCacheShard &shard : cache->shards) {
+    GHashIterator gh_iter;
 
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
+    BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_WRITE);
 
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
-    MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
+    check_unused_keys(shard, ibufs_to_free);
 
-    BLI_ghashIterator_step(&gh_iter);
+    BLI_ghashIterator_init(&gh_iter, shard.hash);
+
+    while (!BLI_ghashIterator_done(&gh_iter)) {
+      MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
+      MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
 
-    if (cleanup_check_cb(item->ibuf, key->userkey, userdata)) {
-      PRINT("%s: cache '%s' remove item %p\n", __func__, cache->name, item);
+      BLI_ghashIterator_step(&gh_iter);
 
-      BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
+      if (cleanup_check_cb(item->ibuf, key->userkey, userdata)) {
+        PRINT("%s: cache '%s' remove item %p\n", __func__, cache->name, item);
+
+        BLI_ghash_remove(shard.hash, key, moviecache_keyfree, nullptr);
+        ibufs_to_free.append(moviecache_valfree(shard, item));
+      }
     }
+
+    BLI_rw_mutex_unlock(&shard.mutex);
   }
+
+  cache->points_outdated = true;
+
+  moviecache_free_ibufs(ibufs_to_free);
 }
 
 void IMB_moviecache_get_cache_segments(
@@ -496,7 +749,9 @@ void IMB_moviecache_get_cache_segments(
     return;
   }
 
-  if (cache->proxy != proxy || cache->render_flags != render_flags) {
+  if (cache->proxy != proxy || cache->render_flags != render_flags ||
+      cache->points_outdated.exchange(false))
+  {
     MEM_SAFE_FREE(cache->points);
   }
 
@@ -505,27 +760,30 @@ void IMB_moviecache_get_cache_segments(
     *r_points = cache->points;
   }
   else {
-    int totframe = BLI_ghash_len(cache->hash);
-    int *frames = (int *)MEM_callocN(totframe * sizeof(int), "movieclip cache frames");
-    int a, totseg = 0;
-    GHashIterator gh_iter;
-
-    a = 0;
-    GHASH_ITER (gh_iter, cache->hash) {
-      MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
-      MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
-      int framenr, curproxy, curflags;
-
-      if (item->ibuf) {
-        cache->getdatafp(key->userkey, &framenr, &curproxy, &curflags);
-
-        if (curproxy == proxy && curflags == render_flags) {
-          frames[a++] = framenr;
+    Vector<int> frames;
+    int a, totframe, totseg = 0;
+
+    for (MovieCacheShard &shard : cache->shards) {
+      GHashIterator gh_iter;
+      BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_READ);
+      GHASH_ITER (gh_iter, shard.hash) {
+        MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&gh_iter);
+        MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&gh_iter);
+        int framenr, curproxy, curflags;
+
+        if (item->ibuf) {
+          cache->getdatafp(key->userkey, &framenr, &curproxy, &curflags);
+
+          if (curproxy == proxy && curflags == render_flags) {
+            frames.append(framenr);
+          }
         }
       }
+      BLI_rw_mutex_unlock(&shard.mutex);
     }
 
-    qsort(frames, totframe, sizeof(int), compare_int);
+    totframe = int(frames.size());
+    qsort(frames.data(), totframe, sizeof(int), compare_int);
 
     /* count */
     for (a = 0; a < totframe; a++) {
@@ -567,44 +825,74 @@ void IMB_moviecache_get_cache_segments(
       cache->proxy = proxy;
       cache->render_flags = render_flags;
     }
+  }
+}
 
-    MEM_freeN(frames);
+/**
+ * Iterates over the items of all shards. Like before the cache was sharded, the caller has to
+ * make sure the cache is not modified during iteration, besides buffers freed for the memory
+ * limit, which are only cleared from their items.
+ */
+struct MovieCacheIter {
+  MovieCache *cache;
+  int shard_index;
+  GHashIterator hash_iter;
+};
+
+/* Skip to the next shard with items, when the current one is done. */
+static void moviecache_iter_skip_empty_shards(MovieCacheIter *iter)
+{
+  while (BLI_ghashIterator_done(&iter->hash_iter) &&
+         iter->shard_index < MOVIECACHE_SHARDS_NUM - 1)
+  {
+    iter->shard_index++;
+    BLI_ghashIterator_init(&iter->hash_iter, iter->cache->shards[iter->shard_index].hash);
   }
 }
 
 MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache)
 {
-  GHashIterator *iter;
+  Vector<ImBuf *> ibufs_to_free;
+  for (MovieCacheShard &shard : cache->shards) {
+    BLI_rw_mutex_lock(&shard.mutex, THREAD_LOCK_WRITE);
+    check_unused_keys(shard, ibufs_to_free);
+    BLI_rw_mutex_unlock(&shard.mutex);
+  }
+  moviecache_free_ibufs(ibufs_to_free);
 
-  check_unused_keys(cache);
-  iter = BLI_ghashIterator_new(cache->hash);
+  MovieCacheIter *iter = MEM_cnew<MovieCacheIter>("MovieCacheIter");
+  iter->cache = cache;
+  iter->shard_index = 0;
+  BLI_ghashIterator_init(&iter->hash_iter, cache->shards[0].hash);
+  moviecache_iter_skip_empty_shards(iter);
 
-  return (MovieCacheIter *)iter;
+  return iter;
 }
 
 void IMB_moviecacheIter_free(MovieCacheIter *iter)
 {
-  BLI_ghashIterator_free((GHashIterator *)iter);
+  MEM_freeN(iter);
 }
 
 bool IMB_moviecacheIter_done(MovieCacheIter *iter)
 {
-  return BLI_ghashIterator_done((GHashIterator *)iter);
+  return BLI_ghashIterator_done(&iter->hash_iter);
 }
 
 void IMB_moviecacheIter_step(MovieCacheIter *iter)
 {
-  BLI_ghashIterator_step((GHashIterator *)iter);
+  BLI_ghashIterator_step(&iter->hash_iter);
+  moviecache_iter_skip_empty_shards(iter);
 }
 
 ImBuf *IMB_moviecacheIter_getImBuf(MovieCacheIter *iter)
 {
-  MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue((GHashIterator *)iter);
+  MovieCacheItem *item = (MovieCacheItem *)BLI_ghashIterator_getValue(&iter->hash_iter);
   return item->ibuf;
 }
 
 void *IMB_moviecacheIter_getUserKey(MovieCacheIter *iter)
 {
-  MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey((GHashIterator *)iter);
+  MovieCacheKey *key = (MovieCacheKey *)BLI_ghashIterator_getKey(&iter->hash_iter);
   return key->userkey;
 }
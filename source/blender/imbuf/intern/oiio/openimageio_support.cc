@@ -3,10 +3,15 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "openimageio_support.hh"
+
+#include <algorithm>
+
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
+#include "BLI_threads.h"
 
 #include "BKE_idprop.hh"
 #include "DNA_ID.h" /* ID property definitions. */
@@ -172,6 +177,106 @@ static void set_colorspace_name(char colorspace[IM_MAX_SPACE],
   }
 }
 
+/**
+ * Load a nearest neighbor downscaled version of the image, only reading the scanlines that are
+ * needed for that.
+ */
+template<typename T>
+static ImBuf *load_pixels_sampled(ImageInput *in,
+                                  const int subimage,
+                                  const int miplevel,
+                                  const ImageSpec &spec,
+                                  const int channels,
+                                  const int dst_width,
+                                  const int dst_height,
+                                  const bool use_all_planes)
+{
+  constexpr bool is_float = sizeof(T) > 1;
+  const uint format_flag = (is_float ? IB_rectfloat : IB_rect) | IB_uninitialized_pixels;
+  const int planes = use_all_planes ? 32 : 8 * channels;
+  ImBuf *ibuf = IMB_allocImBuf(dst_width, dst_height, planes, format_flag);
+  if (!ibuf) {
+    return nullptr;
+  }
+
+  const TypeDesc format = is_float ? TypeDesc::FLOAT : TypeDesc::UINT8;
+  T *rect = is_float ? reinterpret_cast<T *>(ibuf->float_buffer.data) :
+                       reinterpret_cast<T *>(ibuf->byte_buffer.data);
+  Array<T> row(int64_t(spec.width) * channels);
+
+  for (int dst_y = 0; dst_y < dst_height; dst_y++) {
+    const int src_y = spec.y + int(int64_t(dst_y) * spec.height / dst_height);
+    bool ok = in->read_scanlines(
+        subimage, miplevel, src_y, src_y + 1, spec.z, 0, channels, format, row.data());
+    if (!ok) {
+      fprintf(stderr, "ImageInput::read_scanlines() failed: %s\n", in->geterror().c_str());
+
+      IMB_freeImBuf(ibuf);
+      return nullptr;
+    }
+
+    /* The rows of an #ImBuf are stored bottom to top. */
+    T *dst = rect + int64_t(dst_height - 1 - dst_y) * dst_width * 4;
+    for (int dst_x = 0; dst_x < dst_width; dst_x++) {
+      const int src_x = int(int64_t(dst_x) * spec.width / dst_width);
+      for (int c = 0; c < channels; c++) {
+        dst[dst_x * 4 + c] = row[int64_t(src_x) * channels + c];
+      }
+    }
+  }
+
+  /* ImBuf always needs 4 channels */
+  const T alpha_fill = is_float ? 1.0f : 0xFF;
+  fill_all_channels<T>(rect, dst_width, dst_height, channels, alpha_fill);
+
+  return ibuf;
+}
+
+/**
+ * Fill in the common #ImBuf properties and metadata for an image read from `spec`.
+ */
+static void set_ibuf_properties(ImBuf *ibuf,
+                                const ImageSpec &spec,
+                                const ReadContext &ctx,
+                                char colorspace[IM_MAX_SPACE],
+                                const bool is_float)
+{
+  ibuf->ftype = ctx.file_type;
+  ibuf->flags |= (spec.format == TypeDesc::HALF) ? IB_halffloat : 0;
+
+  if (colorspace) {
+    set_colorspace_name(colorspace, ctx, spec, is_float);
+  }
+
+  float x_res = spec.get_float_attribute("XResolution", 0.0f);
+  float y_res = spec.get_float_attribute("YResolution", 0.0f);
+  if (x_res > 0.0f && y_res > 0.0f) {
+    double scale = 1.0;
+    auto unit = spec.get_string_attribute("ResolutionUnit", "");
+    if (ELEM(unit, "in", "inch")) {
+      scale = 100.0 / 2.54;
+    }
+    else if (unit == "cm") {
+      scale = 100.0;
+    }
+    ibuf->ppm[0] = scale * x_res;
+    ibuf->ppm[1] = scale * y_res;
+  }
+
+  /* Transfer metadata to the ibuf if necessary. */
+  if (ctx.flags & IB_metadata) {
+    IMB_metadata_ensure(&ibuf->metadata);
+    ibuf->flags |= spec.extra_attribs.empty() ? 0 : IB_metadata;
+
+    for (const auto &attrib : spec.extra_attribs) {
+      if (attrib.name().find("ICCProfile") != string::npos) {
+        continue;
+      }
+      IMB_metadata_set_field(ibuf->metadata, attrib.name().c_str(), attrib.get_string().c_str());
+    }
+  }
+}
+
 /**
  * Get an #ImBuf filled in with pixel data and associated metadata using the provided ImageInput.
  */
@@ -201,38 +306,7 @@ static ImBuf *get_oiio_ibuf(ImageInput *in, const ReadContext &ctx, char colorsp
 
   /* Fill in common ibuf properties. */
   if (ibuf) {
-    ibuf->ftype = ctx.file_type;
-    ibuf->flags |= (spec.format == TypeDesc::HALF) ? IB_halffloat : 0;
-
-    set_colorspace_name(colorspace, ctx, spec, is_float);
-
-    float x_res = spec.get_float_attribute("XResolution", 0.0f);
-    float y_res = spec.get_float_attribute("YResolution", 0.0f);
-    if (x_res > 0.0f && y_res > 0.0f) {
-      double scale = 1.0;
-      auto unit = spec.get_string_attribute("ResolutionUnit", "");
-      if (ELEM(unit, "in", "inch")) {
-        scale = 100.0 / 2.54;
-      }
-      else if (unit == "cm") {
-        scale = 100.0;
-      }
-      ibuf->ppm[0] = scale * x_res;
-      ibuf->ppm[1] = scale * y_res;
-    }
-
-    /* Transfer metadata to the ibuf if necessary. */
-    if (ctx.flags & IB_metadata) {
-      IMB_metadata_ensure(&ibuf->metadata);
-      ibuf->flags |= spec.extra_attribs.empty() ? 0 : IB_metadata;
-
-      for (const auto &attrib : spec.extra_attribs) {
-        if (attrib.name().find("ICCProfile") != string::npos) {
-          continue;
-        }
-        IMB_metadata_set_field(ibuf->metadata, attrib.name().c_str(), attrib.get_string().c_str());
-      }
-    }
+    set_ibuf_properties(ibuf, spec, ctx, colorspace, is_float);
   }
 
   return ibuf;
@@ -289,6 +363,148 @@ ImBuf *imb_oiio_read(const ReadContext &ctx,
   return get_oiio_ibuf(in.get(), ctx, colorspace);
 }
 
+/**
+ * Whether a sub-image is a reduced resolution version of the first one, according to bit 0 of
+ * the TIFF `NewSubfileType` tag.
+ */
+static bool is_reduced_resolution_subimage(const ImageSpec &spec)
+{
+  return (spec.get_int_attribute("tiff:subfiletype", 0) & 1) != 0;
+}
+
+ImBuf *imb_oiio_read_thumbnail(const ReadContext &ctx,
+                               const char *filepath,
+                               const ImageSpec &config,
+                               const size_t max_thumb_size,
+                               char colorspace[IM_MAX_SPACE],
+                               size_t *r_width,
+                               size_t *r_height)
+{
+  /* Multi-page files can have many sub-images, only look at the first few of them. */
+  constexpr int max_subimages = 16;
+
+  ImageSpec spec;
+  unique_ptr<ImageInput> in = ImageInput::create(ctx.file_format);
+  if (!(in && in->open(filepath, spec, config))) {
+    return nullptr;
+  }
+  *r_width = size_t(spec.width);
+  *r_height = size_t(spec.height);
+
+  const int thumb_size = int(max_thumb_size);
+  const float aspect = float(spec.width) / float(std::max(spec.height, 1));
+
+  /* Find the smallest version of the image that is still at least as big as the thumbnail. These
+   * are the MIP levels of tiled images, and further sub-images flagged as reduced resolution
+   * versions of the image, which is how TIFF files commonly store them. Other sub-images, e.g.
+   * further pages of a document, are unrelated images. */
+  int best_subimage = 0;
+  int best_miplevel = 0;
+  int best_size = std::max(spec.width, spec.height);
+  for (int subimage = 0; subimage < max_subimages && in->seek_subimage(subimage, 0); subimage++) {
+    for (int miplevel = 0; in->seek_subimage(subimage, miplevel); miplevel++) {
+      const ImageSpec &level_spec = in->spec();
+      const int size = std::max(level_spec.width, level_spec.height);
+      if (size < thumb_size) {
+        break;
+      }
+      if (subimage > 0 &&
+          (!is_reduced_resolution_subimage(level_spec) || level_spec.nchannels != spec.nchannels ||
+           level_spec.height < 1 ||
+           fabsf(float(level_spec.width) / float(level_spec.height) - aspect) > aspect * 0.01f))
+      {
+        break;
+      }
+      if (size < best_size) {
+        best_subimage = subimage;
+        best_miplevel = miplevel;
+        best_size = size;
+      }
+    }
+  }
+
+  if (!in->seek_subimage(best_subimage, best_miplevel)) {
+    return nullptr;
+  }
+  const ImageSpec level_spec = in->spec();
+  const bool has_alpha = level_spec.alpha_channel != -1;
+  const bool is_float = level_spec.format.basesize() > 1;
+  const int channels = level_spec.nchannels <= 4 ? level_spec.nchannels : 4;
+  if (channels < 1 || level_spec.width < 1 || level_spec.height < 1) {
+    return nullptr;
+  }
+  const bool use_all_planes = has_alpha || ctx.use_all_planes;
+
+  /* Without a small enough version, sample the image at twice the thumbnail resolution, the
+   * caller scales it down further with filtering. */
+  const float scale = std::min(1.0f, float(thumb_size * 2) / float(best_size));
+  const int dst_width = std::max(int(level_spec.width * scale), 1);
+  const int dst_height = std::max(int(level_spec.height * scale), 1);
+
+  ImBuf *ibuf = nullptr;
+  if (is_float) {
+    ibuf = load_pixels_sampled<float>(in.get(),
+                                      best_subimage,
+                                      best_miplevel,
+                                      level_spec,
+                                      channels,
+                                      dst_width,
+                                      dst_height,
+                                      use_all_planes);
+  }
+  else {
+    ibuf = load_pixels_sampled<uchar>(in.get(),
+                                      best_subimage,
+                                      best_miplevel,
+                                      level_spec,
+                                      channels,
+                                      dst_width,
+                                      dst_height,
+                                      use_all_planes);
+  }
+
+  if (ibuf) {
+    set_ibuf_properties(ibuf, level_spec, ctx, colorspace, is_float);
+  }
+
+  return ibuf;
+}
+
+/** Number of scanlines converted to the file data format at once while writing. */
+static constexpr int WRITE_BAND_ROWS = 256;
+
+/**
+ * Write \a buf to the opened \a out. Scanline images are converted to the file data format in
+ * bands split over all threads, instead of by the codec one scanline at a time. Only one band
+ * of converted pixels exists at a time, so no second full size image is kept while encoding.
+ */
+static bool write_image_buf(ImageOutput &out,
+                            const ImageBuf &buf,
+                            const ImageSpec &file_spec,
+                            const int threads_num)
+{
+  if (buf.spec().format == file_spec.format || file_spec.tile_width > 0) {
+    return buf.write(&out);
+  }
+
+  const ROI roi = buf.roi();
+  for (int y = roi.ybegin; y < roi.yend; y += WRITE_BAND_ROWS) {
+    ROI band_roi = roi;
+    band_roi.ybegin = y;
+    band_roi.yend = std::min(y + WRITE_BAND_ROWS, roi.yend);
+    ImageBuf band_buf;
+    if (!ImageBufAlgo::copy(band_buf, buf, file_spec.format, band_roi, threads_num)) {
+      return false;
+    }
+    if (!out.write_scanlines(
+            band_roi.ybegin, band_roi.yend, 0, file_spec.format, band_buf.localpixels()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool imb_oiio_write(const WriteContext &ctx, const char *filepath, const ImageSpec &file_spec)
 {
   unique_ptr<ImageOutput> out = ImageOutput::create(ctx.file_format);
@@ -325,6 +541,10 @@ bool imb_oiio_write(const WriteContext &ctx, const char *filepath, const ImageSp
     }
   }
 
+  /* Let codecs that support it compress parts of the image in parallel, like TIFF strips. */
+  const int threads_num = BLI_system_thread_count();
+  out->threads(threads_num);
+
   bool write_ok = false;
   bool close_ok = false;
   if (ctx.flags & IB_mem) {
@@ -334,13 +554,13 @@ bool imb_oiio_write(const WriteContext &ctx, const char *filepath, const ImageSp
     imb_addencodedbufferImBuf(ctx.ibuf);
     out->set_ioproxy(&writer);
     if (out->open("", file_spec)) {
-      write_ok = final_buf.write(out.get());
+      write_ok = write_image_buf(*out, final_buf, file_spec, threads_num);
       close_ok = out->close();
     }
   }
   else {
     if (out->open(filepath, file_spec)) {
-      write_ok = final_buf.write(out.get());
+      write_ok = write_image_buf(*out, final_buf, file_spec, threads_num);
       close_ok = out->close();
     }
   }
@@ -72,6 +72,21 @@ ImBuf *imb_oiio_read(const ReadContext &ctx,
                      char colorspace[IM_MAX_SPACE],
                      OIIO::ImageSpec &r_newspec);
 
+/**
+ * Read a reduced resolution version of the image file for thumbnails, decoding as little of the
+ * file as possible. The smallest MIP level or sub-image that is at least `max_thumb_size` large is
+ * used, and only the scanlines needed to sample it at twice the thumbnail size are read.
+ *
+ * `r_width` and `r_height` are set to the size of the full resolution image.
+ */
+ImBuf *imb_oiio_read_thumbnail(const ReadContext &ctx,
+                               const char *filepath,
+                               const OIIO::ImageSpec &config,
+                               size_t max_thumb_size,
+                               char colorspace[IM_MAX_SPACE],
+                               size_t *r_width,
+                               size_t *r_height);
+
 /**
  * The primary method for writing data from an #ImBuf to either a physical or in-memory
  * destination.
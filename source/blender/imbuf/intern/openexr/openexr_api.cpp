@@ -50,6 +50,7 @@
 #include <OpenEXR/ImfRgbaFile.h>
 #include <OpenEXR/ImfStandardAttributes.h>
 #include <OpenEXR/ImfStringAttribute.h>
+#include <OpenEXR/ImfTiledRgbaFile.h>
 #include <OpenEXR/ImfVersion.h>
 
 /* multiview/multipart */
@@ -658,6 +659,11 @@ struct ExrHandle {
 
   IStream *ifile_stream;
   MultiPartInputFile *ifile;
+  /**
+   * Copy of the file data #ifile_stream reads from, when the memory the file was loaded from is
+   * not kept. In that case passes are only read on demand with #IMB_exr_read_pass.
+   */
+  uchar *ifile_data;
 
   OFileStream *ofile_stream;
   MultiPartOutputFile *mpofile;
@@ -688,6 +694,7 @@ struct ExrChannel {
   MultiViewChannelName *m;        /* struct to store all multipart channel info */
   int xstride, ystride;           /* step to next pixel, to next scan-line. */
   float *rect;                    /* first pointer to write in */
+  int rect_offset;                /* offset of the channel in the buffer of its pass */
   char chan_id;                   /* quick lookup of channel char */
   int view_id;                    /* quick lookup of channel view */
   bool use_half_float;            /* when saving use half float for file storage */
@@ -1250,9 +1257,9 @@ void IMB_exrtile_write_channels(
   }
 }
 
-void IMB_exr_read_channels(void *handle)
+/* Read the pixels of all channels that have a buffer assigned. */
+static bool imb_exr_read_channels(ExrHandle *data)
 {
-  ExrHandle *data = (ExrHandle *)handle;
   int numparts = data->ifile->parts();
 
   /* Check if EXR was saved with previous versions of blender which flipped images. */
@@ -1278,6 +1285,7 @@ void IMB_exr_read_channels(void *handle)
 
     /* Insert all matching channel into frame-buffer. */
     FrameBuffer frameBuffer;
+    bool has_slices = false;
 
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
       if (echan->m->part_number != i) {
@@ -1309,9 +1317,15 @@ void IMB_exr_read_channels(void *handle)
 
         frameBuffer.insert(echan->m->internal_name,
                            Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+        has_slices = true;
       }
     }
 
+    /* Parts without requested channels don't have to be decoded. */
+    if (!has_slices) {
+      continue;
+    }
+
     /* Read pixels. */
     try {
       in.setFrameBuffer(frameBuffer);
@@ -1320,13 +1334,61 @@ void IMB_exr_read_channels(void *handle)
     }
     catch (const std::exception &exc) {
       std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
-      break;
+      return false;
     }
     catch (...) { /* Catch-all for edge cases or compiler bugs. */
       std::cerr << "OpenEXR-readPixels: UNKNOWN ERROR: " << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void IMB_exr_read_channels(void *handle)
+{
+  imb_exr_read_channels((ExrHandle *)handle);
+}
+
+/* Point the channels of the pass into the given buffer, or detach them when it is null. */
+static void imb_exr_pass_assign_rect(ExrPass *pass, float *rect)
+{
+  pass->rect = rect;
+  for (int a = 0; a < pass->totchan; a++) {
+    ExrChannel *echan = pass->chan[a];
+    echan->rect = rect ? rect + echan->rect_offset : nullptr;
+  }
+}
+
+bool IMB_exr_read_pass(
+    void *handle, const char *layname, const char *passname, const char *viewname, float *rect)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  if (data->ifile == nullptr) {
+    return false;
+  }
+
+  ExrLayer *lay = (ExrLayer *)BLI_findstring(&data->layers, layname, offsetof(ExrLayer, name));
+  if (lay == nullptr) {
+    return false;
+  }
+  ExrPass *pass = nullptr;
+  LISTBASE_FOREACH (ExrPass *, pass_iter, &lay->passes) {
+    if (STREQ(pass_iter->internal_name, passname) && STREQ(pass_iter->view, viewname)) {
+      pass = pass_iter;
       break;
     }
   }
+  if (pass == nullptr || pass->rect != nullptr) {
+    return false;
+  }
+
+  /* Only the channels of this pass have a buffer while reading, the others are skipped. */
+  imb_exr_pass_assign_rect(pass, rect);
+  const bool success = imb_exr_read_channels(data);
+  imb_exr_pass_assign_rect(pass, nullptr);
+
+  return success;
 }
 
 void IMB_exr_multilayer_convert(void *handle,
@@ -1386,6 +1448,7 @@ void IMB_exr_close(void *handle)
   delete data->mpofile;
   delete data->ofile_stream;
   delete data->multiView;
+  MEM_SAFE_FREE(data->ifile_data);
 
   data->ifile = nullptr;
   data->ifile_stream = nullptr;
@@ -1735,11 +1798,9 @@ static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
   LISTBASE_FOREACH (ExrLayer *, lay, &data->layers) {
     LISTBASE_FOREACH (ExrPass *, pass, &lay->passes) {
       if (pass->totchan) {
-        pass->rect = (float *)MEM_callocN(
-            data->width * data->height * pass->totchan * sizeof(float), "pass rect");
         if (pass->totchan == 1) {
           ExrChannel *echan = pass->chan[0];
-          echan->rect = pass->rect;
+          echan->rect_offset = 0;
           echan->xstride = 1;
           echan->ystride = data->width;
           pass->chan_id[0] = echan->chan_id;
@@ -1774,7 +1835,7 @@ static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
             }
             for (int a = 0; a < pass->totchan; a++) {
               echan = pass->chan[a];
-              echan->rect = pass->rect + lookup[uint(echan->chan_id)];
+              echan->rect_offset = lookup[uint(echan->chan_id)];
               echan->xstride = pass->totchan;
               echan->ystride = data->width * pass->totchan;
               pass->chan_id[uint(lookup[uint(echan->chan_id)])] = echan->chan_id;
@@ -1783,13 +1844,22 @@ static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
           else { /* unknown */
             for (int a = 0; a < pass->totchan; a++) {
               ExrChannel *echan = pass->chan[a];
-              echan->rect = pass->rect + a;
+              echan->rect_offset = a;
               echan->xstride = pass->totchan;
               echan->ystride = data->width * pass->totchan;
               pass->chan_id[a] = echan->chan_id;
             }
           }
         }
+
+        /* Passes read on demand get their memory when they are read. */
+        if (data->ifile_data == nullptr) {
+          imb_exr_pass_assign_rect(
+              pass,
+              (float *)MEM_callocN(size_t(data->width) * data->height * pass->totchan *
+                                       sizeof(float),
+                                   "pass rect"));
+        }
       }
     }
   }
@@ -1797,16 +1867,20 @@ static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
   return true;
 }
 
-/* creates channels, makes a hierarchy and assigns memory to channels */
-static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
-                                         MultiPartInputFile &file,
-                                         int width,
-                                         int height)
+/**
+ * Creates channels, makes a hierarchy and assigns memory to channels.
+ *
+ * \param file_data: When given, the memory the file stream reads from. It is owned by the
+ * handle, and memory is only assigned to passes when they are read with #IMB_exr_read_pass.
+ */
+static ExrHandle *imb_exr_begin_read_mem(
+    IStream &file_stream, MultiPartInputFile &file, int width, int height, uchar *file_data)
 {
   ExrHandle *data = (ExrHandle *)IMB_exr_get_handle();
 
   data->ifile_stream = &file_stream;
   data->ifile = &file;
+  data->ifile_data = file_data;
 
   data->width = width;
   data->height = height;
@@ -2137,10 +2211,25 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, char colorspac
 
         /* Only enters with IB_multilayer flag set. */
         if (is_multi && ((flags & IB_thumbnail) == 0)) {
+          uchar *file_data = nullptr;
+          if (flags & IB_multilayer_lazy) {
+            /* Passes are read after the memory of the file is gone. Keep a copy of the file,
+             * usually much smaller than all passes decoded to floats. */
+            file_data = (uchar *)MEM_mallocN(size, "exr file data");
+            memcpy(file_data, mem, size);
+            delete file;
+            delete membuf;
+            file = nullptr;
+            membuf = new IMemStream(file_data, size);
+            file = new MultiPartInputFile(*membuf);
+          }
+
           /* constructs channels for reading, allocates memory in channels */
-          ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height);
+          ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height, file_data);
           if (handle) {
-            IMB_exr_read_channels(handle);
+            if (file_data == nullptr) {
+              IMB_exr_read_channels(handle);
+            }
             ibuf->userdata = handle; /* potential danger, the caller has to check for this! */
           }
         }
@@ -2268,6 +2357,62 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, char colorspac
   }
 }
 
+/**
+ * Read the smallest MIP level of a tiled file that is still at least `max_thumb_size` wide or
+ * high. Returns null when there is no such reduced resolution level or it can't be read.
+ */
+static ImBuf *imb_exr_thumbnail_from_mip_level(const char *filepath, const size_t max_thumb_size)
+{
+  /* Errors are handled here, so that the caller still tries the scanline sampler. */
+  try {
+    /* A separate stream, the file reading the header keeps track of the position in its own. */
+    IFileStream stream(filepath);
+    TiledRgbaInputFile file(stream, 1);
+
+    int level = 0;
+    for (int i = 1; i < file.numLevels(); i++) {
+      if (std::max(file.levelWidth(i), file.levelHeight(i)) < int(max_thumb_size)) {
+        break;
+      }
+      level = i;
+    }
+    if (level == 0) {
+      return nullptr;
+    }
+
+    const Box2i dw = file.dataWindowForLevel(level);
+    const int width = file.levelWidth(level);
+    const int height = file.levelHeight(level);
+
+    Imf::Array2D<Rgba> pixels(height, width);
+    file.setFrameBuffer(&pixels[0][0] - dw.min.x - dw.min.y * width, 1, width);
+    file.readTiles(0, file.numXTiles(level) - 1, 0, file.numYTiles(level) - 1, level);
+
+    ImBuf *ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
+    for (int y = 0; y < height; y++) {
+      /* The rows of an #ImBuf are stored bottom to top. */
+      float *dest_px = &ibuf->float_buffer.data[size_t(height - 1 - y) * width * 4];
+      for (int x = 0; x < width; x++, dest_px += 4) {
+        const Rgba &pixel = pixels[y][x];
+        dest_px[0] = pixel.r;
+        dest_px[1] = pixel.g;
+        dest_px[2] = pixel.b;
+        dest_px[3] = pixel.a;
+      }
+    }
+
+    return ibuf;
+  }
+  catch (const std::exception &exc) {
+    std::cerr << exc.what() << std::endl;
+    return nullptr;
+  }
+  catch (...) { /* Catch-all for edge cases or compiler bugs. */
+    std::cerr << "OpenEXR-Thumbnail: UNKNOWN ERROR" << std::endl;
+    return nullptr;
+  }
+}
+
 ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
                                            const int /*flags*/,
                                            const size_t max_thumb_size,
@@ -2323,6 +2468,18 @@ ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
       colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_FLOAT);
     }
 
+    /* Tiled files can contain reduced resolution versions of the image. */
+    if (file->header().hasTileDescription() &&
+        file->header().tileDescription().mode == MIPMAP_LEVELS)
+    {
+      ImBuf *ibuf = imb_exr_thumbnail_from_mip_level(filepath, max_thumb_size);
+      if (ibuf) {
+        delete file;
+        delete stream;
+        return ibuf;
+      }
+    }
+
     float scale_factor = std::min(float(max_thumb_size) / float(source_w),
                                   float(max_thumb_size) / float(source_h));
     int dest_w = std::max(int(source_w * scale_factor), 1);
@@ -74,6 +74,14 @@ float *IMB_exr_channel_rect(void * /*handle*/,
 }
 
 void IMB_exr_read_channels(void * /*handle*/) {}
+bool IMB_exr_read_pass(void * /*handle*/,
+                       const char * /*layname*/,
+                       const char * /*passname*/,
+                       const char * /*viewname*/,
+                       float * /*rect*/)
+{
+  return false;
+}
 void IMB_exr_write_channels(void * /*handle*/) {}
 void IMB_exrtile_write_channels(void * /*handle*/,
                                 int /*partx*/,
@@ -15,12 +15,15 @@
 #include "BKE_blendfile.hh"
 
 #include "BLI_fileops.h"
+#include "BLI_array.hh"
 #include "BLI_ghash.h"
 #include "BLI_hash_md5.hh"
+#include "BLI_map.hh"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
 #include "BLI_system.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 #include BLI_SYSTEM_PID_H
@@ -656,6 +659,46 @@ ImBuf *IMB_thumb_manage(const char *file_or_lib_path, ThumbSize size, ThumbSourc
   return img;
 }
 
+void IMB_thumb_manage_batch(blender::MutableSpan<ThumbBatchItem> items, const ThumbSize size)
+{
+  using namespace blender;
+
+  /* Only process the first item of every path, so that no task waits for the path lock held by
+   * another task of the batch. */
+  Map<std::pair<StringRef, int>, int64_t> first_item_by_path;
+  Array<int64_t> first_items(items.size());
+  Vector<int64_t> unique_items;
+  for (const int64_t i : items.index_range()) {
+    first_items[i] = first_item_by_path.lookup_or_add_cb(
+        {items[i].file_or_lib_path, int(items[i].source)}, [&]() {
+          unique_items.append(i);
+          return i;
+        });
+  }
+
+  IMB_thumb_locks_acquire();
+
+  /* Decoding a single image takes long, so use one item per task. */
+  threading::parallel_for(unique_items.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : unique_items.as_span().slice(range)) {
+      ThumbBatchItem &item = items[i];
+      /* Other threads may create the thumbnail of the same path outside of the batch. */
+      IMB_thumb_path_lock(item.file_or_lib_path);
+      item.thumb = IMB_thumb_manage(item.file_or_lib_path, size, item.source);
+      IMB_thumb_path_unlock(item.file_or_lib_path);
+    }
+  });
+
+  IMB_thumb_locks_release();
+
+  for (const int64_t i : items.index_range()) {
+    if (first_items[i] != i) {
+      const ImBuf *thumb = items[first_items[i]].thumb;
+      items[i].thumb = thumb ? IMB_dupImBuf(thumb) : nullptr;
+    }
+  }
+}
+
 /* ***** Threading ***** */
 /* Thumbnail handling is not really threadsafe in itself.
  * However, as long as we do not operate on the same file, we shall have no collision.
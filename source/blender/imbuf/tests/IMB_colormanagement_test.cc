@@ -0,0 +1,154 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "CLG_log.h"
+
+#include "GHOST_Path-api.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_idtype.hh"
+
+#include "BLI_math_base.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+#include "DNA_color_types.h"
+
+#include "IMB_colormanagement.hh"
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "intern/IMB_colormanagement_intern.hh"
+
+#include "MEM_guardedalloc.h"
+
+namespace blender::imbuf::tests {
+
+class ColormanagementTest : public testing::Test {
+ protected:
+  void SetUp() override
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_appdir_init();
+    IMB_init();
+  }
+
+  void TearDown() override
+  {
+    IMB_exit();
+    GHOST_DisposeSystemPaths();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+};
+
+/* Big enough for the display transform to be baked into a lookup table. */
+static ImBuf *create_hdr_test_image()
+{
+  ImBuf *ibuf = IMB_allocImBuf(1024, 1100, 32, IB_rectfloat);
+  RandomNumberGenerator rng(42);
+  float *pixel = ibuf->float_buffer.data;
+  for (int y = 0; y < ibuf->y; y++) {
+    /* Some rows with partially transparent pixels, and some with negative values. */
+    const float alpha = (y % 8 == 0) ? rng.get_float() : 1.0f;
+    const bool use_negative = (y % 16 == 1);
+    for (int x = 0; x < ibuf->x; x++, pixel += 4) {
+      for (int c = 0; c < 3; c++) {
+        pixel[c] = exp2f(-16.0f + 26.0f * rng.get_float()) * alpha;
+        if (use_negative && rng.get_float() < 0.1f) {
+          pixel[c] = -pixel[c];
+        }
+      }
+      pixel[3] = alpha;
+    }
+  }
+  return ibuf;
+}
+
+/* Same as the display buffer, but transformed by the OCIO processor directly. */
+static uchar *display_buffer_reference(ImBuf *ibuf,
+                                       const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings)
+{
+  const size_t pixels_num = size_t(ibuf->x) * ibuf->y;
+  const bool predivide = IMB_alpha_affects_rgb(ibuf);
+
+  float *buffer = static_cast<float *>(MEM_dupallocN(ibuf->float_buffer.data));
+  ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(
+      view_settings, display_settings);
+  IMB_colormanagement_processor_apply(cm_processor, buffer, ibuf->x, ibuf->y, 4, predivide);
+  IMB_colormanagement_processor_free(cm_processor);
+
+  uchar *result = static_cast<uchar *>(MEM_mallocN(pixels_num * 4, __func__));
+  IMB_buffer_byte_from_float(result,
+                             buffer,
+                             4,
+                             0.0f,
+                             IB_PROFILE_SRGB,
+                             IB_PROFILE_SRGB,
+                             predivide,
+                             ibuf->x,
+                             ibuf->y,
+                             ibuf->x,
+                             ibuf->x);
+  MEM_freeN(buffer);
+  return result;
+}
+
+static void test_display_buffer_matches_ocio(const char *view_transform)
+{
+  ColorManagedDisplaySettings display_settings = {};
+  STRNCPY(display_settings.display_device, "sRGB");
+
+  ColorManagedViewSettings view_settings = {};
+  STRNCPY(view_settings.view_transform, view_transform);
+  STRNCPY(view_settings.look, "None");
+  view_settings.gamma = 1.0f;
+
+  if (IMB_colormanagement_view_get_named_index(view_transform) == 0) {
+    GTEST_SKIP() << "View transform " << view_transform << " not found in the configuration";
+  }
+
+  ImBuf *ibuf = create_hdr_test_image();
+  uchar *expected = display_buffer_reference(ibuf, &view_settings, &display_settings);
+
+  /* The table must be accurate enough to be used, and the image is big enough to use it. */
+  EXPECT_TRUE(colormanage_display_lut_bake(&view_settings, &display_settings));
+
+  void *cache_handle;
+  const uchar *result = IMB_display_buffer_acquire(
+      ibuf, &view_settings, &display_settings, &cache_handle);
+  ASSERT_NE(result, nullptr);
+
+  const size_t values_num = size_t(ibuf->x) * ibuf->y * 4;
+  int max_difference = 0;
+  for (size_t i = 0; i < values_num; i++) {
+    max_difference = max_ii(max_difference, abs(int(result[i]) - int(expected[i])));
+  }
+  EXPECT_LE(max_difference, 1);
+
+  IMB_display_buffer_release(cache_handle);
+  MEM_freeN(expected);
+  IMB_freeImBuf(ibuf);
+}
+
+TEST_F(ColormanagementTest, display_buffer_standard)
+{
+  test_display_buffer_matches_ocio("Standard");
+}
+
+TEST_F(ColormanagementTest, display_buffer_filmic)
+{
+  test_display_buffer_matches_ocio("Filmic");
+}
+
+TEST_F(ColormanagementTest, display_buffer_agx)
+{
+  test_display_buffer_matches_ocio("AgX");
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,106 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "MEM_CacheLimiterC-Api.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_moviecache.hh"
+
+#include "BLI_hash.h"
+#include "BLI_string.h"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+using namespace blender;
+
+static constexpr int FRAMES_NUM = 512;
+static constexpr int LOOKUPS_PER_THREAD = 200000;
+static constexpr int IMAGE_SIZE = 64;
+
+static uint frame_key_hash(const void *key)
+{
+  return BLI_hash_int(*(const int *)key);
+}
+
+static bool frame_key_cmp(const void *a, const void *b)
+{
+  return *(const int *)a != *(const int *)b;
+}
+
+static void fill_cache(MovieCache *cache)
+{
+  for (int frame = 0; frame < FRAMES_NUM; frame++) {
+    ImBuf *ibuf = IMB_allocImBuf(IMAGE_SIZE, IMAGE_SIZE, 32, IB_rect);
+    IMB_moviecache_put(cache, &frame, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+/**
+ * Look up frames from many threads at once. With \a put_missing, frames freed for the memory limit
+ * are added again, so threads also insert and evict concurrently.
+ */
+static void moviecache_contention_impl(const char *name,
+                                       const int threads_num,
+                                       const bool put_missing)
+{
+  MovieCache *cache = IMB_moviecache_create(
+      "performance test", sizeof(int), frame_key_hash, frame_key_cmp);
+  fill_cache(cache);
+
+  {
+    char timer_name[64];
+    SNPRINTF(timer_name, "%s_%d", name, threads_num);
+    SCOPED_TIMER(timer_name);
+
+    Vector<std::thread> threads;
+    for (int thread_index = 0; thread_index < threads_num; thread_index++) {
+      threads.append(std::thread([&, thread_index]() {
+        for (int i = 0; i < LOOKUPS_PER_THREAD; i++) {
+          int frame = int(BLI_hash_int_2d(uint(thread_index), uint(i)) % FRAMES_NUM);
+          ImBuf *ibuf = IMB_moviecache_get(cache, &frame, nullptr);
+          if (ibuf == nullptr && put_missing) {
+            ibuf = IMB_allocImBuf(IMAGE_SIZE, IMAGE_SIZE, 32, IB_rect);
+            IMB_moviecache_put(cache, &frame, ibuf);
+          }
+          IMB_freeImBuf(ibuf);
+        }
+      }));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+
+  IMB_moviecache_free(cache);
+}
+
+static void moviecache_contention(const char *name, const bool put_missing)
+{
+  const int threads_max = std::max(int(std::thread::hardware_concurrency()), 1);
+  for (int threads_num = 1; threads_num < threads_max; threads_num *= 2) {
+    moviecache_contention_impl(name, threads_num, put_missing);
+  }
+  moviecache_contention_impl(name, threads_max, put_missing);
+}
+
+TEST(imbuf_moviecache, contention_lookup)
+{
+  /* Everything fits in the cache. */
+  MEM_CacheLimiter_set_maximum(size_t(1) << 30);
+  moviecache_contention("lookup", false);
+}
+
+TEST(imbuf_moviecache, contention_lookup_evict)
+{
+  /* Half of the frames fit in the cache. */
+  MEM_CacheLimiter_set_maximum(size_t(FRAMES_NUM / 2) * IMAGE_SIZE * IMAGE_SIZE * 4);
+  moviecache_contention("lookup_evict", true);
+  MEM_CacheLimiter_set_maximum(size_t(1) << 30);
+}
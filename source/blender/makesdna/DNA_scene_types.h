@@ -835,7 +835,10 @@ typedef struct RenderData {
   /* If false and the experimental enable_new_cpu_compositor is true, use the new experimental
    * CPU compositor implementation, otherwise, use the old CPU compositor. */
   char use_old_cpu_compositor;
-  char _pad10[7];
+
+  /** Storage of CPU compositor intermediate results waiting to be read. */
+  char compositor_storage; /* eCompositorStorage */
+  char _pad10[6];
 } RenderData;
 
 /** #RenderData::quality_flag */
@@ -868,6 +871,13 @@ typedef enum eCompositorPrecision {
   SCE_COMPOSITOR_PRECISION_FULL = 1,
 } eCompositorPrecision;
 
+/** #RenderData::compositor_storage */
+typedef enum eCompositorStorage {
+  SCE_COMPOSITOR_STORAGE_FULL = 0,
+  SCE_COMPOSITOR_STORAGE_HALF = 1,
+  SCE_COMPOSITOR_STORAGE_DISK = 2,
+} eCompositorStorage;
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -349,7 +349,8 @@ typedef struct Editing {
   rctf overlay_frame_rect;
 
   int show_missing_media_flag;
-  int _pad1;
+  /** Number of frames rendered at the same time by prefetching, 0 uses all system threads. */
+  int prefetch_threads;
 
   struct SeqCache *cache;
 
@@ -846,6 +847,8 @@ enum {
 
   SEQ_CACHE_PREFETCH_ENABLE = (1 << 10),
   SEQ_CACHE_DISK_CACHE_ENABLE = (1 << 11),
+  /** Compress images in memory when the cache is full, before recycling frames. */
+  SEQ_CACHE_COMPRESS = (1 << 12),
 };
 
 /** #Sequence.color_tag. */
@@ -6796,6 +6796,26 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
       {0, nullptr, 0, nullptr, nullptr},
   };
 
+  static const EnumPropertyItem compositor_storage_items[] = {
+      {SCE_COMPOSITOR_STORAGE_FULL,
+       "FULL",
+       0,
+       "Full",
+       "Keep intermediate results in memory at full precision"},
+      {SCE_COMPOSITOR_STORAGE_HALF,
+       "HALF",
+       0,
+       "Half",
+       "Keep intermediate results waiting to be read in memory at half precision"},
+      {SCE_COMPOSITOR_STORAGE_DISK,
+       "DISK",
+       0,
+       "Disk",
+       "Store intermediate results waiting to be read at half precision in temporary files, "
+       "allowing to composite frames that don't fit in memory"},
+      {0, nullptr, 0, nullptr, nullptr},
+  };
+
   rna_def_scene_ffmpeg_settings(brna);
 
   srna = RNA_def_struct(brna, "RenderSettings", nullptr);
@@ -7537,6 +7557,15 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
       prop, "Compositor Precision", "The precision of compositor intermediate result");
   RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_Scene_compositor_update");
 
+  prop = RNA_def_property(srna, "compositor_storage", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, nullptr, "compositor_storage");
+  RNA_def_property_enum_items(prop, compositor_storage_items);
+  RNA_def_property_ui_text(prop,
+                           "Compositor Storage",
+                           "How the CPU compositor stores intermediate results while they are "
+                           "waiting to be read");
+  RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_Scene_compositor_update");
+
   prop = RNA_def_property(srna, "use_new_cpu_compositor", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, nullptr, "use_old_cpu_compositor", 1);
   RNA_def_property_ui_text(
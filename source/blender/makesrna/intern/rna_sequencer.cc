@@ -2506,6 +2506,14 @@ static void rna_def_editor(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_STORE_FINAL_OUT);
   RNA_def_property_ui_text(prop, "Cache Final", "Cache final image for each frame");
 
+  prop = RNA_def_property(srna, "use_cache_compression", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_COMPRESS);
+  RNA_def_property_ui_text(prop,
+                           "Compress Cache",
+                           "Compress cached images in memory when the cache is full instead of "
+                           "discarding them, holds more frames at the cost of restoring images "
+                           "when they are displayed");
+
   prop = RNA_def_property(srna, "use_prefetch", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_PREFETCH_ENABLE);
   RNA_def_property_ui_text(
@@ -2514,6 +2522,16 @@ static void rna_def_editor(BlenderRNA *brna)
       "Render frames ahead of current frame in the background for faster playback");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
 
+  prop = RNA_def_property(srna, "prefetch_threads", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "prefetch_threads");
+  RNA_def_property_range(prop, 0, SEQ_PREFETCH_THREADS_MAX);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Threads",
+                           "Number of frames rendered at the same time in the background, "
+                           "0 to use all system threads. Every thread evaluates its own copy "
+                           "of the scene");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
+
   /* functions */
 
   func = RNA_def_function(srna, "display_stack", "rna_SequenceEditor_display_stack");
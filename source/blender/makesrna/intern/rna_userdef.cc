@@ -7492,6 +7492,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "use_sculpt_texture_paint", 1);
   RNA_def_property_ui_text(prop, "Sculpt Texture Paint", "Use texture painting in Sculpt Mode");
 
+  prop = RNA_def_property(srna, "use_sculpt_undo_compression", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_sculpt_undo_compression", 1);
+  RNA_def_property_ui_text(prop,
+                           "Sculpt Undo Compression",
+                           "Compress the undo data of Sculpt Mode strokes in the background to "
+                           "reduce memory usage, at the cost of slower undo and redo");
+
   prop = RNA_def_property(srna, "use_extended_asset_browser", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(prop,
                            "Extended Asset Browser",
@@ -147,12 +147,21 @@ typedef struct RenderResult {
   struct StampData *stamp_data;
 
   bool passes_allocated;
+
+  /* For results read from multilayer EXR files with #IB_multilayer_lazy, the handle of the file
+   * to read passes from when they are first used, see #RE_pass_ensure_loaded. Owned by the render
+   * result, null when all passes are loaded. */
+  void *exrhandle;
+  char exr_colorspace[64];
+  bool exr_predivide;
 } RenderResult;
 
 typedef struct RenderStats {
   int cfra;
   bool localview;
   double starttime, lastframetime;
+  /** Time it took to encode and write the file of the last saved frame, zero when none was. */
+  double lastencodetime;
   const char *infostr, *statstr;
   char scene_name[MAX_ID_NAME - 2];
   float mem_used, mem_peak;
@@ -377,6 +386,13 @@ void RE_RenderAnim(struct Render *re,
                    int sfra,
                    int efra,
                    int tfra);
+/**
+ * Pipeline the frames of animations, writing the previous frames while the current frame is
+ * rendered. For animations that are only composited, the images of the next frame are loaded
+ * ahead of time too. The \a limit in bytes bounds the memory used by the frames in flight, zero
+ * disables pipelining.
+ */
+void RE_SetPipelineFramesMemoryLimit(size_t limit);
 #ifdef WITH_FREESTYLE
 void RE_RenderFreestyleStrokes(struct Render *re,
                                struct Main *bmain,
@@ -403,9 +419,26 @@ void RE_PreviewRender(struct Render *re, struct Main *bmain, struct Scene *scene
  */
 bool RE_ReadRenderResult(struct Scene *scene, struct Scene *scenode);
 
+/**
+ * Create a render result from a multilayer EXR handle. When passes of the handle have not been
+ * read yet (#IB_multilayer_lazy), the render result takes ownership of the handle and stores it
+ * in #RenderResult.exrhandle, otherwise the caller has to close it.
+ */
 struct RenderResult *RE_MultilayerConvert(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty);
 
+/**
+ * Read the pixels of a pass of a render result created from a lazily loaded multilayer EXR.
+ * Does nothing for passes which already have their data.
+ *
+ * \return false when the pass could not be read, it's then filled with zeros.
+ */
+bool RE_pass_ensure_loaded(struct RenderResult *rr, struct RenderPass *rpass);
+/**
+ * Read all passes which are not loaded yet, and close the EXR file handle.
+ */
+void RE_render_result_ensure_passes_loaded(struct RenderResult *rr);
+
 /* Display and event callbacks. */
 
 /**
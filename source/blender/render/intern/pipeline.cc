@@ -8,13 +8,18 @@
 
 #include <fmt/format.h>
 
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cmath>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <forward_list>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 #include "DNA_anim_types.h"
 #include "DNA_collection_types.h"
@@ -36,6 +41,8 @@
 #include "BLI_rect.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_timecode.h"
@@ -1576,7 +1583,9 @@ static void do_render_full_pipeline(Render *re)
   re->i.starttime = BLI_time_now_seconds();
 
   /* ensure no images are in memory from previous animated sequences */
-  BKE_image_all_free_anim_ibufs(re->main, re->r.cfra);
+  if ((re->flag & R_PIPELINE_FRAMES) == 0) {
+    BKE_image_all_free_anim_ibufs(re->main, re->r.cfra);
+  }
   SEQ_cache_cleanup(re->scene);
 
   if (RE_engine_render(re, true)) {
@@ -2016,6 +2025,9 @@ void RE_RenderFrame(Render *re,
   scene->r.cfra = frame;
   scene->r.subframe = subframe;
 
+  /* Don't show the encoding time of a previous render. */
+  re->i.lastencodetime = 0.0;
+
   if (render_init_from_main(
           re, &scene->r, bmain, scene, single_layer, camera_override, false, false))
   {
@@ -2228,6 +2240,45 @@ bool RE_WriteRenderViewsMovie(ReportList *reports,
   return ok;
 }
 
+/**
+ * Print and report the time it took to process the current frame, which includes the time it took
+ * to save it if \a show_saving_time is true. Of the saving time, the part spent encoding and
+ * writing the file is reported separately.
+ */
+static void render_frame_stats_report(Render *re, const bool show_saving_time)
+{
+  char time_str[32];
+  char encode_time_str[32];
+  const double render_time = re->i.lastframetime;
+  re->i.lastframetime = BLI_time_now_seconds() - re->i.starttime;
+
+  BLI_timecode_string_from_time_simple(time_str, sizeof(time_str), re->i.lastframetime);
+  std::string message = fmt::format("Time: {}", time_str);
+
+  if (show_saving_time) {
+    BLI_timecode_string_from_time_simple(
+        time_str, sizeof(time_str), re->i.lastframetime - render_time);
+    BLI_timecode_string_from_time_simple(
+        encode_time_str, sizeof(encode_time_str), re->i.lastencodetime);
+    message = fmt::format("{} (Saving: {}, Encoding: {})", message, time_str, encode_time_str);
+  }
+
+  if (!G.quiet) {
+    printf("%s\n", message.c_str());
+    /* Flush stdout to be sure python callbacks are printing stuff after blender. */
+    fflush(stdout);
+  }
+
+  /* NOTE: using G_MAIN seems valid here???
+   * Not sure it's actually even used anyway, we could as well pass nullptr? */
+  render_callback_exec_string(re, G_MAIN, BKE_CB_EVT_RENDER_STATS, message.c_str());
+
+  if (!G.quiet) {
+    fputc('\n', stdout);
+    fflush(stdout);
+  }
+}
+
 static bool do_write_image_or_movie(Render *re,
                                     Main *bmain,
                                     Scene *scene,
@@ -2237,7 +2288,6 @@ static bool do_write_image_or_movie(Render *re,
 {
   char filepath[FILE_MAX];
   RenderResult rres;
-  double render_time;
   bool ok = true;
   RenderEngineType *re_type = RE_engines_find(re->r.engine);
 
@@ -2248,6 +2298,8 @@ static bool do_write_image_or_movie(Render *re,
   if (do_write_file) {
     RE_AcquireResultImageViews(re, &rres);
 
+    const double encode_start_time = BLI_time_now_seconds();
+
     /* write movie or image */
     if (BKE_imtype_is_movie(scene->r.im_format.imtype)) {
       RE_WriteRenderViewsMovie(
@@ -2272,35 +2324,12 @@ static bool do_write_image_or_movie(Render *re,
       ok = BKE_image_render_write(re->reports, &rres, scene, true, filepath);
     }
 
-    RE_ReleaseResultImageViews(re, &rres);
-  }
-
-  render_time = re->i.lastframetime;
-  re->i.lastframetime = BLI_time_now_seconds() - re->i.starttime;
-
-  BLI_timecode_string_from_time_simple(filepath, sizeof(filepath), re->i.lastframetime);
-  std::string message = fmt::format("Time: {}", filepath);
+    re->i.lastencodetime = BLI_time_now_seconds() - encode_start_time;
 
-  if (do_write_file) {
-    BLI_timecode_string_from_time_simple(
-        filepath, sizeof(filepath), re->i.lastframetime - render_time);
-    message = fmt::format("{} (Saving: {})", message, filepath);
-  }
-
-  if (!G.quiet) {
-    printf("%s\n", message.c_str());
-    /* Flush stdout to be sure python callbacks are printing stuff after blender. */
-    fflush(stdout);
+    RE_ReleaseResultImageViews(re, &rres);
   }
 
-  /* NOTE: using G_MAIN seems valid here???
-   * Not sure it's actually even used anyway, we could as well pass nullptr? */
-  render_callback_exec_string(re, G_MAIN, BKE_CB_EVT_RENDER_STATS, message.c_str());
-
-  if (!G.quiet) {
-    fputc('\n', stdout);
-    fflush(stdout);
-  }
+  render_frame_stats_report(re, do_write_file);
 
   return ok;
 }
@@ -2341,6 +2370,368 @@ static void re_movie_free_all(Render *re, bMovieHandle *mh, int totvideos)
   MEM_SAFE_FREE(re->movie_ctx_arr);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Pipelined Frames
+ *
+ * Animations that are only composited spend much of every frame loading the input images and
+ * writing the output, both mostly serial, while the compositor itself can only execute one node
+ * tree at a time. So when a memory limit is set for it, frames are pipelined: the images of the
+ * next frame are loaded while the current frame is composited, and the result of a frame is
+ * written in the background while the next frames are composited.
+ *
+ * Encoding large outputs also leaves most cores idle for rendered animations, so their results
+ * are written in the background the same way, while the next frame renders. Images are not
+ * prefetched for them, render engines load the images they need themselves.
+ * \{ */
+
+/** Memory limit for the frames in flight in bytes, pipelining is disabled when zero. */
+static size_t pipeline_frames_memory_limit = 0;
+
+void RE_SetPipelineFramesMemoryLimit(const size_t limit)
+{
+  pipeline_frames_memory_limit = limit;
+}
+
+static size_t render_result_size_in_memory(RenderResult *rr)
+{
+  size_t size = 0;
+  LISTBASE_FOREACH (RenderView *, rv, &rr->views) {
+    if (rv->ibuf) {
+      size += IMB_get_size_in_memory(rv->ibuf);
+    }
+  }
+  LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
+    LISTBASE_FOREACH (RenderPass *, rp, &rl->passes) {
+      if (rp->ibuf) {
+        size += IMB_get_size_in_memory(rp->ibuf);
+      }
+    }
+  }
+  return size;
+}
+
+struct PipelineFrameImage {
+  Image *image;
+  /** Copy of the image user of the node, with the frame of the prefetched scene frame. */
+  ImageUser image_user;
+};
+
+struct PipelineWrittenFrame {
+  int cfra;
+  /** Time it took to encode and write the frame, in seconds. */
+  double encode_time;
+};
+
+struct PipelineFrameWriteTaskData {
+  RenderResult *rr;
+  size_t rr_size;
+  /** Copies of the scene and render data, which change for the next frames while writing. */
+  Scene tmp_scene;
+  RenderData tmp_rd;
+  char filepath[FILE_MAX];
+};
+
+/**
+ * Loads the images of the next frame and writes the results of the previous frames, while the
+ * current frame is rendered. Only image sequences are loaded ahead of time, movies are decoded in
+ * order and multi-layer images share a single render result for all frames.
+ */
+class PipelineFrames {
+  Render *re_;
+  bMovieHandle *mh_;
+  int totvideos_;
+  bool is_movie_;
+  size_t memory_limit_;
+  /** Load the images of the compositor of the next frame ahead of time. */
+  bool use_prefetch_;
+
+  /** Writes results, in order for movies. */
+  TaskPool *write_pool_;
+  std::mutex write_mutex_;
+  std::condition_variable write_condition_;
+  int scheduled_frames_num_ = 0;
+  size_t scheduled_bytes_ = 0;
+  bool write_failed_ = false;
+  /** Written frames for which the write callbacks still need to run. */
+  blender::Vector<PipelineWrittenFrame> written_frames_;
+
+  /** Loads the images of the next frame in a thread outside of the task scheduler, so it never
+   * runs as part of a parallel loop of the compositor, which can hold image locks. */
+  ListBase prefetch_threads_ = {nullptr, nullptr};
+  bool is_prefetching_ = false;
+  blender::Vector<PipelineFrameImage> prefetch_images_;
+  std::atomic<size_t> prefetched_bytes_ = 0;
+  /** Image frames to keep in memory for the frame that is about to be rendered. */
+  blender::Map<Image *, int> keep_image_frames_;
+
+ public:
+  PipelineFrames(Render *re,
+                 bMovieHandle *mh,
+                 const int totvideos,
+                 const bool is_movie,
+                 const size_t memory_limit,
+                 const bool use_prefetch)
+      : re_(re),
+        mh_(mh),
+        totvideos_(totvideos),
+        is_movie_(is_movie),
+        memory_limit_(memory_limit),
+        use_prefetch_(use_prefetch)
+  {
+    write_pool_ = is_movie ? BLI_task_pool_create_background_serial(this, TASK_PRIORITY_HIGH) :
+                             BLI_task_pool_create_background(this, TASK_PRIORITY_HIGH);
+  }
+
+  ~PipelineFrames()
+  {
+    this->finish();
+    BLI_task_pool_free(write_pool_);
+  }
+
+  /**
+   * Free the images of previous frames and start loading the images of \a next_frame, if any.
+   * Called right before rendering \a cfra, after the scene was evaluated for it. Does nothing
+   * when images are not prefetched, they are freed before rendering every frame then.
+   */
+  void begin_frame(Main *bmain,
+                   const Scene *scene_eval,
+                   const int cfra,
+                   const std::optional<int> next_frame)
+  {
+    if (!use_prefetch_) {
+      return;
+    }
+    this->wait_for_prefetch();
+
+    LISTBASE_FOREACH (Image *, image, &bmain->images) {
+      if (BKE_image_is_animated(image)) {
+        BKE_image_free_anim_ibufs(image, keep_image_frames_.lookup_default(image, cfra));
+      }
+    }
+    keep_image_frames_.clear();
+    prefetch_images_.clear();
+
+    /* The size of the images of the previous frame is used to estimate the size of the next. */
+    if (!next_frame || this->bytes_in_flight() > memory_limit_) {
+      return;
+    }
+    if (scene_eval->nodetree) {
+      this->gather_images(*scene_eval->nodetree, *next_frame);
+    }
+    if (prefetch_images_.is_empty()) {
+      return;
+    }
+
+    prefetched_bytes_ = 0;
+    BLI_threadpool_init(&prefetch_threads_, prefetch_images_thread, 1);
+    BLI_threadpool_insert(&prefetch_threads_, this);
+    is_prefetching_ = true;
+  }
+
+  /**
+   * Write the current render result in the background, waiting for previous frames to be written
+   * first if the memory limit is exceeded.
+   */
+  void schedule_write(Main *bmain, Scene *scene)
+  {
+    RenderResult rres;
+    RE_AcquireResultImageViews(re_, &rres);
+    RenderResult *rr = RE_DuplicateRenderResult(&rres);
+    RE_ReleaseResultImageViews(re_, &rres);
+
+    PipelineFrameWriteTaskData *task_data = MEM_cnew<PipelineFrameWriteTaskData>(__func__);
+    task_data->rr = rr;
+    task_data->rr_size = render_result_size_in_memory(rr);
+    memcpy(&task_data->tmp_scene, scene, sizeof(task_data->tmp_scene));
+    memcpy(&task_data->tmp_rd, &re_->r, sizeof(task_data->tmp_rd));
+    if (!is_movie_) {
+      BKE_image_path_from_imformat(task_data->filepath,
+                                   scene->r.pic,
+                                   BKE_main_blendfile_path(bmain),
+                                   scene->r.cfra,
+                                   &scene->r.im_format,
+                                   (scene->r.scemode & R_EXTENSION) != 0,
+                                   true,
+                                   nullptr);
+    }
+
+    {
+      /* Always allow one frame to be written, even if it exceeds the limit on its own. */
+      std::unique_lock lock(write_mutex_);
+      write_condition_.wait(lock, [&]() {
+        return scheduled_frames_num_ == 0 ||
+               this->bytes_in_flight_locked() + task_data->rr_size <= memory_limit_;
+      });
+      scheduled_frames_num_++;
+      scheduled_bytes_ += task_data->rr_size;
+    }
+
+    BLI_task_pool_push(write_pool_, write_frame_task, task_data, true, nullptr);
+  }
+
+  /**
+   * Report the encoding time and run the write callbacks of the frames written since the last
+   * call, with the scene frame temporarily set to the written frame.
+   */
+  void run_write_callbacks(Scene *scene)
+  {
+    blender::Vector<PipelineWrittenFrame> frames;
+    {
+      std::scoped_lock lock(write_mutex_);
+      frames = std::move(written_frames_);
+      written_frames_.clear();
+    }
+
+    const int cfra = scene->r.cfra;
+    for (const PipelineWrittenFrame &frame : frames) {
+      re_->i.lastencodetime = frame.encode_time;
+      if (!G.quiet) {
+        char time_str[32];
+        BLI_timecode_string_from_time_simple(time_str, sizeof(time_str), frame.encode_time);
+        printf("Saved frame %d (Encoding: %s)\n", frame.cfra, time_str);
+        fflush(stdout);
+      }
+
+      scene->r.cfra = frame.cfra;
+      render_callback_exec_id(re_, re_->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+    }
+    scene->r.cfra = cfra;
+  }
+
+  bool write_failed()
+  {
+    std::scoped_lock lock(write_mutex_);
+    return write_failed_;
+  }
+
+  /** Wait for all loads and writes to finish. */
+  void finish()
+  {
+    this->wait_for_prefetch();
+
+    /* Wait for the background thread to write all frames, like #screen_opengl_render_end, so
+     * movie frames aren't written out of order by the waiting thread. */
+    {
+      std::unique_lock lock(write_mutex_);
+      write_condition_.wait(lock, [&]() { return scheduled_frames_num_ == 0; });
+    }
+    BLI_task_pool_work_and_wait(write_pool_);
+  }
+
+ private:
+  size_t bytes_in_flight_locked() const
+  {
+    return scheduled_bytes_ + prefetched_bytes_;
+  }
+
+  size_t bytes_in_flight()
+  {
+    std::scoped_lock lock(write_mutex_);
+    return this->bytes_in_flight_locked();
+  }
+
+  void gather_images(const bNodeTree &node_tree, const int frame)
+  {
+    for (const bNode *node : node_tree.all_nodes()) {
+      if (node->flag & NODE_MUTED) {
+        continue;
+      }
+      if (ELEM(node->type, NODE_GROUP, NODE_CUSTOM_GROUP) && node->id) {
+        this->gather_images(*reinterpret_cast<const bNodeTree *>(node->id), frame);
+        continue;
+      }
+      if (node->type != CMP_NODE_IMAGE || node->id == nullptr || node->storage == nullptr) {
+        continue;
+      }
+
+      Image *image = reinterpret_cast<Image *>(node->id);
+      if (image->source != IMA_SRC_SEQUENCE || image->type != IMA_TYPE_IMAGE) {
+        continue;
+      }
+
+      PipelineFrameImage frame_image;
+      frame_image.image = image;
+      frame_image.image_user = *static_cast<const ImageUser *>(node->storage);
+      BKE_image_user_frame_calc(image, &frame_image.image_user, frame);
+
+      /* With several image users of one image, only the frame of the first is kept. */
+      keep_image_frames_.add(image, frame_image.image_user.framenr);
+      prefetch_images_.append(frame_image);
+    }
+  }
+
+  void wait_for_prefetch()
+  {
+    if (is_prefetching_) {
+      BLI_threadpool_end(&prefetch_threads_);
+      is_prefetching_ = false;
+    }
+  }
+
+  static void *prefetch_images_thread(void *data)
+  {
+    PipelineFrames *pipeline = static_cast<PipelineFrames *>(data);
+    for (PipelineFrameImage &frame_image : pipeline->prefetch_images_) {
+      if (G.is_break) {
+        break;
+      }
+      ImBuf *ibuf = BKE_image_acquire_ibuf(frame_image.image, &frame_image.image_user, nullptr);
+      if (ibuf) {
+        pipeline->prefetched_bytes_ += IMB_get_size_in_memory(ibuf);
+      }
+      BKE_image_release_ibuf(frame_image.image, ibuf, nullptr);
+    }
+    return nullptr;
+  }
+
+  void write_frame(PipelineFrameWriteTaskData &task_data)
+  {
+    Scene *scene = &task_data.tmp_scene;
+    const double encode_start_time = BLI_time_now_seconds();
+    bool ok = !this->write_failed();
+    if (ok) {
+      if (is_movie_) {
+        ok = RE_WriteRenderViewsMovie(re_->reports,
+                                      task_data.rr,
+                                      scene,
+                                      &task_data.tmp_rd,
+                                      mh_,
+                                      re_->movie_ctx_arr,
+                                      totvideos_,
+                                      false);
+      }
+      else {
+        ok = BKE_image_render_write(re_->reports, task_data.rr, scene, true, task_data.filepath);
+      }
+    }
+    const double encode_time = BLI_time_now_seconds() - encode_start_time;
+    RE_FreeRenderResult(task_data.rr);
+
+    std::scoped_lock lock(write_mutex_);
+    if (ok) {
+      written_frames_.append({scene->r.cfra, encode_time});
+    }
+    else {
+      write_failed_ = true;
+    }
+    scheduled_frames_num_--;
+    scheduled_bytes_ -= task_data.rr_size;
+    write_condition_.notify_all();
+  }
+
+  static void write_frame_task(TaskPool *__restrict pool, void *task_data_v)
+  {
+    /* Isolate the task so that multi-threaded image operations don't cause this thread to start
+     * writing another frame, which would be out of order for movies. */
+    PipelineFrames *pipeline = static_cast<PipelineFrames *>(BLI_task_pool_user_data(pool));
+    PipelineFrameWriteTaskData *task_data = static_cast<PipelineFrameWriteTaskData *>(
+        task_data_v);
+    blender::threading::isolate_task([&]() { pipeline->write_frame(*task_data); });
+  }
+};
+
+/** \} */
+
 void RE_RenderAnim(Render *re,
                    Main *bmain,
                    Scene *scene,
@@ -2370,6 +2761,9 @@ void RE_RenderAnim(Render *re,
     return;
   }
 
+  /* Don't show the encoding time of a previous render until the first frame is written. */
+  re->i.lastencodetime = 0.0;
+
   RenderEngineType *re_type = RE_engines_find(re->r.engine);
 
   /* Only disable file writing if postprocessing is also disabled. */
@@ -2421,6 +2815,20 @@ void RE_RenderAnim(Render *re,
     }
   }
 
+  /* Pipeline frames, prefetching images only for animations that are only composited, see
+   * #PipelineFrames. */
+  std::unique_ptr<PipelineFrames> pipeline_frames;
+  if (pipeline_frames_memory_limit > 0 && do_write_file) {
+    const bool is_only_composited = !(re_type->flag & RE_USE_POSTPROCESS) &&
+                                    !RE_seq_render_active(scene, &rd) &&
+                                    !compositor_needs_render(scene);
+    pipeline_frames = std::make_unique<PipelineFrames>(
+        re, mh, totvideos, is_movie, pipeline_frames_memory_limit, is_only_composited);
+    if (is_only_composited) {
+      re->flag |= R_PIPELINE_FRAMES;
+    }
+  }
+
   /* Ugly global still... is to prevent renderwin events and signal subdivision-surface etc
    * to make full resolution is also set by caller renderwin.c */
   G.is_rendering = true;
@@ -2547,16 +2955,30 @@ void RE_RenderAnim(Render *re,
     /* run callbacks before rendering, before the scene is updated */
     render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_PRE);
 
+    if (pipeline_frames) {
+      pipeline_frames->begin_frame(bmain,
+                                   re->pipeline_scene_eval,
+                                   scene->r.cfra,
+                                   nfra <= efra ? std::optional<int>(nfra) : std::nullopt);
+    }
+
     do_render_full_pipeline(re);
     totrendered++;
 
     const bool should_write = !(re->flag & R_SKIP_WRITE);
     if (re->test_break_cb(re->tbh) == 0) {
       if (!G.is_break && should_write) {
-        if (!do_write_image_or_movie(re, bmain, scene, mh, totvideos, nullptr)) {
+        if (pipeline_frames) {
+          pipeline_frames->schedule_write(bmain, scene);
+          render_frame_stats_report(re, false);
+        }
+        else if (!do_write_image_or_movie(re, bmain, scene, mh, totvideos, nullptr)) {
           G.is_break = true;
         }
       }
+      if (pipeline_frames && pipeline_frames->write_failed()) {
+        G.is_break = true;
+      }
     }
     else {
       G.is_break = true;
@@ -2597,12 +3019,28 @@ void RE_RenderAnim(Render *re,
     if (G.is_break == false) {
       /* keep after file save */
       render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_POST);
-      if (should_write) {
+      if (pipeline_frames) {
+        pipeline_frames->run_write_callbacks(scene);
+      }
+      else if (should_write) {
         render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
       }
     }
   }
 
+  /* Finish writing all frames before ending the movie. */
+  if (pipeline_frames) {
+    pipeline_frames->finish();
+    if (pipeline_frames->write_failed()) {
+      G.is_break = true;
+    }
+    if (G.is_break == false) {
+      pipeline_frames->run_write_callbacks(scene);
+    }
+    pipeline_frames.reset();
+    re->flag &= ~R_PIPELINE_FRAMES;
+  }
+
   /* end movie */
   if (is_movie && do_write_file) {
     re_movie_free_all(re, mh, totvideos);
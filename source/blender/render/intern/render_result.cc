@@ -101,6 +101,10 @@ void render_result_free(RenderResult *rr)
 
   BKE_stamp_data_free(rr->stamp_data);
 
+  if (rr->exrhandle) {
+    IMB_exr_close(rr->exrhandle);
+  }
+
   MEM_freeN(rr);
 }
 
@@ -704,13 +708,32 @@ static int order_render_passes(const void *a, const void *b)
   return (rpa->view_id < rpb->view_id);
 }
 
+/* Convert pass pixels read from an EXR file to the scene linear color space. */
+static void render_result_exr_pass_colorspace(RenderPass *rpass,
+                                              const char *colorspace,
+                                              const bool predivide)
+{
+  if (RE_RenderPassIsColor(rpass)) {
+    IMB_colormanagement_transform(rpass->ibuf->float_buffer.data,
+                                  rpass->rectx,
+                                  rpass->recty,
+                                  rpass->channels,
+                                  colorspace,
+                                  IMB_colormanagement_role_colorspace_name_get(
+                                      COLOR_ROLE_SCENE_LINEAR),
+                                  predivide);
+  }
+  else {
+    IMB_colormanagement_assign_float_colorspace(
+        rpass->ibuf, IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DATA));
+  }
+}
+
 RenderResult *render_result_new_from_exr(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty)
 {
   RenderResult *rr = MEM_cnew<RenderResult>(__func__);
-  const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
-      COLOR_ROLE_SCENE_LINEAR);
-  const char *data_colorspace = IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DATA);
+  bool has_unloaded_passes = false;
 
   rr->rectx = rectx;
   rr->recty = recty;
@@ -727,24 +750,69 @@ RenderResult *render_result_new_from_exr(
       rpass->rectx = rectx;
       rpass->recty = recty;
 
-      if (RE_RenderPassIsColor(rpass)) {
-        IMB_colormanagement_transform(rpass->ibuf->float_buffer.data,
-                                      rpass->rectx,
-                                      rpass->recty,
-                                      rpass->channels,
-                                      colorspace,
-                                      to_colorspace,
-                                      predivide);
-      }
-      else {
-        IMB_colormanagement_assign_float_colorspace(rpass->ibuf, data_colorspace);
+      if (rpass->ibuf->float_buffer.data == nullptr) {
+        /* Read on demand by #RE_pass_ensure_loaded. */
+        has_unloaded_passes = true;
+        continue;
       }
+
+      render_result_exr_pass_colorspace(rpass, colorspace, predivide);
     }
   }
 
+  if (has_unloaded_passes) {
+    rr->exrhandle = exrhandle;
+    STRNCPY(rr->exr_colorspace, colorspace);
+    rr->exr_predivide = predivide;
+  }
+
   return rr;
 }
 
+bool RE_pass_ensure_loaded(RenderResult *rr, RenderPass *rpass)
+{
+  if (rr->exrhandle == nullptr || (rpass->ibuf && rpass->ibuf->float_buffer.data)) {
+    return true;
+  }
+
+  const RenderLayer *rl = nullptr;
+  LISTBASE_FOREACH (const RenderLayer *, rl_iter, &rr->layers) {
+    if (BLI_findindex(&rl_iter->passes, rpass) != -1) {
+      rl = rl_iter;
+      break;
+    }
+  }
+  if (rl == nullptr) {
+    return false;
+  }
+
+  /* Zero initialized, the same as passes which failed to read when loading all at once. */
+  float *rect = static_cast<float *>(MEM_callocN(
+      sizeof(float) * size_t(rpass->rectx) * rpass->recty * rpass->channels, "pass rect"));
+  const bool success = IMB_exr_read_pass(rr->exrhandle, rl->name, rpass->name, rpass->view, rect);
+
+  RE_pass_set_buffer_data(rpass, rect);
+  render_result_exr_pass_colorspace(rpass, rr->exr_colorspace, rr->exr_predivide);
+
+  return success;
+}
+
+void RE_render_result_ensure_passes_loaded(RenderResult *rr)
+{
+  if (rr->exrhandle == nullptr) {
+    return;
+  }
+
+  LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
+    LISTBASE_FOREACH (RenderPass *, rpass, &rl->passes) {
+      RE_pass_ensure_loaded(rr, rpass);
+    }
+  }
+
+  IMB_exr_close(rr->exrhandle);
+  rr->exrhandle = nullptr;
+}
+
 void render_result_view_new(RenderResult *rr, const char *viewname)
 {
   RenderView *rv = MEM_cnew<RenderView>("new render view");
@@ -1339,6 +1407,8 @@ RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
   }
 
   new_rr->ibuf = IMB_dupImBuf(rr->ibuf);
+  /* The file handle stays with the original, passes not loaded yet remain empty in the copy. */
+  new_rr->exrhandle = nullptr;
 
   new_rr->stamp_data = BKE_stamp_data_copy(new_rr->stamp_data);
   return new_rr;
@@ -265,3 +265,7 @@ struct Render : public BaseRender {
  * the output will be written from the File Output nodes, since the render pipeline will early fail
  * if neither a File Output nor a Composite node exist in the scene. */
 #define R_SKIP_WRITE 1 << 1
+/* Indicates that animation frames are pipelined with prefetching, and the pipeline loads images of
+ * the next frame while the current one is rendered. The pipeline then takes care of freeing images
+ * of previous frames, instead of the render of every frame. */
+#define R_PIPELINE_FRAMES 1 << 2
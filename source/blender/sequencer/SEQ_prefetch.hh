@@ -11,6 +11,9 @@
 struct bContext;
 struct Scene;
 
+/** Upper limit of #Editing.prefetch_threads. */
+#define SEQ_PREFETCH_THREADS_MAX 64
+
 void SEQ_prefetch_stop_all();
 /**
  * Use also to update scene and context changes
@@ -18,8 +18,9 @@ struct Scene;
 struct Sequence;
 struct StripElem;
 
-enum eSeqTaskId {
+enum eSeqTaskId : int {
   SEQ_TASK_MAIN_RENDER,
+  /** Prefetch workers use consecutive IDs starting with this one. */
   SEQ_TASK_PREFETCH_RENDER,
 };
 
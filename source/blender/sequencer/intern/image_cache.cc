@@ -18,10 +18,15 @@
 
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
+#include "IMB_metadata.hh"
 
+#include "BLI_array.hh"
+#include "BLI_compression.hh"
 #include "BLI_fileops_types.h"
 #include "BLI_ghash.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 
 #include "BKE_main.hh"
@@ -53,12 +58,18 @@
  * Entries are linked in order as they are put into cache.
  * Only permanent (is_temp_cache = 0) cache entries are linked.
  * Putting #SEQ_CACHE_STORE_FINAL_OUT will reset linking
+ * Prefetch workers render different frames at the same time, so every task links its entries
+ * separately.
  *
  * Only entire frame can be freed to release resources for new entries (recycling).
  * Once again, this is to reduce number of iterations, but also more controllable than removing
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Compression: With #SEQ_CACHE_COMPRESS, a full cache first compresses the images of frames
+ * in memory, starting with the frames that would be recycled, and only recycles frames once
+ * all of them are compressed. Compressed images are restored when they are accessed.
  */
 
 struct SeqCache {
@@ -67,17 +78,212 @@ struct SeqCache {
   ThreadMutex iterator_mutex;
   BLI_mempool *keys_pool;
   BLI_mempool *items_pool;
-  SeqCacheKey *last_key;
+  /** Last linked key of every task, indexed by #SeqCacheKey.task_id. */
+  SeqCacheKey *last_key[SEQ_TASK_PREFETCH_RENDER + SEQ_PREFETCH_THREADS_MAX];
   SeqDiskCache *disk_cache;
 };
 
 struct SeqCacheItem {
   SeqCache *cache_owner;
+  /** Null while the image is compressed. */
   ImBuf *ibuf;
+  SeqCacheCompressedImage *compressed;
+  /** Compressing the image didn't save memory, don't try again. */
+  bool is_incompressible;
 };
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
 
+/* -------------------------------------------------------------------- */
+/** \name Compressed Images
+ *
+ * Pixels are XOR delta encoded with the previous pixel and compressed with the fastest zstd
+ * level. Chunks of rows are compressed separately, so images are compressed and restored in
+ * parallel. This is lossless for byte and float images.
+ * \{ */
+
+/** Number of image rows compressed together. */
+static constexpr int COMPRESSED_CHUNK_ROWS = 64;
+
+struct SeqCacheCompressedImage {
+  /** Image without pixels, owned by the compressed image until the pixels are restored. */
+  ImBuf *ibuf = nullptr;
+  ColorSpace *byte_colorspace = nullptr;
+  ColorSpace *float_colorspace = nullptr;
+  blender::Array<blender::Array<std::byte, 0>> byte_chunks;
+  blender::Array<blender::Array<std::byte, 0>> float_chunks;
+};
+
+/**
+ * Compress \a rows_num rows of \a row_size words each, where every pixel has \a pixel_size words.
+ * \return No chunks if compression fails.
+ */
+static blender::Array<blender::Array<std::byte, 0>> seq_cache_compress_pixels(
+    const uint32_t *pixels, const int64_t row_size, const int rows_num, const int pixel_size)
+{
+  using namespace blender;
+  Array<Array<std::byte, 0>> chunks(divide_ceil_u(rows_num, COMPRESSED_CHUNK_ROWS));
+  /* The cache is locked, don't let the calling thread pick up unrelated tasks. */
+  threading::isolate_task([&]() {
+    threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        const IndexRange rows = IndexRange(chunk * COMPRESSED_CHUNK_ROWS, COMPRESSED_CHUNK_ROWS)
+                                    .intersect(IndexRange(rows_num));
+        Array<uint32_t> data(Span<uint32_t>(pixels + rows.start() * row_size,
+                                            rows.size() * row_size));
+        compression::xor_delta_encode(data, pixel_size);
+        chunks[chunk] = compression::compress_zstd(data.as_span().cast<std::byte>(), 1);
+      }
+    });
+  });
+  for (const Array<std::byte, 0> &chunk : chunks) {
+    if (chunk.is_empty()) {
+      return {};
+    }
+  }
+  return chunks;
+}
+
+static void seq_cache_decompress_pixels(
+    const blender::Span<blender::Array<std::byte, 0>> chunks,
+    uint32_t *pixels,
+    const int64_t row_size,
+    const int rows_num,
+    const int pixel_size)
+{
+  using namespace blender;
+  threading::isolate_task([&]() {
+    threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        const IndexRange rows = IndexRange(chunk * COMPRESSED_CHUNK_ROWS, COMPRESSED_CHUNK_ROWS)
+                                    .intersect(IndexRange(rows_num));
+        MutableSpan<uint32_t> data(pixels + rows.start() * row_size, rows.size() * row_size);
+        const bool success = compression::decompress_zstd(chunks[chunk],
+                                                          data.cast<std::byte>());
+        /* The data was compressed in memory, this can only fail when it got corrupted. */
+        BLI_assert_msg(success, "Compressed sequencer cache image could not be restored");
+        UNUSED_VARS_NDEBUG(success);
+        compression::xor_delta_decode(data, pixel_size);
+      }
+    });
+  });
+}
+
+static size_t seq_cache_compressed_chunks_size(
+    const blender::Span<blender::Array<std::byte, 0>> chunks)
+{
+  size_t size = 0;
+  for (const blender::Array<std::byte, 0> &chunk : chunks) {
+    size += chunk.size();
+  }
+  return size;
+}
+
+/**
+ * Copy all state of \a ibuf except for its pixels, in the same way as #IMB_dupImBuf.
+ */
+static ImBuf *seq_cache_ibuf_copy_without_pixels(const ImBuf *ibuf)
+{
+  ImBuf *ibuf_copy = IMB_allocImBuf(ibuf->x, ibuf->y, ibuf->planes, 0);
+  ImBuf tbuf = *ibuf;
+
+  /* Keep the empty buffers of the new image. */
+  tbuf.byte_buffer = ibuf_copy->byte_buffer;
+  tbuf.float_buffer = ibuf_copy->float_buffer;
+  tbuf.encoded_buffer = ibuf_copy->encoded_buffer;
+  tbuf.encoded_size = 0;
+  tbuf.encoded_buffer_size = 0;
+  tbuf.flags &= ~(IB_rect | IB_rectfloat);
+  for (int a = 0; a < IMB_MIPMAP_LEVELS; a++) {
+    tbuf.mipmap[a] = nullptr;
+  }
+  tbuf.dds_data.data = nullptr;
+
+  tbuf.refcounter = 0;
+  tbuf.metadata = nullptr;
+  tbuf.display_buffer_flags = nullptr;
+  tbuf.colormanage_cache = nullptr;
+  tbuf.gpu.texture = nullptr;
+
+  *ibuf_copy = tbuf;
+  IMB_metadata_copy(ibuf_copy, ibuf);
+  return ibuf_copy;
+}
+
+SeqCacheCompressedImage *seq_cache_compress_image(const ImBuf *ibuf)
+{
+  if ((ibuf->byte_buffer.data == nullptr && ibuf->float_buffer.data == nullptr) ||
+      ibuf->x == 0 || ibuf->y == 0)
+  {
+    return nullptr;
+  }
+
+  SeqCacheCompressedImage *image = MEM_new<SeqCacheCompressedImage>(__func__);
+  size_t size_raw = 0;
+  size_t size_compressed = 0;
+  if (ibuf->byte_buffer.data) {
+    image->byte_chunks = seq_cache_compress_pixels(
+        reinterpret_cast<const uint32_t *>(ibuf->byte_buffer.data), ibuf->x, ibuf->y, 1);
+    image->byte_colorspace = ibuf->byte_buffer.colorspace;
+    size_raw += size_t(ibuf->x) * ibuf->y * 4;
+    size_compressed += seq_cache_compressed_chunks_size(image->byte_chunks);
+  }
+  if (ibuf->float_buffer.data) {
+    image->float_chunks = seq_cache_compress_pixels(
+        reinterpret_cast<const uint32_t *>(ibuf->float_buffer.data),
+        int64_t(ibuf->x) * ibuf->channels,
+        ibuf->y,
+        ibuf->channels);
+    image->float_colorspace = ibuf->float_buffer.colorspace;
+    size_raw += size_t(ibuf->x) * ibuf->y * ibuf->channels * sizeof(float);
+    size_compressed += seq_cache_compressed_chunks_size(image->float_chunks);
+  }
+
+  const bool success = (ibuf->byte_buffer.data == nullptr || !image->byte_chunks.is_empty()) &&
+                       (ibuf->float_buffer.data == nullptr || !image->float_chunks.is_empty());
+  if (!success || size_compressed >= size_raw) {
+    MEM_delete(image);
+    return nullptr;
+  }
+
+  image->ibuf = seq_cache_ibuf_copy_without_pixels(ibuf);
+  return image;
+}
+
+ImBuf *seq_cache_decompress_image(SeqCacheCompressedImage *image)
+{
+  ImBuf *ibuf = image->ibuf;
+  if (!image->byte_chunks.is_empty()) {
+    imb_addrectImBuf(ibuf, false);
+    ibuf->byte_buffer.colorspace = image->byte_colorspace;
+    seq_cache_decompress_pixels(image->byte_chunks,
+                                reinterpret_cast<uint32_t *>(ibuf->byte_buffer.data),
+                                ibuf->x,
+                                ibuf->y,
+                                1);
+  }
+  if (!image->float_chunks.is_empty()) {
+    imb_addrectfloatImBuf(ibuf, ibuf->channels, false);
+    ibuf->float_buffer.colorspace = image->float_colorspace;
+    seq_cache_decompress_pixels(image->float_chunks,
+                                reinterpret_cast<uint32_t *>(ibuf->float_buffer.data),
+                                int64_t(ibuf->x) * ibuf->channels,
+                                ibuf->y,
+                                ibuf->channels);
+  }
+  image->ibuf = nullptr;
+  MEM_delete(image);
+  return ibuf;
+}
+
+void seq_cache_compressed_image_free(SeqCacheCompressedImage *image)
+{
+  IMB_freeImBuf(image->ibuf);
+  MEM_delete(image);
+}
+
+/** \} */
+
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
   return ((a->preview_render_size != b->preview_render_size) || (a->rectx != b->rectx) ||
@@ -188,6 +394,9 @@ static void seq_cache_valfree(void *val)
   if (item->ibuf) {
     IMB_freeImBuf(item->ibuf);
   }
+  if (item->compressed) {
+    seq_cache_compressed_image_free(item->compressed);
+  }
 
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
@@ -208,20 +417,30 @@ static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
   return flag;
 }
 
+static void seq_cache_reset_linking(SeqCache *cache)
+{
+  for (SeqCacheKey *&last_key : cache->last_key) {
+    last_key = nullptr;
+  }
+}
+
 static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
+  SeqCacheKey *&last_key = cache->last_key[key->task_id];
   SeqCacheItem *item;
   item = static_cast<SeqCacheItem *>(BLI_mempool_alloc(cache->items_pool));
   item->cache_owner = cache;
   item->ibuf = ibuf;
+  item->compressed = nullptr;
+  item->is_incompressible = false;
 
   const int stored_types_flag = get_stored_types_flag(scene, key);
 
   /* Item stored for later use. */
   if (stored_types_flag & key->type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = last_key;
   }
 
   BLI_assert(!BLI_ghash_haskey(cache->hash, key));
@@ -229,19 +448,19 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   IMB_refImBuf(ibuf);
 
   /* Store pointer to last cached key. */
-  SeqCacheKey *temp_last_key = cache->last_key;
-  cache->last_key = key;
+  SeqCacheKey *temp_last_key = last_key;
+  last_key = key;
 
   /* Set last_key's reference to this key so we can look up chain backwards.
-   * Item is already put in cache, so cache->last_key points to current key.
+   * Item is already put in cache, so last_key points to current key.
    */
   if (!key->is_temp_cache && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+    temp_last_key->link_next = last_key;
   }
 
   /* Reset linking. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = nullptr;
+    last_key = nullptr;
   }
 }
 
@@ -249,6 +468,11 @@ static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
 {
   SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(cache->hash, key));
 
+  if (item && item->compressed) {
+    item->ibuf = seq_cache_decompress_image(item->compressed);
+    item->compressed = nullptr;
+  }
+
   if (item && item->ibuf) {
     IMB_refImBuf(item->ibuf);
 
@@ -333,6 +557,16 @@ static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCac
   return finalkey;
 }
 
+/**
+ * Prefetch workers may still be linking the frame which is recycled, let them start a new chain.
+ */
+static void seq_cache_key_unlink_last(SeqCache *cache, SeqCacheKey *key)
+{
+  if (cache->last_key[key->task_id] == key) {
+    cache->last_key[key->task_id] = nullptr;
+  }
+}
+
 static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
@@ -354,9 +588,9 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
       break;
     }
 
+    seq_cache_key_unlink_last(cache, base);
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
     base = prev;
   }
 
@@ -373,14 +607,50 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
       break;
     }
 
+    seq_cache_key_unlink_last(cache, base);
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
     base = next;
   }
 }
 
-static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
+/**
+ * Compress images of \a base and all entries linked before it, they stay in the cache.
+ */
+static void seq_cache_compress_linked(SeqCacheKey *base)
+{
+  SeqCache *cache = base->cache_owner;
+  const auto compress_item = [&](SeqCacheKey *key) {
+    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(cache->hash, key));
+    if (item == nullptr || item->ibuf == nullptr) {
+      return;
+    }
+    item->compressed = seq_cache_compress_image(item->ibuf);
+    if (item->compressed) {
+      IMB_freeImBuf(item->ibuf);
+      item->ibuf = nullptr;
+    }
+    else {
+      item->is_incompressible = true;
+    }
+  };
+
+  SeqCacheKey *key = base;
+  while (key) {
+    compress_item(key);
+
+    SeqCacheKey *prev = key->link_prev;
+    if (prev != nullptr && prev->link_next != key) {
+      break; /* Key doesn't belong to this chain anymore. */
+    }
+    key = prev;
+  }
+}
+
+/**
+ * \param for_compression: Only find frames with images which can still be compressed.
+ */
+static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene, const bool for_compression)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
   SeqCacheKey *finalkey = nullptr;
@@ -401,7 +671,7 @@ static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
     BLI_assert(key->cache_owner == cache);
 
     /* This shouldn't happen, but better be safe than sorry. */
-    if (!item->ibuf) {
+    if (!item->ibuf && !item->compressed) {
       seq_cache_recycle_linked(scene, key);
       /* Can not continue iterating after linked remove. */
       BLI_ghashIterator_init(&gh_iter, cache->hash);
@@ -412,6 +682,10 @@ static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
       continue;
     }
 
+    if (for_compression && (item->ibuf == nullptr || item->is_incompressible)) {
+      continue;
+    }
+
     total_count++;
 
     if (lkey) {
@@ -448,7 +722,16 @@ bool seq_cache_recycle_item(Scene *scene)
   seq_cache_lock(scene);
 
   while (seq_cache_is_full()) {
-    SeqCacheKey *finalkey = seq_cache_get_item_for_removal(scene);
+    /* Compress frames before recycling any of them. */
+    if (scene->ed->cache_flag & SEQ_CACHE_COMPRESS) {
+      SeqCacheKey *compress_key = seq_cache_get_item_for_removal(scene, true);
+      if (compress_key) {
+        seq_cache_compress_linked(compress_key);
+        continue;
+      }
+    }
+
+    SeqCacheKey *finalkey = seq_cache_get_item_for_removal(scene, false);
 
     if (finalkey) {
       seq_cache_recycle_linked(scene, finalkey);
@@ -494,7 +777,7 @@ static void seq_cache_create(Main *bmain, Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = nullptr;
+    seq_cache_reset_linking(cache);
     cache->bmain = bmain;
     BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
@@ -562,11 +845,9 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
           timeline_frame > SEQ_time_right_handle_frame_get(scene, key->seq) ||
           timeline_frame < SEQ_time_left_handle_frame_get(scene, key->seq))
       {
+        seq_cache_key_unlink_last(cache, key);
         seq_cache_key_unlink(key);
         BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
-        if (key == cache->last_key) {
-          cache->last_key = nullptr;
-        }
       }
     }
   }
@@ -615,7 +896,7 @@ void SEQ_cache_cleanup(Scene *scene)
     /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -680,7 +961,7 @@ void seq_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -766,8 +1047,9 @@ bool seq_cache_put_if_possible(
   }
 
   if (scene->ed->cache) {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = nullptr;
+    SeqCacheKey *&last_key = scene->ed->cache->last_key[context->task_id];
+    seq_cache_set_temp_cache_linked(scene, last_key);
+    last_key = nullptr;
   }
 
   return false;
@@ -861,7 +1143,7 @@ void SEQ_cache_iterate(
     interrupt = callback_iter(userdata, key->seq, timeline_frame, key->type);
   }
 
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
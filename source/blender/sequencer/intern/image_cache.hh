@@ -13,6 +13,7 @@
 struct ImBuf;
 struct Scene;
 struct SeqCache;
+struct SeqCacheCompressedImage;
 struct SeqRenderData;
 struct Sequence;
 
@@ -51,3 +52,13 @@ void seq_cache_cleanup_sequence(Scene *scene,
                                 bool force_seq_changed_range);
 bool seq_cache_is_full();
 float seq_cache_frame_index_to_timeline_frame(Sequence *seq, float frame_index);
+
+/**
+ * \return The compressed image or null if compression would not save memory.
+ */
+SeqCacheCompressedImage *seq_cache_compress_image(const ImBuf *ibuf);
+/**
+ * Restore the pixels of the compressed image, which is freed.
+ */
+ImBuf *seq_cache_decompress_image(SeqCacheCompressedImage *image);
+void seq_cache_compressed_image_free(SeqCacheCompressedImage *image);
@@ -83,7 +83,11 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      float timeline_frame,
                                      int chanshown);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/**
+ * Prefetch workers render on their own evaluated copies of the scene and may run concurrently,
+ * rendering on the original scene is exclusive.
+ */
+static ThreadRWMutex seq_render_mutex = BLI_RWLOCK_INITIALIZER;
 SequencerDrawView sequencer_view3d_fn = nullptr; /* nullptr in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -2106,7 +2110,8 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   SEQ_relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
   if (!strips.is_empty() && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    BLI_rw_mutex_lock(&seq_render_mutex,
+                      context->is_prefetch_render ? THREAD_LOCK_READ : THREAD_LOCK_WRITE);
     out = seq_render_strip_stack(context, &state, channels, seqbasep, timeline_frame, chanshown);
 
     if (context->is_prefetch_render) {
@@ -2116,7 +2121,7 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
       seq_cache_put_if_possible(
           context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    BLI_rw_mutex_unlock(&seq_render_mutex);
   }
 
   seq_prefetch_start(context, timeline_frame);
@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+#include "IMB_metadata.hh"
+
+#include "image_cache.hh"
+
+namespace blender::seq::tests {
+
+constexpr int IMAGE_WIDTH = 97;
+constexpr int IMAGE_HEIGHT = 131;
+
+/** Image with smooth gradients, so it compresses, and some noise. */
+static ImBuf *create_test_image()
+{
+  ImBuf *ibuf = IMB_allocImBuf(IMAGE_WIDTH, IMAGE_HEIGHT, 32, IB_rect | IB_rectfloat);
+  RandomNumberGenerator rng(0);
+  for (int y = 0; y < ibuf->y; y++) {
+    for (int x = 0; x < ibuf->x; x++) {
+      const int64_t index = int64_t(y) * ibuf->x + x;
+      uchar *byte = ibuf->byte_buffer.data + index * 4;
+      float *pixel = ibuf->float_buffer.data + index * 4;
+      byte[0] = uchar(x);
+      byte[1] = uchar(y);
+      byte[2] = uchar((x * y) & 0xff);
+      byte[3] = 255;
+      pixel[0] = float(x) / ibuf->x;
+      pixel[1] = float(y) / ibuf->y;
+      pixel[2] = (index % 16 == 0) ? rng.get_float() : 0.5f;
+      pixel[3] = 1.0f;
+    }
+  }
+  ibuf->ppm[0] = 3780.0;
+  ibuf->ppm[1] = 2835.0;
+  ibuf->ftype = IMB_FTYPE_PNG;
+  ibuf->foptions.quality = 42;
+  ibuf->userflags = IB_DISPLAY_BUFFER_INVALID;
+  STRNCPY(ibuf->filepath, "//render/frame_0001.png");
+  IMB_metadata_ensure(&ibuf->metadata);
+  IMB_metadata_set_field(ibuf->metadata, "Camera", "Camera.001");
+  return ibuf;
+}
+
+TEST(seq_image_cache, CompressedImageRoundTrip)
+{
+  ImBuf *ibuf = create_test_image();
+
+  SeqCacheCompressedImage *compressed = seq_cache_compress_image(ibuf);
+  ASSERT_NE(compressed, nullptr);
+  ImBuf *restored = seq_cache_decompress_image(compressed);
+  ASSERT_NE(restored, nullptr);
+  EXPECT_NE(restored, ibuf);
+
+  EXPECT_EQ(restored->x, ibuf->x);
+  EXPECT_EQ(restored->y, ibuf->y);
+  EXPECT_EQ(restored->planes, ibuf->planes);
+  EXPECT_EQ(restored->channels, ibuf->channels);
+  EXPECT_EQ(restored->flags, ibuf->flags);
+  EXPECT_EQ(restored->ppm[0], ibuf->ppm[0]);
+  EXPECT_EQ(restored->ppm[1], ibuf->ppm[1]);
+  EXPECT_EQ(restored->ftype, ibuf->ftype);
+  EXPECT_EQ(restored->foptions.quality, ibuf->foptions.quality);
+  EXPECT_EQ(restored->userflags, ibuf->userflags);
+  EXPECT_STREQ(restored->filepath, ibuf->filepath);
+  EXPECT_EQ(restored->refcounter, 0);
+
+  char camera[64];
+  ASSERT_NE(restored->metadata, nullptr);
+  EXPECT_NE(restored->metadata, ibuf->metadata);
+  EXPECT_TRUE(IMB_metadata_get_field(restored->metadata, "Camera", camera, sizeof(camera)));
+  EXPECT_STREQ(camera, "Camera.001");
+
+  const int64_t pixels_num = int64_t(ibuf->x) * ibuf->y;
+  EXPECT_EQ(restored->byte_buffer.colorspace, ibuf->byte_buffer.colorspace);
+  EXPECT_EQ(restored->float_buffer.colorspace, ibuf->float_buffer.colorspace);
+  EXPECT_EQ_ARRAY(restored->byte_buffer.data, ibuf->byte_buffer.data, pixels_num * 4);
+  EXPECT_EQ_ARRAY(restored->float_buffer.data, ibuf->float_buffer.data, pixels_num * 4);
+
+  IMB_freeImBuf(restored);
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(seq_image_cache, CompressedImageFree)
+{
+  ImBuf *ibuf = create_test_image();
+  SeqCacheCompressedImage *compressed = seq_cache_compress_image(ibuf);
+  ASSERT_NE(compressed, nullptr);
+  /* The original image stays valid, it may still be used elsewhere. */
+  seq_cache_compressed_image_free(compressed);
+  EXPECT_NE(ibuf->byte_buffer.data, nullptr);
+  EXPECT_NE(ibuf->float_buffer.data, nullptr);
+  EXPECT_NE(ibuf->metadata, nullptr);
+  IMB_freeImBuf(ibuf);
+}
+
+}  // namespace blender::seq::tests
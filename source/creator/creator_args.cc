@@ -652,6 +652,7 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--frame-start");
   BLI_args_print_arg_doc(ba, "--frame-end");
   BLI_args_print_arg_doc(ba, "--frame-jump");
+  BLI_args_print_arg_doc(ba, "--pipeline-frames-memory");
   BLI_args_print_arg_doc(ba, "--render-output");
   BLI_args_print_arg_doc(ba, "--engine");
   BLI_args_print_arg_doc(ba, "--threads");
@@ -2279,6 +2280,37 @@ static int arg_handle_frame_skip_set(int argc, const char **argv, void *data)
   return 0;
 }
 
+static const char arg_handle_pipeline_frames_memory_set_doc[] =
+    "<megabytes>\n"
+    "\tWhen rendering an animation, write the previous frames while a frame is rendered,\n"
+    "\tand for animations that are only composited, load the images of the next frame too.\n"
+    "\tUses at most <megabytes> of memory for the frames in flight. 0 to disable (default).\n"
+    "\tMust be specified before the '-a' / '--render-anim' argument.";
+static int arg_handle_pipeline_frames_memory_set(int argc, const char **argv, void * /*data*/)
+{
+  const char *arg_id = "--pipeline-frames-memory";
+  const int min = 0, max = INT_MAX;
+  if (argc > 1) {
+    const char *err_msg = nullptr;
+    int megabytes;
+    if (!parse_int_strict_range(argv[1], nullptr, min, max, &megabytes, &err_msg)) {
+      fprintf(stderr,
+              "\nError: %s '%s %s', expected number in [%d..%d].\n",
+              err_msg,
+              arg_id,
+              argv[1],
+              min,
+              max);
+      return 1;
+    }
+
+    RE_SetPipelineFramesMemoryLimit(size_t(megabytes) * 1024 * 1024);
+    return 1;
+  }
+  fprintf(stderr, "\nError: memory limit in megabytes must follow '%s'.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_python_file_run_doc[] =
     "<filepath>\n"
     "\tRun the given Python script file.";
@@ -2847,6 +2879,11 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
   BLI_args_add(ba, "-s", "--frame-start", CB(arg_handle_frame_start_set), C);
   BLI_args_add(ba, "-e", "--frame-end", CB(arg_handle_frame_end_set), C);
   BLI_args_add(ba, "-j", "--frame-jump", CB(arg_handle_frame_skip_set), C);
+  BLI_args_add(ba,
+               nullptr,
+               "--pipeline-frames-memory",
+               CB(arg_handle_pipeline_frames_memory_set),
+               nullptr);
   BLI_args_add(ba, "-P", "--python", CB(arg_handle_python_file_run), C);
   BLI_args_add(ba, nullptr, "--python-text", CB(arg_handle_python_text_run), C);
   BLI_args_add(ba, nullptr, "--python-expr", CB(arg_handle_python_expr_run), C);
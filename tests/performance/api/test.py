@@ -4,7 +4,7 @@
 
 import abc
 import fnmatch
-from typing import Dict, List
+from typing import Callable, Dict, List
 
 
 class Test:
@@ -39,6 +39,30 @@ class Test:
         """
 
 
+class GeneratedSceneTest(Test):
+    """
+    Test that builds its scene from scratch in the factory startup file, so that it does not
+    depend on any benchmark files. The function is run in Blender with the arguments, and its
+    return value is the result.
+    """
+
+    def __init__(self, name: str, category: str, function: Callable[[Dict], Dict], args: Dict):
+        self._name = name
+        self._category = category
+        self.function = function
+        self.args = args
+
+    def name(self) -> str:
+        return self._name
+
+    def category(self) -> str:
+        return self._category
+
+    def run(self, env, device_id: str) -> Dict:
+        result, _ = env.run_in_blender(self.function, self.args)
+        return result
+
+
 class TestCollection:
     def __init__(self, env, names_filter: List = ['*'], categories_filter: List = ['*'], background: bool = False):
         import importlib
@@ -0,0 +1,93 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time the CPU compositor blur nodes with a fixed kernel over a sweep of blur radii.
+
+Small radii are convolved in the spatial domain, large ones in the frequency domain when
+Blender is built with FFTW. The sweep shows the cost of both and where they cross over.
+"""
+
+import api
+
+IMAGE_SIZE = (960, 540)
+
+
+def _prepare_compositor(blur_type, radius):
+    import bpy
+
+    scene = bpy.context.scene
+    scene.render.resolution_x, scene.render.resolution_y = IMAGE_SIZE
+    scene.render.resolution_percentage = 100
+    scene.render.compositor_device = 'CPU'
+    scene.use_nodes = True
+
+    tree = scene.node_tree
+    tree.nodes.clear()
+
+    image = bpy.data.images.new("Input", *IMAGE_SIZE, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+
+    image_node = tree.nodes.new('CompositorNodeImage')
+    image_node.image = image
+
+    # Changed on every run, so the blur isn't reused from the previous one.
+    bright_node = tree.nodes.new('CompositorNodeBrightContrast')
+    tree.links.new(image_node.outputs['Image'], bright_node.inputs['Image'])
+
+    # Blur sizes are a percentage of the largest image dimension for the bokeh blur.
+    relative_size = radius * 100.0 / max(IMAGE_SIZE)
+    if blur_type == 'GAUSSIAN_BOKEH':
+        blur_node = tree.nodes.new('CompositorNodeBlur')
+        blur_node.filter_type = 'GAUSS'
+        blur_node.use_bokeh = True
+        blur_node.size_x = radius
+        blur_node.size_y = radius
+    else:
+        blur_node = tree.nodes.new('CompositorNodeBokehBlur')
+        bokeh_node = tree.nodes.new('CompositorNodeBokehImage')
+        tree.links.new(bokeh_node.outputs['Image'], blur_node.inputs['Bokeh'])
+        if blur_type == 'VARIABLE_SIZE_BOKEH':
+            blur_node.use_variable_size = True
+            blur_node.blur_max = radius
+            size_node = tree.nodes.new('CompositorNodeValue')
+            size_node.outputs['Value'].default_value = relative_size
+            tree.links.new(size_node.outputs['Value'], blur_node.inputs['Size'])
+        else:
+            blur_node.inputs['Size'].default_value = relative_size
+    tree.links.new(bright_node.outputs['Image'], blur_node.inputs['Image'])
+
+    composite_node = tree.nodes.new('CompositorNodeComposite')
+    tree.links.new(blur_node.outputs['Image'], composite_node.inputs['Image'])
+
+    return bright_node
+
+
+def _run(args):
+    import bpy
+    import time
+
+    bright_node = _prepare_compositor(args['blur_type'], args['radius'])
+
+    measured_times = []
+    for i in range(args['repeat']):
+        bright_node.inputs['Bright'].default_value = i * 0.01
+
+        # Without render layer nodes only the compositor is executed.
+        start = time.time()
+        bpy.ops.render.render()
+        measured_times.append(time.time() - start)
+
+    return {'time': min(measured_times)}
+
+
+def generate(env):
+    blur_types = ('BOKEH', 'GAUSSIAN_BOKEH', 'VARIABLE_SIZE_BOKEH')
+    radii = (4, 8, 16, 32, 64, 96)
+    return [api.GeneratedSceneTest(f"{blur_type.lower()}_radius_{radius}",
+                                   "compositor_blur",
+                                   _run,
+                                   {'blur_type': blur_type, 'radius': radius, 'repeat': 3})
+            for blur_type in blur_types
+            for radius in radii]
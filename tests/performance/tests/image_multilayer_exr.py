@@ -0,0 +1,73 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time loading a single pass from a multilayer EXR file with many passes, as the compositor Image
+node does when only a few of the passes are connected.
+
+The file is written first from a render with many AOVs enabled, then loaded again with the image
+cache cleared between repetitions.
+"""
+
+import api
+
+IMAGE_SIZE = (1920, 1080)
+AOVS_NUM = 60
+
+
+def _write_multilayer(filepath):
+    import bpy
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.cycles.samples = 1
+    scene.render.resolution_x, scene.render.resolution_y = IMAGE_SIZE
+    scene.render.resolution_percentage = 100
+    scene.render.use_compositing = False
+    scene.render.use_sequencer = False
+
+    view_layer = scene.view_layers[0]
+    view_layer.use_pass_z = True
+    view_layer.use_pass_normal = True
+    view_layer.use_pass_diffuse_color = True
+    for i in range(AOVS_NUM):
+        aov = view_layer.aovs.add()
+        aov.name = f"AOV{i:02d}"
+        aov.type = 'COLOR'
+
+    scene.render.image_settings.file_format = 'OPEN_EXR_MULTILAYER'
+    scene.render.image_settings.exr_codec = 'ZIP'
+    scene.render.filepath = filepath
+    bpy.ops.render.render(write_still=True)
+    return scene.render.frame_path(frame=scene.frame_current)
+
+
+def _run(args):
+    import bpy
+    import os
+    import tempfile
+    import time
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        filepath = _write_multilayer(os.path.join(temp_dir, "passes"))
+
+        measured_times = []
+        for _ in range(args['repeat']):
+            image = bpy.data.images.load(filepath)
+
+            start = time.time()
+            # Accessing the pixels loads the first pass of the first layer.
+            image.pixels[0]
+            measured_times.append(time.time() - start)
+
+            bpy.data.images.remove(image)
+
+    return {'time': min(measured_times)}
+
+
+def generate(env):
+    args = {
+        'repeat': 3,
+    }
+    return [api.GeneratedSceneTest("load_single_pass", "image_multilayer_exr", _run, args)]
@@ -0,0 +1,154 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time saving a large float image as a 16 bit file, as the final write of a render does.
+
+The image is filled with a noisy gradient so that it does not compress to nothing, then saved
+with the image settings of the scene, keeping the fastest of a few repetitions.
+
+The same image is also written for every frame of a short animation rendered with `-a`, with
+frames written in the background while the next ones are composited, see
+`--pipeline-frames-memory`.
+"""
+
+import api
+
+IMAGE_SIZE = (7680, 4320)
+ANIMATION_FRAMES_NUM = 8
+PIPELINE_FRAMES_MEMORY_MB = 4096
+LOG_KEY = "IMAGE_SAVE_ANIMATION_PERFORMANCE: "
+
+
+def _create_image():
+    import array
+    import bpy
+    import random
+
+    width, height = IMAGE_SIZE
+    image = bpy.data.images.new("Output", width, height, alpha=True, float_buffer=True)
+    rng = random.Random(0)
+    row = array.array('f')
+    for x in range(width):
+        value = x / width
+        row.extend((value, 1.0 - value, rng.random(), 1.0))
+    image.pixels.foreach_set(row * height)
+    return image
+
+
+def _set_image_settings(scene, file_format):
+    settings = scene.render.image_settings
+    settings.file_format = file_format
+    settings.color_mode = 'RGBA'
+    settings.color_depth = '16'
+    if file_format == 'TIFF':
+        settings.tiff_codec = 'DEFLATE'
+
+
+def _run(args):
+    import bpy
+    import os
+    import tempfile
+    import time
+
+    image = _create_image()
+    scene = bpy.context.scene
+    _set_image_settings(scene, args['file_format'])
+
+    measured_times = []
+    with tempfile.TemporaryDirectory() as temp_dir:
+        filepath = os.path.join(temp_dir, "output")
+        for _ in range(args['repeat']):
+            start = time.time()
+            image.save_render(filepath, scene=scene)
+            measured_times.append(time.time() - start)
+
+    bpy.data.images.remove(image)
+    return {'time': min(measured_times)}
+
+
+def _prepare_animation(args):
+    import bpy
+    import time
+
+    scene = bpy.context.scene
+    scene.render.resolution_x, scene.render.resolution_y = IMAGE_SIZE
+    scene.render.resolution_percentage = 100
+    scene.render.filepath = args['render_filepath']
+    scene.frame_start = 1
+    scene.frame_end = ANIMATION_FRAMES_NUM
+    _set_image_settings(scene, args['file_format'])
+
+    # Only composite the image, without a render layer nothing else is rendered.
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+    image_node = tree.nodes.new('CompositorNodeImage')
+    image_node.image = _create_image()
+    composite_node = tree.nodes.new('CompositorNodeComposite')
+    tree.links.new(image_node.outputs['Image'], composite_node.inputs['Image'])
+
+    # Time from the start of the animation until all frames are written.
+    start_time = None
+
+    def render_init(_scene):
+        nonlocal start_time
+        start_time = time.perf_counter()
+
+    def render_complete(_scene):
+        elapsed_time = time.perf_counter() - start_time
+        print(f"{LOG_KEY}{{'time': {elapsed_time / ANIMATION_FRAMES_NUM} }}")
+
+    bpy.app.handlers.render_init.append(render_init)
+    bpy.app.handlers.render_complete.append(render_complete)
+
+
+class ImageSaveAnimationTest(api.Test):
+    def __init__(self, file_format):
+        self.file_format = file_format
+
+    def name(self):
+        return f"{self.file_format.lower()}_16bit_animation"
+
+    def category(self):
+        return "image_save"
+
+    def run(self, env, device_id):
+        import inspect
+        import pathlib
+        import tempfile
+
+        package_path = pathlib.Path(__file__).parent.parent
+        modulename = inspect.getmodule(_prepare_animation).__name__
+
+        with tempfile.TemporaryDirectory() as temp_dir:
+            args = {
+                'file_format': self.file_format,
+                'render_filepath': str(pathlib.Path(temp_dir) / "frame_####"),
+            }
+            # The scene is set up before the animation is rendered with `-a`.
+            expression = (f'import sys;'
+                          f'sys.path.append(r"{package_path}");'
+                          f'import {modulename};'
+                          f'{modulename}._prepare_animation({args!r})')
+            log = env.call_blender(['--pipeline-frames-memory', str(PIPELINE_FRAMES_MEMORY_MB),
+                                    '--python-expr', expression,
+                                    '-a'])
+
+        for line in log:
+            if line.startswith(LOG_KEY):
+                return eval(line[len(LOG_KEY):])
+
+        raise Exception("No image save animation performance result found in log.")
+
+
+def generate(env):
+    file_formats = ('PNG', 'TIFF')
+    tests = [api.GeneratedSceneTest(f"{file_format.lower()}_16bit",
+                                    "image_save",
+                                    _run,
+                                    {'file_format': file_format, 'repeat': 3})
+             for file_format in file_formats]
+    tests += [ImageSaveAnimationTest(file_format) for file_format in file_formats]
+    return tests
@@ -0,0 +1,63 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time edit-mode mesh operators on the whole selection of a generated high resolution grid.
+
+The grid is created in the factory startup file.
+"""
+
+import api
+
+
+def _prepare_mesh(size):
+    import bpy
+
+    if bpy.context.object:
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+    bpy.ops.object.select_all(action='SELECT')
+    bpy.ops.object.delete(use_global=False)
+    bpy.ops.outliner.orphans_purge()
+
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=size, y_subdivisions=size, size=2.0)
+    bpy.ops.object.mode_set(mode='EDIT')
+    bpy.ops.mesh.select_all(action='SELECT')
+
+
+def _run_operator(operator):
+    import bpy
+
+    if operator == 'SUBDIVIDE':
+        bpy.ops.mesh.subdivide(number_cuts=2, smoothness=0.5)
+    elif operator == 'SUBDIVIDE_FRACTAL':
+        bpy.ops.mesh.subdivide(number_cuts=1, fractal=0.2)
+    elif operator == 'INSET_REGION':
+        bpy.ops.mesh.inset(thickness=0.01, depth=0.01, use_interpolate=True)
+    elif operator == 'INSET_REGION_RELATIVE':
+        bpy.ops.mesh.inset(thickness=0.01, depth=0.01, use_relative_offset=True)
+
+
+def _run(args):
+    import time
+
+    measured_times = []
+    for _ in range(args['repeat']):
+        _prepare_mesh(args['size'])
+
+        start = time.time()
+        _run_operator(args['operator'])
+        measured_times.append(time.time() - start)
+
+    return {'time': min(measured_times)}
+
+
+def generate(env):
+    operators = ('SUBDIVIDE', 'SUBDIVIDE_FRACTAL', 'INSET_REGION', 'INSET_REGION_RELATIVE')
+    size = 500
+    return [api.GeneratedSceneTest(f"grid_{size}_{operator.lower()}",
+                                   "mesh_operators",
+                                   _run,
+                                   {'operator': operator, 'size': size, 'repeat': 3})
+            for operator in operators]
@@ -0,0 +1,73 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time interactive edit-mode transform on a generated high resolution grid.
+
+Each transform operator call creates the transform data (including connected distances
+for proportional editing) and applies it once, updating normals and tessellation.
+This is close to the latency of starting an interactive transform, repeated calls
+also measure the cost of every following update.
+The grid is created in the factory startup file.
+"""
+
+import api
+
+
+def _prepare_mesh(size):
+    import bpy
+    import bmesh
+
+    if bpy.context.object:
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+    bpy.ops.object.select_all(action='SELECT')
+    bpy.ops.object.delete(use_global=False)
+    bpy.ops.outliner.orphans_purge()
+
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=size, y_subdivisions=size, size=2.0)
+    bpy.ops.object.mode_set(mode='EDIT')
+
+    # Select a region in the middle of the grid, so proportional editing has work to do.
+    bm = bmesh.from_edit_mesh(bpy.context.object.data)
+    for v in bm.verts:
+        v.select = abs(v.co.x) < 0.25 and abs(v.co.y) < 0.25
+    bm.select_flush(True)
+    bmesh.update_edit_mesh(bpy.context.object.data, loop_triangles=False, destructive=False)
+
+
+def _run_transform(proportional):
+    import bpy
+
+    use_proportional = proportional != 'NONE'
+    bpy.ops.transform.translate(
+        value=(0.0, 0.0, 0.05),
+        use_proportional_edit=use_proportional,
+        use_proportional_connected=(proportional == 'CONNECTED'),
+        proportional_size=0.5,
+    )
+
+
+def _run(args):
+    import time
+
+    _prepare_mesh(args['size'])
+
+    measured_times = []
+    for _ in range(args['repeat']):
+        start = time.time()
+        _run_transform(args['proportional'])
+        measured_times.append(time.time() - start)
+
+    return {'time': min(measured_times)}
+
+
+def generate(env):
+    proportional_modes = ('NONE', 'PROPORTIONAL', 'CONNECTED')
+    size = 1000
+    return [api.GeneratedSceneTest(f"grid_{size}_translate_{proportional.lower()}",
+                                   "mesh_transform",
+                                   _run,
+                                   {'proportional': proportional, 'size': size, 'repeat': 5})
+            for proportional in proportional_modes]
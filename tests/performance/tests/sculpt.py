@@ -26,12 +26,13 @@ def set_view3d_context_override(context_override):
                 context_override["region"] = region
 
 
-def prepare_sculpt_scene(context):
+def prepare_sculpt_scene(context, size):
     import bpy
     """
     Prepare a clean state of the scene suitable for benchmarking
 
-    It creates a high-res object and moves it to a sculpt mode.
+    It creates a high-res grid object with `size` vertices along each side and selects it.
+    Entering sculpt mode is left to the caller, so it can be timed separately.
     """
 
     # Ensure the current mode is object, as it might not be the always the case
@@ -48,8 +49,6 @@ def prepare_sculpt_scene(context):
     group.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
     group_output_node = group.nodes.new('NodeGroupOutput')
 
-    size = 1500
-
     grid_node = group.nodes.new('GeometryNodeMeshGrid')
     grid_node.inputs["Size X"].default_value = 2.0
     grid_node.inputs["Size Y"].default_value = 2.0
@@ -67,8 +66,6 @@ def prepare_sculpt_scene(context):
     bpy.ops.object.modifier_apply(modifier="Test")
 
     bpy.ops.object.select_all(action='SELECT')
-    # Move the plane to the sculpt mode.
-    bpy.ops.object.mode_set(mode='SCULPT')
 
 
 def generate_stroke(context):
@@ -116,7 +113,12 @@ def _run(args):
     # Create an undo stack explicitly. This isn't created by default in background mode.
     bpy.ops.ed.undo_push()
 
-    prepare_sculpt_scene(context)
+    prepare_sculpt_scene(context, args['size'])
+
+    # Move the plane to the sculpt mode, which includes building the BVH tree.
+    start = time.time()
+    bpy.ops.object.mode_set(mode='SCULPT')
+    mode_entry_time = time.time() - start
 
     context_override = context.copy()
     set_view3d_context_override(context_override)
@@ -126,23 +128,25 @@ def _run(args):
         bpy.ops.sculpt.brush_stroke(stroke=generate_stroke(context_override))
         end = time.time()
 
-    result = {'time': end - start}
+    result = {'time': end - start, 'mode_entry_time': mode_entry_time}
     # bpy.ops.wm.save_mainfile(filepath="/home/hans/Documents/test.blend")
     return result
 
 
 class SculptBrushTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, size, name_suffix=""):
         self.filepath = filepath
+        self.size = size
+        self.name_suffix = name_suffix
 
     def name(self):
-        return self.filepath.stem
+        return self.filepath.stem + self.name_suffix
 
     def category(self):
         return "sculpt"
 
     def run(self, env, device_id):
-        args = {}
+        args = {'size': self.size}
 
         result, _ = env.run_in_blender(_run, args, [self.filepath])
 
@@ -151,4 +155,9 @@ class SculptBrushTest(api.Test):
 
 def generate(env):
     filepaths = env.find_blend_files('sculpt/*')
-    return [SculptBrushTest(filepath) for filepath in filepaths]
+    tests = []
+    for filepath in filepaths:
+        tests.append(SculptBrushTest(filepath, 1500))
+        # High-poly variant, dominated by the per-vertex cost of the brush kernels.
+        tests.append(SculptBrushTest(filepath, 4000, "_high_poly"))
+    return tests
@@ -0,0 +1,212 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Replay recorded brush strokes headless and report per-dab latency.
+
+Strokes are stored as JSON files in the `sculpt_strokes` benchmark directory. To record
+one, sculpt a stroke interactively on the scene created by `prepare_sculpt_scene` and run
+the following from the Python console:
+
+    import sys; sys.path.append("<blender>/tests/performance")
+    from tests import sculpt_stroke_replay
+    sculpt_stroke_replay.record_last_stroke("/path/to/stroke.json")
+
+The samples are taken from the last finished `sculpt.brush_stroke` operator, which stores
+every processed dab in its `stroke` property. The settings of the active brush are recorded
+too and restored before replaying, so replays don't depend on the brush active in the file.
+When no recorded strokes are found, the generated diagonal stroke from `sculpt.py` is used
+with the brush of the file instead.
+
+Per-dab timings are written by `paint_stroke_exec` to the `paint.stroke` log.
+"""
+
+import api
+import re
+
+from tests import sculpt
+
+STROKE_ELEMENT_KEYS = (
+    "location",
+    "mouse",
+    "mouse_event",
+    "pen_flip",
+    "is_start",
+    "pressure",
+    "time",
+    "size",
+    "x_tilt",
+    "y_tilt",
+)
+
+# Brush settings restored before replay, the tool type first since it resets other settings.
+BRUSH_KEYS = (
+    "sculpt_tool",
+    "curve_preset",
+    "use_locked_size",
+    "size",
+    "unprojected_radius",
+    "strength",
+)
+
+DAB_LOG_RE = re.compile(r"Dab (\d+): ([0-9.]+) ms")
+
+
+def record_last_stroke(filepath):
+    """
+    Write the samples of the last finished sculpt stroke and the active brush settings to a JSON
+    file.
+    """
+    import bpy
+    import json
+
+    tool_settings = bpy.context.tool_settings
+    brush = tool_settings.sculpt.brush
+    brush_settings = {key: getattr(brush, key) for key in BRUSH_KEYS}
+    # Store the effective size and strength, which may come from the unified settings.
+    unified_settings = tool_settings.unified_paint_settings
+    if unified_settings.use_unified_size:
+        brush_settings["size"] = unified_settings.size
+        brush_settings["unprojected_radius"] = unified_settings.unprojected_radius
+    if unified_settings.use_unified_strength:
+        brush_settings["strength"] = unified_settings.strength
+
+    properties = bpy.context.window_manager.operator_properties_last("sculpt.brush_stroke")
+    stroke = []
+    for element in properties.stroke:
+        step = {"name": "stroke"}
+        for key in STROKE_ELEMENT_KEYS:
+            value = getattr(element, key)
+            step[key] = tuple(value) if hasattr(value, "__len__") else value
+        stroke.append(step)
+
+    if not stroke:
+        raise Exception("No finished sculpt stroke to record")
+
+    with open(filepath, "w") as f:
+        recording = {"mode": properties.mode, "brush": brush_settings, "stroke": stroke}
+        json.dump(recording, f, indent=1)
+
+
+def _restore_brush(context, brush_settings):
+    tool_settings = context.tool_settings
+    unified_settings = tool_settings.unified_paint_settings
+    unified_settings.use_unified_size = False
+    unified_settings.use_unified_strength = False
+
+    brush = tool_settings.sculpt.brush
+    for key in BRUSH_KEYS:
+        if key in brush_settings:
+            setattr(brush, key, brush_settings[key])
+
+
+def _prepare_pbvh(context, pbvh_type):
+    import bpy
+
+    ob = context.object
+    if pbvh_type == 'MULTIRES':
+        ob.modifiers.new("Multires", 'MULTIRES')
+        for _ in range(2):
+            bpy.ops.object.multires_subdivide(modifier="Multires", mode='CATMULL_CLARK')
+
+    bpy.ops.object.mode_set(mode='SCULPT')
+
+    if pbvh_type == 'DYNTOPO':
+        bpy.ops.sculpt.dynamic_topology_toggle()
+
+
+def _run(args):
+    import bpy
+    import json
+    import time
+    context = bpy.context
+
+    # Create an undo stack explicitly. This isn't created by default in background mode.
+    bpy.ops.ed.undo_push()
+
+    sculpt.prepare_sculpt_scene(context, args['size'])
+    _prepare_pbvh(context, args['pbvh_type'])
+
+    if args['stroke_filepath']:
+        with open(args['stroke_filepath']) as f:
+            recording = json.load(f)
+    else:
+        recording = {"mode": 'NORMAL', "stroke": None}
+
+    if recording.get("brush"):
+        _restore_brush(context, recording["brush"])
+
+    context_override = context.copy()
+    sculpt.set_view3d_context_override(context_override)
+
+    with context.temp_override(**context_override):
+        stroke = recording["stroke"] or sculpt.generate_stroke(context_override)
+        start = time.time()
+        bpy.ops.sculpt.brush_stroke(stroke=stroke, mode=recording["mode"])
+        end = time.time()
+
+    return {'time': end - start}
+
+
+def _percentile(sorted_values, percentile):
+    # Nearest-rank percentile, exact for the small sample counts of a single stroke.
+    index = max(0, -(-len(sorted_values) * percentile // 100) - 1)
+    return sorted_values[int(index)]
+
+
+class SculptStrokeReplayTest(api.Test):
+    def __init__(self, filepath, stroke_filepath, pbvh_type, size):
+        self.filepath = filepath
+        self.stroke_filepath = stroke_filepath
+        self.pbvh_type = pbvh_type
+        self.size = size
+
+    def name(self):
+        stroke_name = self.stroke_filepath.stem if self.stroke_filepath else "generated"
+        return f"{self.filepath.stem}_{stroke_name}_{self.pbvh_type.lower()}"
+
+    def category(self):
+        return "sculpt_stroke_replay"
+
+    def run(self, env, device_id):
+        args = {
+            'size': self.size,
+            'pbvh_type': self.pbvh_type,
+            'stroke_filepath': str(self.stroke_filepath) if self.stroke_filepath else None,
+        }
+
+        blender_args = ['--log', 'paint.stroke', '--log-level', '1', self.filepath]
+        result, log = env.run_in_blender(_run, args, blender_args)
+
+        dab_times = []
+        for line in log:
+            match = DAB_LOG_RE.search(line)
+            if match:
+                dab_times.append(float(match.group(2)) / 1000.0)
+        if not dab_times:
+            raise Exception("No per-dab timings found in log.")
+
+        dab_times.sort()
+        result['dab_p50'] = _percentile(dab_times, 50)
+        result['dab_p90'] = _percentile(dab_times, 90)
+        result['dab_p99'] = _percentile(dab_times, 99)
+        result['dab_max'] = dab_times[-1]
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('sculpt/*')
+    stroke_filepaths = sorted((env.benchmarks_dir / 'sculpt_strokes').glob('*.json'))
+    if not stroke_filepaths:
+        stroke_filepaths = [None]
+
+    # Dynamic topology is much slower per vertex, keep its base mesh smaller.
+    pbvh_types = (('MESH', 1500), ('MULTIRES', 400), ('DYNTOPO', 300))
+
+    tests = []
+    for filepath in filepaths:
+        for stroke_filepath in stroke_filepaths:
+            for pbvh_type, size in pbvh_types:
+                tests.append(SculptStrokeReplayTest(filepath, stroke_filepath, pbvh_type, size))
+    return tests
@@ -0,0 +1,130 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time the per-frame cost of sequencer blend effects at 4K and 8K, as seen in the preview.
+
+Two color strips are blended by the effect, with the sequencer cache disabled so every frame is
+computed again. Frames are stepped through one by one and only the redraw of the sequencer
+preview is timed, which renders the strips through the same path as playback.
+"""
+
+import api
+
+IMAGE_SIZES = {
+    '4k': (3840, 2160),
+    '8k': (7680, 4320),
+}
+FRAMES_NUM = 20
+LOG_KEY = "SEQUENCER_EFFECTS_PERFORMANCE: "
+
+
+def _prepare_sequencer(effect_type, image_size):
+    import bpy
+
+    scene = bpy.context.scene
+    scene.render.resolution_x, scene.render.resolution_y = image_size
+    scene.render.resolution_percentage = 100
+    scene.frame_start = 1
+    scene.frame_end = 100
+
+    ed = scene.sequence_editor_create()
+    ed.use_cache_raw = False
+    ed.use_cache_preprocessed = False
+    ed.use_cache_composite = False
+    ed.use_cache_final = False
+    ed.use_prefetch = False
+
+    strip1 = ed.sequences.new_effect("Color1", 'COLOR', 1, frame_start=1, frame_end=101)
+    strip1.color = (0.8, 0.3, 0.1)
+    strip2 = ed.sequences.new_effect("Color2", 'COLOR', 2, frame_start=1, frame_end=101)
+    strip2.color = (0.1, 0.4, 0.9)
+    strip2.blend_alpha = 0.5
+
+    ed.sequences.new_effect(
+        "Effect", effect_type, 3, frame_start=1, frame_end=101, seq1=strip1, seq2=strip2)
+
+
+def _show_preview():
+    import bpy
+
+    # Turn the 3D viewport of the startup file into a full size sequencer preview.
+    screen = bpy.context.window_manager.windows[0].screen
+    area = max(screen.areas, key=lambda area: area.width * area.height)
+    area.type = 'SEQUENCE_EDITOR'
+    space = area.spaces.active
+    space.view_type = 'PREVIEW'
+    space.proxy_render_size = 'SCENE'
+
+    # Record once the event loop applied the new view type.
+    bpy.app.timers.register(_record, first_interval=1.0)
+
+
+def _record():
+    import bpy
+    import time
+
+    window = bpy.context.window_manager.windows[0]
+    area = next(area for area in window.screen.areas if area.type == 'SEQUENCE_EDITOR')
+    region = next(region for region in area.regions if region.type == 'PREVIEW')
+    scene = bpy.context.scene
+
+    measured_times = []
+    with bpy.context.temp_override(window=window, area=area, region=region):
+        # Blend factors of transitions depend on the frame.
+        for frame in range(10, 10 + FRAMES_NUM):
+            scene.frame_set(frame)
+
+            start = time.perf_counter()
+            bpy.ops.wm.redraw_timer(type='DRAW', iterations=1)
+            measured_times.append(time.perf_counter() - start)
+
+    avg_frame_time = sum(measured_times) / len(measured_times)
+    print(f"{LOG_KEY}{{'time': {avg_frame_time}, 'min_time': {min(measured_times)} }}")
+    bpy.ops.wm.quit_blender()
+
+
+def _run(args):
+    import bpy
+
+    _prepare_sequencer(args['effect_type'], args['image_size'])
+    bpy.app.timers.register(_show_preview, first_interval=1.0)
+
+
+class SequencerEffectTest(api.Test):
+    def __init__(self, effect_type, size_name):
+        self.effect_type = effect_type
+        self.size_name = size_name
+
+    def name(self):
+        return f"{self.effect_type.lower()}_{self.size_name}"
+
+    def category(self):
+        return "sequencer_effects"
+
+    def use_background(self):
+        return False
+
+    def run(self, env, device_id):
+        args = {
+            'effect_type': self.effect_type,
+            'image_size': IMAGE_SIZES[self.size_name],
+        }
+
+        _, log = env.run_in_blender(_run, args, foreground=True)
+        for line in log:
+            if line.startswith(LOG_KEY):
+                result_str = line[len(LOG_KEY):]
+                result = eval(result_str)
+                return result
+
+        raise Exception("No sequencer preview performance result found in log.")
+
+
+def generate(env):
+    effect_types = ('CROSS', 'GAMMA_CROSS', 'ADD', 'SUBTRACT', 'MULTIPLY', 'ALPHA_OVER',
+                    'ALPHA_UNDER', 'OVER_DROP')
+    return [SequencerEffectTest(effect_type, size_name)
+            for effect_type in effect_types
+            for size_name in IMAGE_SIZES]
@@ -0,0 +1,108 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Time random frame access in a long GOP H.264 movie strip without proxies, as when scrubbing.
+
+The movie is encoded first by rendering an animated sequencer scene, then frames are fetched in a
+fixed pseudo-random order and a back and forth scrubbing pattern, with the sequencer cache off.
+"""
+
+import api
+
+IMAGE_SIZE = (1920, 1080)
+FRAMES_NUM = 240
+GOP_SIZE = 120
+
+
+def _encode_movie(filepath):
+    import bpy
+
+    scene = bpy.context.scene
+    scene.render.resolution_x, scene.render.resolution_y = IMAGE_SIZE
+    scene.render.resolution_percentage = 100
+    scene.render.use_sequencer = True
+    scene.render.use_compositing = False
+    scene.frame_start = 1
+    scene.frame_end = FRAMES_NUM
+
+    ed = scene.sequence_editor_create()
+    for strip in list(ed.sequences):
+        ed.sequences.remove(strip)
+
+    # Moving content, so that frames differ and don't compress to nothing.
+    image = bpy.data.images.new("Gradient", *IMAGE_SIZE)
+    image.generated_type = 'COLOR_GRID'
+    image.filepath_raw = filepath + ".png"
+    image.file_format = 'PNG'
+    image.save()
+    strip = ed.sequences.new_image("Gradient", image.filepath_raw, 1, 1)
+    strip.frame_final_duration = FRAMES_NUM
+    strip.transform.offset_x = 0
+    strip.transform.keyframe_insert("offset_x", frame=1)
+    strip.transform.offset_x = IMAGE_SIZE[0]
+    strip.transform.keyframe_insert("offset_x", frame=FRAMES_NUM)
+
+    scene.render.image_settings.file_format = 'FFMPEG'
+    scene.render.ffmpeg.format = 'MPEG4'
+    scene.render.ffmpeg.codec = 'H264'
+    scene.render.ffmpeg.gopsize = GOP_SIZE
+    scene.render.ffmpeg.use_max_b_frames = True
+    scene.render.ffmpeg.max_b_frames = 2
+    scene.render.filepath = filepath
+    bpy.ops.render.render(animation=True)
+
+    ed.sequences.remove(strip)
+    return scene.render.frame_path(frame=scene.frame_start)
+
+
+def _run(args):
+    import bpy
+    import os
+    import random
+    import tempfile
+    import time
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        movie_filepath = _encode_movie(os.path.join(temp_dir, "movie_"))
+
+        scene = bpy.context.scene
+        scene.render.image_settings.file_format = 'PNG'
+        scene.render.filepath = os.path.join(temp_dir, "frame_")
+
+        ed = scene.sequence_editor
+        ed.use_cache_raw = False
+        ed.use_cache_preprocessed = False
+        ed.use_cache_composite = False
+        ed.use_cache_final = False
+        ed.sequences.new_movie("Movie", movie_filepath, 1, 1)
+
+        if args['pattern'] == 'RANDOM':
+            rng = random.Random(0)
+            frames = [rng.randint(1, FRAMES_NUM) for _ in range(args['frames_num'])]
+        else:
+            # Scrub back and forth over half a GOP.
+            frames = []
+            center = FRAMES_NUM // 2
+            while len(frames) < args['frames_num']:
+                frames += list(range(center, center + GOP_SIZE // 2))
+                frames += list(range(center + GOP_SIZE // 2, center, -1))
+            frames = frames[:args['frames_num']]
+
+        start = time.time()
+        for frame in frames:
+            scene.frame_set(frame)
+            bpy.ops.render.render()
+        elapsed = time.time() - start
+
+    # Average latency of a frame access.
+    return {'time': elapsed / len(frames)}
+
+
+def generate(env):
+    return [api.GeneratedSceneTest(f"{pattern.lower()}_access",
+                                   "sequencer_movie_seek",
+                                   _run,
+                                   {'pattern': pattern, 'frames_num': 60})
+            for pattern in ('RANDOM', 'SCRUB')]